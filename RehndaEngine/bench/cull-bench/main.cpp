@@ -0,0 +1,112 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "rendering/Frustum.hpp"
+#include "scene/Bvh.hpp"
+
+using namespace Rehnda;
+
+// Frustum culling microbenchmark, reports the cost per object of building, refitting and culling the scene BVH next to a
+// brute force scalar loop over every box.
+// usage: rehnda-cull-bench [object count] [iterations]
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    template<typename Fn>
+    double timeMilliseconds(Fn &&fn) {
+        const auto start = Clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void report(const std::string &name, double milliseconds, size_t objectCount) {
+        std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << milliseconds << " ms"
+                  << std::setw(10) << milliseconds * 1e6 / static_cast<double>(objectCount) << " ns/object" << std::endl;
+    }
+}
+
+int main(int argc, char **argv) {
+    const size_t objectCount = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    const int iterations = argc > 2 ? std::stoi(argv[2]) : 20;
+    constexpr float WORLD_HALF_SIZE = 1000.f;
+
+    std::mt19937 random{1234};
+    std::uniform_real_distribution<float> position{-WORLD_HALF_SIZE, WORLD_HALF_SIZE};
+    std::uniform_real_distribution<float> size{0.5f, 4.f};
+    std::vector<Aabb> bounds(objectCount);
+    for (auto &box: bounds) {
+        const glm::vec3 center{position(random), position(random), position(random)};
+        const glm::vec3 halfExtent = glm::vec3(size(random), size(random), size(random)) * 0.5f;
+        box = {.min = center - halfExtent, .max = center + halfExtent};
+    }
+
+    // a camera in the middle of the world looking along +x, sees roughly a tenth of it
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.f), glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, 0.f, 1.f));
+    const glm::mat4 proj = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, WORLD_HALF_SIZE);
+    const Frustum frustum = Frustum::fromMatrix(proj * view);
+
+    std::cout << objectCount << " objects, " << iterations << " iterations" << std::endl;
+
+    Bvh bvh;
+    report("bvh build", timeMilliseconds([&] { bvh.build(bounds); }), objectCount);
+
+    std::vector<uint32_t> visible;
+    visible.reserve(objectCount);
+    double cullTotal = 0;
+    for (int i = 0; i < iterations; i++) {
+        visible.clear();
+        cullTotal += timeMilliseconds([&] { bvh.cull(frustum, visible); });
+    }
+    report("bvh cull", cullTotal / iterations, objectCount);
+    const size_t bvhVisibleCount = visible.size();
+
+    size_t bruteForceVisibleCount = 0;
+    double bruteForceTotal = 0;
+    for (int i = 0; i < iterations; i++) {
+        bruteForceVisibleCount = 0;
+        bruteForceTotal += timeMilliseconds([&] {
+            for (const auto &box: bounds) {
+                bruteForceVisibleCount += frustum.intersectsAabb(box.min, box.max) ? 1 : 0;
+            }
+        });
+    }
+    report("brute force", bruteForceTotal / iterations, objectCount);
+
+    // nudge a tenth of the objects each iteration, like a frame of animation
+    std::uniform_int_distribution<size_t> pickObject{0, objectCount - 1};
+    std::uniform_real_distribution<float> nudge{-1.f, 1.f};
+    const size_t movingCount = objectCount / 10;
+    double refitTotal = 0;
+    for (int i = 0; i < iterations; i++) {
+        refitTotal += timeMilliseconds([&] {
+            for (size_t moved = 0; moved < movingCount; moved++) {
+                const size_t object = pickObject(random);
+                const glm::vec3 offset{nudge(random), nudge(random), nudge(random)};
+                bounds[object] = {.min = bounds[object].min + offset, .max = bounds[object].max + offset};
+                bvh.updateObject(static_cast<uint32_t>(object), bounds[object]);
+            }
+            bvh.refit();
+        });
+    }
+    report("bvh refit 10%", refitTotal / iterations, objectCount);
+
+    std::cout << "visible: " << bvhVisibleCount << " (bvh), " << bruteForceVisibleCount << " (brute force), "
+              << bvh.getNodeCount() << " nodes" << std::endl;
+    // the bvh only tests boxes around groups of objects, so it must agree exactly with testing every object
+    return bvhVisibleCount == bruteForceVisibleCount ? EXIT_SUCCESS : EXIT_FAILURE;
+}
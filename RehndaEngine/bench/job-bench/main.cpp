@@ -0,0 +1,180 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "core/JobSystem.hpp"
+
+using namespace Rehnda;
+
+// Job system microbenchmark, reports the cost per job of spawning, stealing and splitting work, and checks every job ran.
+// usage: rehnda-job-bench [job count] [worker count, 0 for one per core]
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    template<typename Fn>
+    double timeMilliseconds(Fn &&fn) {
+        const auto start = Clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void report(const std::string &name, double milliseconds, size_t jobCount, const JobSystemStats &before,
+                const JobSystemStats &after) {
+        const auto executed = static_cast<double>(after.executed - before.executed);
+        const auto stolen = static_cast<double>(after.stolen - before.stolen);
+        std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << milliseconds << " ms"
+                  << std::setw(10) << milliseconds * 1e6 / static_cast<double>(jobCount) << " ns/job"
+                  << std::setw(8) << std::setprecision(1) << (executed > 0 ? 100.0 * stolen / executed : 0.0) << "% stolen"
+                  << std::endl;
+    }
+
+    // enough work that a job isn't free, small enough that spawning still dominates
+    void spin(std::atomic<uint64_t> &sink, size_t seed) {
+        uint64_t value = seed;
+        for (int i = 0; i < 64; i++) {
+            value = value * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        sink.fetch_add(value & 1, std::memory_order_relaxed);
+    }
+}
+
+int main(int argc, char **argv) {
+    const size_t jobCount = argc > 1 ? std::stoull(argv[1]) : 200'000;
+    const uint32_t workerCount = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 0;
+
+    JobSystem jobSystem{{.workerCount = workerCount, .queueCapacity = 1 << 16}};
+    std::cout << jobCount << " jobs, " << jobSystem.getWorkerCount() << " workers" << std::endl;
+
+    std::atomic<uint64_t> ran{0};
+    std::atomic<uint64_t> sink{0};
+    bool allRan = true;
+
+    // empty jobs spawned from the main thread, which are only run elsewhere if a worker steals them
+    {
+        ran = 0;
+        const JobSystemStats before = jobSystem.getStats();
+        const double milliseconds = timeMilliseconds([&] {
+            JobCounter counter;
+            for (size_t i = 0; i < jobCount; i++) {
+                jobSystem.run([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }
+            jobSystem.wait(counter);
+        });
+        report("spawn empty", milliseconds, jobCount, before, jobSystem.getStats());
+        allRan = allRan && ran == jobCount;
+    }
+
+    // the same with a little work in each, so workers have time to steal
+    {
+        ran = 0;
+        const JobSystemStats before = jobSystem.getStats();
+        const double milliseconds = timeMilliseconds([&] {
+            JobCounter counter;
+            for (size_t i = 0; i < jobCount; i++) {
+                jobSystem.run([&ran, &sink, i] {
+                    spin(sink, i);
+                    ran.fetch_add(1, std::memory_order_relaxed);
+                }, &counter);
+            }
+            jobSystem.wait(counter);
+        });
+        report("spawn + steal", milliseconds, jobCount, before, jobSystem.getStats());
+        allRan = allRan && ran == jobCount;
+    }
+
+    // a tree of jobs spawning jobs from worker threads, every level's children are stolen off whoever spawned them
+    {
+        ran = 0;
+        constexpr size_t FAN_OUT = 16;
+        const size_t leavesPerBranch = std::max<size_t>(jobCount / FAN_OUT, 1);
+        const JobSystemStats before = jobSystem.getStats();
+        const double milliseconds = timeMilliseconds([&] {
+            JobCounter counter;
+            for (size_t branch = 0; branch < FAN_OUT; branch++) {
+                jobSystem.run([&, branch] {
+                    JobCounter leaves;
+                    for (size_t leaf = 0; leaf < leavesPerBranch; leaf++) {
+                        jobSystem.run([&ran, &sink, branch, leaf] {
+                            spin(sink, branch * 31 + leaf);
+                            ran.fetch_add(1, std::memory_order_relaxed);
+                        }, &leaves);
+                    }
+                    jobSystem.wait(leaves);
+                }, &counter);
+            }
+            jobSystem.wait(counter);
+        });
+        report("nested spawn", milliseconds, FAN_OUT * leavesPerBranch, before, jobSystem.getStats());
+        allRan = allRan && ran == FAN_OUT * leavesPerBranch;
+    }
+
+    // dependencies, each job of a chain only queued once the previous one has finished
+    {
+        ran = 0;
+        constexpr size_t CHAIN_COUNT = 64;
+        const size_t chainLength = std::max<size_t>(jobCount / CHAIN_COUNT / 16, 1);
+        const JobSystemStats before = jobSystem.getStats();
+        const double milliseconds = timeMilliseconds([&] {
+            std::vector<JobCounter> links(CHAIN_COUNT * chainLength);
+            for (size_t chain = 0; chain < CHAIN_COUNT; chain++) {
+                JobCounter *previous = nullptr;
+                for (size_t link = 0; link < chainLength; link++) {
+                    JobCounter &current = links[chain * chainLength + link];
+                    const auto job = [&ran] { ran.fetch_add(1, std::memory_order_relaxed); };
+                    if (previous) {
+                        jobSystem.runAfter(*previous, job, &current);
+                    } else {
+                        jobSystem.run(job, &current);
+                    }
+                    previous = &current;
+                }
+            }
+            for (auto &link: links) {
+                jobSystem.wait(link);
+            }
+        });
+        report("dependency chains", milliseconds, CHAIN_COUNT * chainLength, before, jobSystem.getStats());
+        allRan = allRan && ran == CHAIN_COUNT * chainLength;
+    }
+
+    // splitting a flat loop, the way culling and transform updates fan out
+    for (const size_t batchSize: {64, 1024}) {
+        ran = 0;
+        const JobSystemStats before = jobSystem.getStats();
+        const double milliseconds = timeMilliseconds([&] {
+            jobSystem.parallelFor(jobCount, batchSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    spin(sink, i);
+                }
+                ran.fetch_add(end - begin, std::memory_order_relaxed);
+            });
+        });
+        report("parallel for /" + std::to_string(batchSize), milliseconds, jobCount, before, jobSystem.getStats());
+        allRan = allRan && ran == jobCount;
+    }
+
+    // jobs pinned to the main thread only run when it asks for them
+    {
+        ran = 0;
+        const JobSystemStats before = jobSystem.getStats();
+        const double milliseconds = timeMilliseconds([&] {
+            for (size_t i = 0; i < jobCount; i++) {
+                jobSystem.run([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }, nullptr, JobAffinity::MAIN_THREAD);
+            }
+            jobSystem.runMainThreadJobs();
+        });
+        report("main thread only", milliseconds, jobCount, before, jobSystem.getStats());
+        allRan = allRan && ran == jobCount;
+    }
+
+    std::cout << (allRan ? "all jobs ran" : "JOBS WENT MISSING") << " (" << sink.load() << ")" << std::endl;
+    return allRan ? EXIT_SUCCESS : EXIT_FAILURE;
+}
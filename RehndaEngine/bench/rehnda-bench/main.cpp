@@ -0,0 +1,354 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "core/JobSystem.hpp"
+#include "rendering/RenderCommandStream.hpp"
+#include "rendering/vulkan/VulkanRenderer.hpp"
+
+using namespace Rehnda;
+
+// Whole engine benchmark, draws each scene headless for a fixed number of frames and writes frame time percentiles, draw
+// calls and memory use as JSON. Scenes are meshes x textures x materials, the default set runs when none are given.
+// Run from the build directory so the shaders and assets are found, no window or display is needed so it runs under lavapipe.
+// Every object draws the same imported mesh, --quad draws the app's built in quads instead.
+// usage: rehnda-bench [--scene NxMxK]... [--frames n] [--warmup n] [--lights n] [--width px] [--height px]
+//                     [--mesh file.obj | --quad] [--depth-pre-pass] [--no-validation] [--output file.json]
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchOptions {
+        std::vector<SceneProps> scenes;
+        uint32_t frames = 500;
+        // lets pipeline creation, uploads and the GPU timer settle before anything is measured
+        uint32_t warmupFrames = 60;
+        uint32_t lightCount = 256;
+        vk::Extent2D extent{1280, 720};
+        // imported through the mesh cache, so only the first run pays for parsing it. Empty for the built in quads
+        std::filesystem::path meshPath = "resources/meshes/sphere.obj";
+        bool depthPrePass = false;
+        // on in debug builds, where they'd dominate the frame times. --no-validation to measure a debug build anyway
+        bool validationLayers = VulkanRenderer::VALIDATION_LAYERS_BY_DEFAULT;
+        std::optional<std::string> outputPath;
+    };
+
+    struct Summary {
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    struct SceneResult {
+        SceneProps scene;
+        Summary cpuMilliseconds;
+        std::optional<Summary> gpuMilliseconds;
+        double drawCalls = 0.0;
+        double visibleObjects = 0.0;
+        std::optional<vk::DeviceSize> deviceMemoryBytes;
+        uint64_t peakResidentBytes = 0;
+    };
+
+    // nearest rank, so every reported value is a frame that actually happened
+    Summary summarize(std::vector<double> samples) {
+        if (samples.empty()) {
+            return {};
+        }
+        std::sort(samples.begin(), samples.end());
+        const auto percentile = [&](double p) {
+            const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size())));
+            return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+        };
+        return {
+                .mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size()),
+                .p50 = percentile(0.50),
+                .p95 = percentile(0.95),
+                .p99 = percentile(0.99),
+                .max = samples.back(),
+        };
+    }
+
+    double mean(const std::vector<double> &samples) {
+        return samples.empty() ? 0.0 : std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    }
+
+    // high water mark for the whole process, so later scenes include whatever earlier ones peaked at
+    uint64_t getPeakResidentBytes() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return 0;
+        }
+        return counters.PeakWorkingSetSize;
+#else
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        // kilobytes on Linux
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+    }
+
+    SceneProps parseScene(const std::string &text) {
+        SceneProps scene;
+        if (std::sscanf(text.c_str(), "%ux%ux%u", &scene.meshCount, &scene.textureCount, &scene.materialCount) != 3) {
+            throw std::runtime_error(fmt::format("Scenes are meshes x textures x materials, e.g. 1000x16x64, not {}", text));
+        }
+        return scene;
+    }
+
+    BenchOptions parseOptions(int argc, char **argv) {
+        BenchOptions options;
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            const auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error(fmt::format("{} needs a value", arg));
+                }
+                return argv[++i];
+            };
+            if (arg == "--scene") {
+                options.scenes.push_back(parseScene(value()));
+            } else if (arg == "--frames") {
+                options.frames = static_cast<uint32_t>(std::stoul(value()));
+            } else if (arg == "--warmup") {
+                options.warmupFrames = static_cast<uint32_t>(std::stoul(value()));
+            } else if (arg == "--lights") {
+                options.lightCount = static_cast<uint32_t>(std::stoul(value()));
+            } else if (arg == "--width") {
+                options.extent.width = static_cast<uint32_t>(std::stoul(value()));
+            } else if (arg == "--height") {
+                options.extent.height = static_cast<uint32_t>(std::stoul(value()));
+            } else if (arg == "--mesh") {
+                options.meshPath = value();
+            } else if (arg == "--quad") {
+                options.meshPath.clear();
+            } else if (arg == "--depth-pre-pass") {
+                options.depthPrePass = true;
+            } else if (arg == "--no-validation") {
+                options.validationLayers = false;
+            } else if (arg == "--output") {
+                options.outputPath = value();
+            } else {
+                throw std::runtime_error(fmt::format("Unknown argument {}", arg));
+            }
+        }
+        if (options.scenes.empty()) {
+            // a single object, then a busy and a crowded scene within a frame's object limit
+            options.scenes = {
+                    {.meshCount = 1, .textureCount = 1, .materialCount = 1},
+                    {.meshCount = 1000, .textureCount = 16, .materialCount = 64},
+                    {.meshCount = 4000, .textureCount = 64, .materialCount = 256},
+            };
+        }
+        for (SceneProps &scene: options.scenes) {
+            scene.meshPath = options.meshPath;
+        }
+        if (options.frames == 0) {
+            throw std::runtime_error("Need at least one measured frame");
+        }
+        return options;
+    }
+
+    // the same lights every run, scattered just above the grid the meshes are laid out on
+    std::vector<PointLight> createLights(uint32_t lightCount) {
+        std::mt19937 random{1234};
+        std::uniform_real_distribution<float> horizontal{-2.f, 2.f};
+        std::uniform_real_distribution<float> height{0.1f, 1.f};
+        std::uniform_real_distribution<float> radius{0.35f, 0.8f};
+        std::uniform_real_distribution<float> channel{0.2f, 1.f};
+        std::vector<PointLight> lights(lightCount);
+        for (auto &light: lights) {
+            light = PointLight{
+                    .position = {horizontal(random), horizontal(random), height(random)},
+                    .radius = radius(random),
+                    .color = {channel(random), channel(random), channel(random)},
+                    .intensity = 0.5f,
+            };
+        }
+        return lights;
+    }
+
+    // orbits the scene once every few hundred frames, keyed off the frame rather than the clock so every run sees the same views
+    void writeFrame(RenderCommandStream &commands, uint32_t frame, const std::vector<PointLight> &lights) {
+        constexpr float ORBIT_FRAMES = 600.f;
+        const float angle = static_cast<float>(frame) / ORBIT_FRAMES * glm::two_pi<float>();
+        commands.clear();
+        commands.setCamera(RenderCamera{
+                .view = glm::lookAt(glm::vec3(5.f * std::cos(angle), 5.f * std::sin(angle), 3.5f), glm::vec3(0.f),
+                                    glm::vec3(0.f, 0.f, 1.f)),
+                .fovY = glm::radians(45.f),
+        });
+        commands.setLights(lights);
+    }
+
+    SceneResult runScene(const BenchOptions &options, const SceneProps &scene, JobSystem &jobSystem, std::string &deviceName,
+                         bool &validationLayers) {
+        VulkanRenderer renderer{options.extent, jobSystem, FrameCoordinatorProps{
+                .depthPrePass = options.depthPrePass,
+                // a fixed scale, otherwise the renderer trades resolution for exactly the frame time being measured
+                .dynamicResolution = {.enabled = false},
+                // every light is binned, however many are asked for
+                .clusteredLighting = {.maxLights = std::max(ClusteredLightingProps{}.maxLights, options.lightCount)},
+                .shaders = {.hotReload = false},
+                .scene = scene,
+        }, options.validationLayers};
+        deviceName = renderer.getDeviceName();
+        // what actually ran, asking for them isn't enough if they aren't installed
+        validationLayers = renderer.areValidationLayersEnabled();
+
+        const std::vector<PointLight> lights = createLights(options.lightCount);
+        RenderCommandStream commands{4096 + lights.size() * sizeof(PointLight)};
+
+        std::vector<double> cpuMilliseconds;
+        std::vector<double> gpuMilliseconds;
+        std::vector<double> drawCalls;
+        std::vector<double> visibleObjects;
+        for (uint32_t frame = 0; frame < options.warmupFrames + options.frames; frame++) {
+            writeFrame(commands, frame, lights);
+            const auto start = Clock::now();
+            renderer.drawFrame(commands);
+            const double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (frame < options.warmupFrames) {
+                continue;
+            }
+            const FrameStats &stats = renderer.getFrameStats();
+            cpuMilliseconds.push_back(milliseconds);
+            if (stats.gpuMilliseconds) {
+                gpuMilliseconds.push_back(*stats.gpuMilliseconds);
+            }
+            drawCalls.push_back(stats.drawCalls);
+            visibleObjects.push_back(stats.visibleObjects);
+        }
+        // measured while everything the scene allocated is still alive
+        const std::optional<vk::DeviceSize> deviceMemory = renderer.getDeviceMemoryUsage();
+        renderer.waitForDeviceIdle();
+
+        return {
+                .scene = scene,
+                .cpuMilliseconds = summarize(cpuMilliseconds),
+                .gpuMilliseconds = gpuMilliseconds.empty() ? std::nullopt : std::optional(summarize(gpuMilliseconds)),
+                .drawCalls = mean(drawCalls),
+                .visibleObjects = mean(visibleObjects),
+                .deviceMemoryBytes = deviceMemory,
+                .peakResidentBytes = getPeakResidentBytes(),
+        };
+    }
+
+    std::string escapeJson(const std::string &text) {
+        std::string escaped;
+        for (const char c: text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    std::string toJson(const Summary &summary) {
+        return fmt::format(R"({{"mean": {:.4f}, "p50": {:.4f}, "p95": {:.4f}, "p99": {:.4f}, "max": {:.4f}}})",
+                           summary.mean, summary.p50, summary.p95, summary.p99, summary.max);
+    }
+
+    std::string toJson(const BenchOptions &options, const std::string &deviceName, bool validationLayers,
+                       const std::vector<SceneResult> &results) {
+        std::string json = "{\n";
+        json += fmt::format("  \"device\": \"{}\",\n", escapeJson(deviceName));
+        json += fmt::format("  \"validation\": {},\n", validationLayers);
+        json += fmt::format("  \"width\": {},\n  \"height\": {},\n", options.extent.width, options.extent.height);
+        json += fmt::format("  \"frames\": {},\n  \"warmupFrames\": {},\n", options.frames, options.warmupFrames);
+        json += fmt::format("  \"lights\": {},\n  \"depthPrePass\": {},\n", options.lightCount, options.depthPrePass);
+        json += fmt::format("  \"mesh\": \"{}\",\n", escapeJson(options.meshPath.empty() ? "quad" : options.meshPath.generic_string()));
+        json += "  \"scenes\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const SceneResult &result = results[i];
+            json += i == 0 ? "\n" : ",\n";
+            json += "    {\n";
+            json += fmt::format("      \"meshes\": {},\n      \"textures\": {},\n      \"materials\": {},\n",
+                                result.scene.meshCount, result.scene.textureCount, result.scene.materialCount);
+            json += fmt::format("      \"cpuFrameMs\": {},\n", toJson(result.cpuMilliseconds));
+            json += fmt::format("      \"gpuFrameMs\": {},\n", result.gpuMilliseconds ? toJson(*result.gpuMilliseconds) : "null");
+            json += fmt::format("      \"drawCalls\": {:.1f},\n      \"visibleObjects\": {:.1f},\n",
+                                result.drawCalls, result.visibleObjects);
+            json += fmt::format("      \"deviceMemoryBytes\": {},\n",
+                                result.deviceMemoryBytes ? std::to_string(*result.deviceMemoryBytes) : "null");
+            json += fmt::format("      \"peakResidentBytes\": {}\n", result.peakResidentBytes);
+            json += "    }";
+        }
+        json += "\n  ]\n}\n";
+        return json;
+    }
+}
+
+int main(int argc, char **argv) {
+    // stdout is kept for the JSON
+    spdlog::set_default_logger(spdlog::stderr_color_mt("rehnda-bench"));
+    spdlog::set_level(spdlog::level::warn);
+
+    try {
+        const BenchOptions options = parseOptions(argc, argv);
+        JobSystem jobSystem;
+
+        std::string deviceName;
+        bool validationLayers = false;
+        std::vector<SceneResult> results;
+        // a fresh device per scene, so nothing one scene allocated is counted against the next
+        for (const SceneProps &scene: options.scenes) {
+            std::cerr << "scene " << scene.meshCount << "x" << scene.textureCount << "x" << scene.materialCount << std::endl;
+            results.push_back(runScene(options, scene, jobSystem, deviceName, validationLayers));
+        }
+
+        const std::string json = toJson(options, deviceName, validationLayers, results);
+        if (options.outputPath) {
+            std::ofstream file(*options.outputPath);
+            file << json;
+            if (!file) {
+                throw std::runtime_error(fmt::format("Failed to write {}", *options.outputPath));
+            }
+        } else {
+            std::cout << json;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <variant>
+#include <vector>
+
+#include "core/MappedFile.hpp"
+
+namespace Rehnda {
+    /**
+     * The bytes of a loaded asset. Depending on where it came from this is either a view into an archive mapping
+     * (which must outlive the blob), a decompressed copy, or a loose file mapped on its own.
+     */
+    class AssetBlob {
+    public:
+        explicit AssetBlob(std::span<const std::byte> borrowedBytes);
+
+        explicit AssetBlob(std::vector<std::byte> ownedBytes);
+
+        explicit AssetBlob(MappedFile mappedFile);
+
+        [[nodiscard]]
+        std::span<const std::byte> bytes() const;
+
+        [[nodiscard]]
+        const void *data() const;
+
+        [[nodiscard]]
+        size_t size() const;
+
+    private:
+        std::variant<std::span<const std::byte>, std::vector<std::byte>, MappedFile> storage;
+    };
+}
@@ -0,0 +1,29 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+#include "assets/AssetPack.hpp"
+#include "assets/AssetBlob.hpp"
+
+namespace Rehnda {
+    /**
+     * Resolves asset names (paths relative to the executable) against the asset pack if there is one,
+     * otherwise falls back to mapping the loose file, which keeps iterating on assets possible without re-packing.
+     */
+    class AssetLoader {
+    public:
+        explicit AssetLoader(const std::filesystem::path &packPath);
+
+        [[nodiscard]]
+        AssetBlob load(std::string_view name) const;
+
+    private:
+        std::optional<AssetPack> assetPack;
+    };
+}
@@ -0,0 +1,43 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+#include "core/MappedFile.hpp"
+#include "assets/AssetPackFormat.hpp"
+#include "assets/AssetBlob.hpp"
+
+namespace Rehnda {
+    /**
+     * Runtime side of a .rpak archive. The whole archive is opened with a single mapping, uncompressed entries are
+     * handed out as views into it and compressed entries are decompressed on load.
+     */
+    class AssetPack {
+    public:
+        explicit AssetPack(const std::filesystem::path &packPath);
+
+        [[nodiscard]]
+        bool contains(std::string_view name) const;
+
+        // throws if the asset isn't in the pack
+        [[nodiscard]]
+        AssetBlob load(std::string_view name) const;
+
+        [[nodiscard]]
+        size_t getEntryCount() const;
+
+    private:
+        MappedFile mappedPack;
+        std::span<const AssetPackFormat::TocEntry> toc;
+
+        [[nodiscard]]
+        const AssetPackFormat::TocEntry *findEntry(std::string_view name) const;
+
+        std::span<const AssetPackFormat::TocEntry> readToc() const;
+    };
+}
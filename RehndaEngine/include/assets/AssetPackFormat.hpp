@@ -0,0 +1,59 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * On disk layout of a .rpak archive:
+ *  - Header
+ *  - blobs, each starting on a BLOB_ALIGNMENT boundary so they can be used in place straight out of the mapping
+ *  - table of contents, one TocEntry per asset sorted by name hash so lookups are a binary search
+ */
+namespace Rehnda::AssetPackFormat {
+    constexpr uint32_t MAGIC = 0x4B415052; // "RPAK" read as little endian
+    constexpr uint32_t VERSION = 1;
+    // enough for SPIR-V (4), vertex/index data and SIMD friendly loads of mesh data
+    constexpr uint64_t BLOB_ALIGNMENT = 16;
+
+    enum class Compression : uint32_t {
+        NONE,
+        LZ4,
+        ZSTD,
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t tocOffset;
+    };
+
+    struct TocEntry {
+        uint64_t nameHash;
+        uint64_t offset;
+        // size of the blob as stored in the archive, which is smaller than originalSize when compressed
+        uint64_t storedSize;
+        uint64_t originalSize;
+        Compression compression;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(Header) == 24);
+    static_assert(sizeof(TocEntry) == 40);
+
+    // 64 bit FNV-1a, assets are looked up by the hash of their path relative to the executable e.g. "shaders/triangle.vert.spv"
+    constexpr uint64_t hashName(std::string_view name) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (const char c: name) {
+            // normalise windows separators so packs built on one platform resolve on another
+            hash ^= static_cast<uint8_t>(c == '\\' ? '/' : c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+}
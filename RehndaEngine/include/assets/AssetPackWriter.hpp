@@ -0,0 +1,43 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "assets/AssetPackFormat.hpp"
+
+namespace Rehnda {
+    struct AssetPackWriterProps {
+        AssetPackFormat::Compression compression = AssetPackFormat::Compression::NONE;
+        // entries that don't shrink below this fraction of their size are stored uncompressed so they can be used in place
+        double minCompressionRatio = 0.9;
+    };
+
+    class AssetPackWriter {
+    public:
+        explicit AssetPackWriter(AssetPackWriterProps props);
+
+        // adds every file under the directory, named by the directory's own name followed by the relative path e.g. "shaders/triangle.vert.spv"
+        void addDirectory(const std::filesystem::path &directory);
+
+        void addFile(const std::filesystem::path &file, std::string name);
+
+        void write(const std::filesystem::path &outputPath) const;
+
+    private:
+        struct PendingEntry {
+            std::string name;
+            std::filesystem::path source;
+        };
+
+        AssetPackWriterProps props;
+        std::vector<PendingEntry> pendingEntries;
+
+        [[nodiscard]]
+        AssetPackFormat::Compression chooseCompression(const std::filesystem::path &file) const;
+    };
+}
@@ -0,0 +1,86 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+#include "assets/AssetBlob.hpp"
+#include "rendering/MeshData.hpp"
+#include "rendering/PackedVertex.hpp"
+
+/**
+ * Binary mesh cache (.rmesh). The vertex block is an array of PackedVertex, the format the pipeline binds, so positions and
+ * uvs are already half floats: they're packed once at import rather than on every load. The index block is an array of
+ * uint16_t or uint32_t (whichever is the smallest that can address every vertex), followed by an array of Meshlet and an
+ * array of MeshLod when the mesh has them. Loading a cached mesh is a mapping and a copy into the staging buffer with no
+ * parsing or conversion.
+ */
+namespace Rehnda::MeshCacheFormat {
+    constexpr uint32_t MAGIC = 0x48534D52; // "RMSH" read as little endian
+    // 5: vertices stored as PackedVertex instead of Vertex
+    constexpr uint32_t VERSION = 5;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        // stored so a cache written with a different PackedVertex layout is rejected rather than misread
+        uint32_t vertexStride;
+        uint32_t indexStride;
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        // Meshlet table, empty if the mesh wasn't split into meshlets
+        uint64_t meshletCount;
+        uint64_t meshletOffset;
+        // MeshLod table, empty if no LODs were generated
+        uint64_t lodCount;
+        uint64_t lodOffset;
+        MeshBounds bounds;
+    };
+
+    static_assert(sizeof(Header) == 96);
+}
+
+namespace Rehnda {
+    class CachedMesh {
+    public:
+        // throws if the blob isn't a cache written for the current PackedVertex layout
+        explicit CachedMesh(AssetBlob blob);
+
+        // straight out of the mapping, ready to upload
+        [[nodiscard]]
+        std::span<const PackedVertex> getVertices() const;
+
+        // raw index block, interpret with getIndexType()
+        [[nodiscard]]
+        std::span<const std::byte> getIndexBytes() const;
+
+        [[nodiscard]]
+        uint32_t getIndexCount() const;
+
+        [[nodiscard]]
+        vk::IndexType getIndexType() const;
+
+        [[nodiscard]]
+        std::span<const Meshlet> getMeshlets() const;
+
+        [[nodiscard]]
+        std::span<const MeshLod> getLods() const;
+
+        [[nodiscard]]
+        MeshBounds getBounds() const;
+
+    private:
+        AssetBlob blob;
+        const MeshCacheFormat::Header *header;
+    };
+
+    namespace MeshCache {
+        void write(const std::filesystem::path &cachePath, const MeshData &meshData);
+    }
+}
@@ -0,0 +1,62 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
+#include "assets/MeshCache.hpp"
+#include "core/JobSystem.hpp"
+#include "rendering/MeshData.hpp"
+#include "rendering/MeshOptimizer.hpp"
+
+namespace Rehnda {
+    struct MeshImporterProps {
+        uint32_t workerCount = std::max(1u, std::thread::hardware_concurrency());
+        // parsing goes through the job system instead of threads of its own when there is one, workerCount is then just
+        // how many pieces the work is split into
+        JobSystem *jobSystem = nullptr;
+        // where .rmesh files are written, named after the source file and a hash of its path
+        std::filesystem::path cacheDirectory = "cache/meshes";
+        // imported meshes go through MeshOptimizer before being returned/cached
+        bool optimize = true;
+        MeshOptimizerProps optimizerProps{};
+        // split into meshlets after optimizing so the renderer can cull per cluster instead of per mesh
+        bool buildMeshlets = true;
+        bool generateLods = true;
+        MeshLodProps lodProps{};
+    };
+
+    /**
+     * Imports OBJ and glTF 2.0 (.gltf/.glb) meshes. Parsing is split over worker threads (chunks of the file for OBJ,
+     * primitives for glTF), then vertices are deduplicated to build the index buffer and the result is optimized for the
+     * vertex cache, overdraw and vertex fetch.
+     */
+    class MeshImporter {
+    public:
+        explicit MeshImporter(MeshImporterProps props = {});
+
+        [[nodiscard]]
+        MeshData import(const std::filesystem::path &sourcePath) const;
+
+        // loads the binary cache for the source mesh, importing and writing the cache first if it's missing, older than the
+        // source or in a format this build doesn't read
+        [[nodiscard]]
+        CachedMesh importCached(const std::filesystem::path &sourcePath) const;
+
+    private:
+        MeshImporterProps props;
+
+        [[nodiscard]]
+        MeshData importObj(const std::filesystem::path &sourcePath) const;
+
+        [[nodiscard]]
+        MeshData importGltf(const std::filesystem::path &sourcePath) const;
+
+        [[nodiscard]]
+        std::filesystem::path cachePathFor(const std::filesystem::path &sourcePath) const;
+    };
+}
@@ -0,0 +1,48 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+namespace Rehnda {
+    /**
+     * Watches the files directly in a directory from a thread of its own, calling back with each file that's been written
+     * since the last wake up. Uses inotify on Linux, elsewhere it polls modification times.
+     *
+     * Editors tend to save with a write then a rename, or several writes, so changes are batched over a short window and
+     * each file is only reported once per batch.
+     */
+    class FileWatcher {
+    public:
+        using Callback = std::function<void(const std::filesystem::path &path)>;
+
+        // onChanged is called on the watcher thread
+        FileWatcher(std::filesystem::path directory, Callback onChanged);
+
+        // stops and joins the watcher thread, once this returns the callback won't be called again
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher &) = delete;
+
+        FileWatcher &operator=(const FileWatcher &) = delete;
+
+    private:
+        static constexpr auto POLL_INTERVAL = std::chrono::milliseconds(250);
+
+        std::filesystem::path directory;
+        Callback onChanged;
+        std::atomic<bool> running = true;
+#ifdef __linux__
+        int inotifyFd = -1;
+#endif
+        // last, so everything it reads is set up before it starts
+        std::thread thread;
+
+        void run();
+    };
+}
@@ -0,0 +1,170 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "core/WorkStealingDeque.hpp"
+
+namespace Rehnda {
+    struct Job;
+
+    enum class JobAffinity {
+        ANY,
+        // only ever run by the thread that created the JobSystem, for things like GLFW calls that must stay there
+        MAIN_THREAD,
+    };
+
+    /**
+     * Counts the jobs attached to it that haven't finished yet. Waiting on a counter is how a job's results are collected,
+     * and jobs can be held back until a counter reaches zero with JobSystem::runAfter.
+     *
+     * Must be waited on with JobSystem::wait before it's destroyed if any jobs were attached. The first exception thrown
+     * by one of its jobs is kept and rethrown from the wait, the rest of its jobs still run.
+     */
+    class JobCounter {
+    public:
+        JobCounter() = default;
+
+        JobCounter(const JobCounter &) = delete;
+
+        JobCounter &operator=(const JobCounter &) = delete;
+
+        [[nodiscard]]
+        bool isDone() const;
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> pending{0};
+        // also held while finishing a job, so a waiter never sees zero while the counter is still being touched
+        std::mutex mutex;
+        std::vector<Job *> continuations;
+        // guarded by mutex, cleared once it's been rethrown
+        std::exception_ptr exception;
+    };
+
+    struct JobSystemProps {
+        // 0 picks one per core, less one for the main thread which runs jobs while it waits
+        uint32_t workerCount = 0;
+        // jobs a thread can have queued locally, past it new jobs go to the shared queue
+        uint32_t queueCapacity = 4096;
+    };
+
+    struct JobSystemStats {
+        uint64_t executed;
+        // of the executed jobs, how many were taken from another thread's queue
+        uint64_t stolen;
+    };
+
+    /**
+     * Task based job system. Every worker thread, and the main thread, owns a work stealing deque: jobs spawned on a thread
+     * go onto its own deque and are run newest first by it, while idle threads steal the oldest jobs from the others. Jobs
+     * spawned from threads the system doesn't own go through a shared queue.
+     *
+     * Waiting never blocks a thread that could be working, wait() runs other jobs until the counter reaches zero. Workers
+     * with nothing to do sleep until a job is queued.
+     */
+    class JobSystem {
+    public:
+        using JobFunction = std::function<void()>;
+        // [begin, end) of the range being split up
+        using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+        // the thread constructing the system becomes its main thread
+        explicit JobSystem(const JobSystemProps &props = {});
+
+        // jobs that haven't started are dropped, wait on anything that matters first
+        ~JobSystem();
+
+        JobSystem(const JobSystem &) = delete;
+
+        JobSystem &operator=(const JobSystem &) = delete;
+
+        void run(JobFunction function, JobCounter *counter = nullptr, JobAffinity affinity = JobAffinity::ANY);
+
+        // queued once dependency reaches zero, counter covers the job from now so waiting on it waits for both
+        void runAfter(JobCounter &dependency, JobFunction function, JobCounter *counter = nullptr,
+                      JobAffinity affinity = JobAffinity::ANY);
+
+        // splits [0, count) into batches of up to batchSize and returns once they've all run, the caller helps out
+        void parallelFor(size_t count, size_t batchSize, const RangeFunction &function);
+
+        // rethrows the first exception any of the counter's jobs threw, once they've all finished
+        void wait(JobCounter &counter);
+
+        // runs the MAIN_THREAD jobs queued so far, call from the main thread once a frame
+        void runMainThreadJobs();
+
+        // not counting the main thread
+        [[nodiscard]]
+        uint32_t getWorkerCount() const;
+
+        [[nodiscard]]
+        bool isMainThread() const;
+
+        [[nodiscard]]
+        JobSystemStats getStats() const;
+
+    private:
+        struct ThreadQueue {
+            explicit ThreadQueue(uint32_t capacity) : deque(capacity) {}
+
+            WorkStealingDeque<Job *> deque;
+            std::atomic<uint64_t> executed{0};
+            std::atomic<uint64_t> stolen{0};
+        };
+
+        std::thread::id mainThreadId;
+        // index 0 is the main thread's, then one per worker
+        std::vector<std::unique_ptr<ThreadQueue>> queues;
+        std::vector<std::thread> workers;
+
+        std::mutex sharedMutex;
+        std::deque<Job *> sharedJobs;
+        std::atomic<uint32_t> sharedJobCount{0};
+
+        std::mutex mainThreadMutex;
+        std::deque<Job *> mainThreadJobs;
+
+        // jobs any worker could pick up, what sleeping workers wait on
+        std::atomic<uint32_t> queuedJobs{0};
+        std::atomic<uint32_t> sleepingWorkers{0};
+        std::mutex sleepMutex;
+        std::condition_variable wakeCondition;
+        std::atomic<bool> stopping{false};
+
+        void workerLoop(uint32_t queueIndex);
+
+        void schedule(Job *job);
+
+        // own queue first, then the shared queue, then stealing
+        Job *findJob(uint32_t queueIndex);
+
+        bool runOneJob();
+
+        void execute(Job *job, uint32_t queueIndex);
+
+        void finish(Job *job);
+
+        // keeps the first, later ones are dropped
+        static void recordException(JobCounter &counter, std::exception_ptr exception);
+
+        void wakeWorker();
+
+        // index into queues of the calling thread, or NO_QUEUE for threads the system doesn't own
+        [[nodiscard]]
+        uint32_t currentQueueIndex() const;
+    };
+}
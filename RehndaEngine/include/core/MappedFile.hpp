@@ -0,0 +1,64 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace Rehnda {
+    // hints passed on to the OS (madvise) about how the mapped pages are going to be touched
+    enum class MappedFileAccess {
+        // read front to back once, e.g. a shader module or a blob being copied into a staging buffer
+        SEQUENTIAL,
+        // reads will jump around the file, e.g. resolving entries out of a table of contents
+        RANDOM,
+        // start faulting the pages in now rather than on first touch
+        WILL_NEED,
+    };
+
+    /**
+     * Read only view of a whole file mapped into the address space. The bytes come straight out of the page cache,
+     * so handing bytes() to something like a staging buffer memcpy avoids the intermediate heap copy
+     * that reading through an ifstream into a vector requires.
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::filesystem::path &path, MappedFileAccess access = MappedFileAccess::SEQUENTIAL);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept;
+
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        [[nodiscard]]
+        std::span<const std::byte> bytes() const;
+
+        [[nodiscard]]
+        const void *data() const;
+
+        [[nodiscard]]
+        size_t size() const;
+
+        // re-advise a sub range of the file, useful once a large file has been indexed and we know what we'll read next
+        void advise(size_t offset, size_t length, MappedFileAccess access) const;
+
+    private:
+        const std::byte *mapping = nullptr;
+        size_t mappingSize = 0;
+
+#ifdef _WIN32
+        void *fileHandle = nullptr;
+        void *mappingHandle = nullptr;
+#endif
+
+        void unmap();
+    };
+}
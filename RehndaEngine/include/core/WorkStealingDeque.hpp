@@ -0,0 +1,104 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace Rehnda {
+    /**
+     * Fixed capacity Chase-Lev deque. The owning thread pushes and pops at the bottom without taking a lock, any other
+     * thread can steal from the top, and only a steal racing the owner for the last item needs a compare and swap.
+     *
+     * T has to be trivially copyable (it's stored in atomics), in practice a pointer.
+     */
+    template<typename T>
+    class WorkStealingDeque {
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque items are stored in atomics");
+
+    public:
+        // rounded up to a power of two
+        explicit WorkStealingDeque(size_t capacity) :
+                capacity(std::bit_ceil(capacity)),
+                mask(static_cast<int64_t>(this->capacity) - 1),
+                items(std::make_unique<std::atomic<T>[]>(this->capacity)) {
+        }
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+
+        WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+        // owner only, false when full
+        bool push(T item) {
+            const int64_t b = bottom.load(std::memory_order_relaxed);
+            const int64_t t = top.load(std::memory_order_acquire);
+            if (b - t >= static_cast<int64_t>(capacity)) {
+                return false;
+            }
+            items[b & mask].store(item, std::memory_order_relaxed);
+            // the item has to be visible before a thief can see the new bottom
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // owner only, takes the most recently pushed item
+        std::optional<T> pop() {
+            const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            // the lowered bottom has to be visible to thieves before we look at top
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top.load(std::memory_order_relaxed);
+            if (t > b) {
+                // was already empty
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+            T item = items[b & mask].load(std::memory_order_relaxed);
+            if (t == b) {
+                // the last item, a thief may be after it as well
+                const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                if (!won) {
+                    return std::nullopt;
+                }
+            }
+            return item;
+        }
+
+        // any thread, takes the oldest item. Can fail spuriously when racing another thief or the owner
+        std::optional<T> steal() {
+            int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return std::nullopt;
+            }
+            T item = items[t & mask].load(std::memory_order_relaxed);
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return std::nullopt;
+            }
+            return item;
+        }
+
+        // a snapshot, only exact when called by the owner with no thieves around
+        [[nodiscard]]
+        bool empty() const {
+            return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+        }
+
+    private:
+        const size_t capacity;
+        const int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> items;
+        // on separate cache lines, thieves hammer top while the owner works the bottom
+        alignas(64) std::atomic<int64_t> top{0};
+        alignas(64) std::atomic<int64_t> bottom{0};
+    };
+}
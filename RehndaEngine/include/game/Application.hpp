@@ -4,15 +4,38 @@
 
 #pragma once
 
+#include <core/JobSystem.hpp>
+#include <game/GameWorld.hpp>
+#include <rendering/RenderFrameHandoff.hpp>
 #include <windowing/Window.hpp>
 
 namespace Rehnda {
+    struct ApplicationProps {
+        // the game updates frame N+1 on the main thread while a render thread draws frame N, so simulation time overlaps
+        // rendering instead of adding to it, at the cost of a frame of latency. Off runs both back to back on one thread
+        bool pipelinedRendering = true;
+        // room for one frame's render commands, they're never reallocated mid frame
+        size_t renderCommandCapacity = 64 * 1024;
+    };
+
     class Application {
     public:
-        Application();
+        explicit Application(ApplicationProps props = {});
         void run();
 
     private:
+        ApplicationProps props;
+        // created first so the thread running the application is its main thread
+        JobSystem jobSystem;
         Windowing::Window window;
+        GameWorld gameWorld;
+        RenderFrameHandoff frameHandoff;
+
+        void runSingleThreaded();
+
+        void runPipelined();
+
+        // events, main thread jobs and the game update, then hands the frame over
+        void updateGame(float time);
     };
-}
\ No newline at end of file
+}
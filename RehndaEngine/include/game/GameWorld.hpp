@@ -0,0 +1,35 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "rendering/PointLight.hpp"
+#include "rendering/RenderCommandStream.hpp"
+
+namespace Rehnda {
+    /**
+     * The simulation side of the demo scene: the spinning quad, the orbiting lights and the camera. It never touches the
+     * renderer directly, each update describes the frame to draw as render commands.
+     */
+    class GameWorld {
+    public:
+        GameWorld();
+
+        // advances to time (seconds since start) and writes the frame's camera, transforms and lights
+        void update(float time, RenderCommandStream &commands);
+
+    private:
+        // the quad is the first transform the renderer creates
+        static constexpr TransformHandle QUAD_TRANSFORM = 0;
+
+        std::vector<PointLight> lights;
+
+        // a few hundred small lights circling the scene, enough to make clustering worth it
+        static std::vector<PointLight> createLights();
+
+        void animateLights(float time);
+    };
+}
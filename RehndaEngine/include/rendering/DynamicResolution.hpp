@@ -0,0 +1,57 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include "rendering/vulkan/VkTypes.hpp"
+
+namespace Rehnda {
+    struct DynamicResolutionProps {
+        // with it off the scene always renders at maxScale
+        bool enabled = true;
+        // GPU time the scale is adjusted to hold, a little under a 60Hz frame leaves room for presentation
+        double targetFrameMilliseconds = 14.0;
+        // per axis scale of the output extent
+        float minScale = 0.5f;
+        float maxScale = 1.f;
+        // the scale only goes back up once frames are this fraction under target, stops it oscillating around the target
+        float headroom = 0.15f;
+        // largest change to the scale in one adjustment
+        float maxStep = 0.1f;
+        // timings lag the frames in flight and the timer's smoothing, so wait this long for a change to show before the next
+        uint32_t framesBetweenAdjustments = 15;
+    };
+
+    /**
+     * Picks the render scale from measured GPU frame time. Cost is roughly proportional to pixel count, so the scale moves
+     * by the square root of how far off target the frame is.
+     */
+    class DynamicResolution {
+    public:
+        explicit DynamicResolution(const DynamicResolutionProps &props = {});
+
+        // feed the GPU time of the most recent finished frame, returns true if the scale changed
+        bool update(double gpuFrameMilliseconds);
+
+        [[nodiscard]]
+        float getScale() const;
+
+        // the scaled extent to render this frame at
+        [[nodiscard]]
+        vk::Extent2D getRenderExtent(vk::Extent2D outputExtent) const;
+
+        // what render targets need to be allocated at so any scale fits without reallocating
+        [[nodiscard]]
+        vk::Extent2D getMaxRenderExtent(vk::Extent2D outputExtent) const;
+
+    private:
+        DynamicResolutionProps props;
+        float scale;
+        uint32_t framesSinceAdjustment = 0;
+
+        static vk::Extent2D scaleExtent(vk::Extent2D extent, float scale);
+    };
+}
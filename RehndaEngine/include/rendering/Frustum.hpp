@@ -0,0 +1,37 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <glm/glm.hpp>
+
+namespace Rehnda {
+    /**
+     * Six planes (xyz = inward facing normal, w = distance) extracted from a clip matrix. Extracting from model-view-projection
+     * gives planes in the model's local space, from view-projection gives world space planes.
+     */
+    struct Frustum {
+        // suffixed since windows.h defines NEAR and FAR as macros
+        enum Plane {
+            LEFT_PLANE,
+            RIGHT_PLANE,
+            BOTTOM_PLANE,
+            TOP_PLANE,
+            NEAR_PLANE,
+            FAR_PLANE,
+        };
+
+        std::array<glm::vec4, 6> planes;
+
+        // expects Vulkan style [0, 1] clip depth (GLM_FORCE_DEPTH_ZERO_TO_ONE)
+        static Frustum fromMatrix(const glm::mat4 &clipMatrix);
+
+        [[nodiscard]]
+        bool intersectsSphere(glm::vec3 center, float radius) const;
+
+        [[nodiscard]]
+        bool intersectsAabb(glm::vec3 min, glm::vec3 max) const;
+    };
+}
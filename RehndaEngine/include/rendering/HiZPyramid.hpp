@@ -0,0 +1,46 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "scene/Aabb.hpp"
+
+namespace Rehnda {
+    /**
+     * Hierarchical depth buffer for occlusion culling. Level 0 is a depth buffer from an earlier frame, every level after
+     * that halves the resolution and keeps the farthest depth of the texels it covers. A box is hidden if its nearest point is
+     * farther away than the farthest depth over the screen area it covers, which only needs a handful of texel reads at a
+     * level where that area is about 2x2 texels.
+     */
+    class HiZPyramid {
+    public:
+        // depth is row major, top row first, [0, 1] with 1 being the far plane, viewProjection is what rendered it
+        void build(std::span<const float> depth, uint32_t width, uint32_t height, const glm::mat4 &viewProjection);
+
+        void clear();
+
+        [[nodiscard]]
+        bool isEmpty() const;
+
+        // conservative, anything crossing the near plane or touching the screen edge counts as visible
+        [[nodiscard]]
+        bool isOccluded(const Aabb &worldBounds) const;
+
+    private:
+        struct Level {
+            uint32_t width;
+            uint32_t height;
+            std::vector<float> maxDepth;
+        };
+
+        std::vector<Level> levels;
+        glm::mat4 viewProjection{1.f};
+    };
+}
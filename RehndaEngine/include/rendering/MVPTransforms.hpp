@@ -9,8 +9,8 @@
 namespace Rehnda {
     // Buffer structures need to have memory aligned according to the spec https://www.khronos.org/registry/vulkan/specs/1.3-extensions/html/chap15.html#interfaces-resources-layout
     // mat4 needs to be 16 byte aligned (can be done using alignas(x)
+    // per object model matrices live in the frame's ObjectRecords
     struct MVPTransforms {
-        alignas(16) glm::mat4 model;
         alignas(16) glm::mat4 view;
         alignas(16) glm::mat4 proj;
     };
@@ -0,0 +1,25 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "rendering/Vertex.hpp"
+#include "rendering/Meshlets.hpp"
+#include "rendering/MeshLod.hpp"
+
+namespace Rehnda {
+    // CPU side indexed geometry, what the importer produces and what gets uploaded into a RenderableMesh
+    struct MeshData {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        // optional, when present every meshlet is a contiguous range of indices
+        std::vector<Meshlet> meshlets;
+        // optional, when present LOD 0 covers the meshlets and coarser LODs follow it in indices
+        std::vector<MeshLod> lods;
+        MeshBounds bounds{};
+    };
+}
@@ -0,0 +1,72 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Rehnda {
+    struct MeshData;
+    struct Vertex;
+
+    // one level of detail, a range of the mesh's shared index buffer, LOD 0 is always the full detail mesh
+    struct MeshLod {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        // worst case deviation from the full detail surface, in model space units
+        float error;
+    };
+
+    struct MeshBounds {
+        glm::vec3 center;
+        float radius;
+    };
+
+    struct MeshLodProps {
+        // including LOD 0
+        uint32_t maxLodCount = 5;
+        // each LOD aims for this fraction of the previous LOD's triangles
+        float reductionPerLod = 0.5f;
+        // simplification stops once it would deviate more than this, relative to the mesh extents
+        float maxRelativeError = 0.05f;
+        // don't bother with LODs smaller than this
+        uint32_t minTriangleCount = 64;
+    };
+
+    namespace MeshLods {
+        /**
+         * Builds a chain of quadric error simplified LODs, each one simplified from the previous. The simplified indices are
+         * appended to meshData.indices so all LODs share the one vertex and index buffer, only the range drawn changes.
+         */
+        std::vector<MeshLod> build(MeshData &meshData, const MeshLodProps &props = {});
+
+        MeshBounds computeBounds(std::span<const Vertex> vertices);
+    }
+
+    struct LodSelectionProps {
+        // coarsest LOD whose error projects to at most this many pixels is used
+        float maxPixelError = 1.f;
+        // fraction of maxPixelError either side of the threshold where the current LOD is kept, stops popping back and forth
+        float hysteresis = 0.2f;
+    };
+
+    // shared by every object drawing the mesh, the LOD each object was last drawn at is kept by the caller
+    class LodSelector {
+    public:
+        explicit LodSelector(std::span<const MeshLod> lods, LodSelectionProps props = {});
+
+        // distance from the camera to the nearest point of the mesh bounds, in the same units as the LOD errors.
+        // previousLod is the LOD this object was drawn at last frame, 0 for one that's new
+        [[nodiscard]]
+        uint32_t select(float distance, float projectionScale, uint32_t previousLod) const;
+
+    private:
+        std::vector<float> lodErrors;
+        LodSelectionProps props;
+    };
+}
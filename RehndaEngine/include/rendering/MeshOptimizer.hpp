@@ -0,0 +1,43 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include "rendering/MeshData.hpp"
+
+namespace Rehnda {
+    struct MeshOptimizerProps {
+        // post transform cache size ACMR is measured against, 16 is a reasonable stand in across current GPUs
+        uint32_t vertexCacheSize = 16;
+        // how much worse ACMR may get (as a ratio) while reordering triangles to reduce overdraw
+        float overdrawThreshold = 1.05f;
+    };
+
+    struct MeshOptimizationStats {
+        // average cache miss ratio, vertex shader invocations per triangle (0.5 is ideal for a regular grid, 3 is worst)
+        float acmrBefore;
+        float acmrAfter;
+        // average transformed vertex ratio, vertex shader invocations per vertex (1 is ideal)
+        float atvrBefore;
+        float atvrAfter;
+        // fragment shader invocations per covered pixel from a software rasterized set of views
+        float overdrawBefore;
+        float overdrawAfter;
+    };
+
+    namespace MeshOptimizer {
+        /**
+         * Reorders the mesh in place:
+         *  1. triangles for post transform vertex cache locality
+         *  2. triangles (in cache friendly clusters) to draw front-most geometry first, reducing overdraw
+         *  3. vertices into the order they're first referenced, for vertex fetch locality
+         */
+        MeshOptimizationStats optimize(MeshData &meshData, const MeshOptimizerProps &props = {});
+
+        // 16 bit indices halve index buffer size and bandwidth, usable whenever every vertex can be addressed
+        bool fitsUint16Indices(size_t vertexCount);
+    }
+}
@@ -0,0 +1,19 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "rendering/Frustum.hpp"
+
+namespace Rehnda {
+    // per frame view state a mesh needs to decide what to draw, expressed in the mesh's local space
+    struct MeshViewContext {
+        Frustum frustum;
+        glm::vec3 cameraPosition;
+        // viewport height / (2 * tan(fovY / 2)), turns a size at distance 1 into pixels
+        float projectionScale;
+    };
+}
@@ -0,0 +1,74 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "rendering/MeshViewContext.hpp"
+
+namespace Rehnda {
+    struct MeshData;
+
+    /**
+     * A small cluster of triangles with bounds to cull it by. There are no mesh shaders involved: the mesh's index buffer is
+     * laid out so every meshlet is a contiguous range of it, which means culled meshlets just become gaps between drawIndexed calls.
+     */
+    struct Meshlet {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        // bounding sphere, in mesh local space
+        glm::vec3 center;
+        float radius;
+        // normal cone, every triangle in the meshlet faces away from the camera when it's inside the cone
+        glm::vec3 coneAxis;
+        float coneCutoff;
+    };
+
+    struct IndexRange {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+    };
+
+    namespace Meshlets {
+        // sized for the common mesh shader limits so the same data can feed a mesh shader path later
+        constexpr size_t MAX_VERTICES = 64;
+        constexpr size_t MAX_TRIANGLES = 124;
+
+        // splits the mesh into meshlets, rewriting meshData.indices so each meshlet's triangles are contiguous
+        std::vector<Meshlet> build(MeshData &meshData);
+    }
+
+    /**
+     * Keeps meshlet bounds in structure of arrays form so four meshlets are tested against the frustum and their normal
+     * cone per SSE instruction. Surviving meshlets that are adjacent in the index buffer are merged into a single range.
+     */
+    class MeshletCuller {
+    public:
+        explicit MeshletCuller(std::span<const Meshlet> meshlets);
+
+        // the returned ranges are valid until the next call
+        std::span<const IndexRange> cull(const MeshViewContext &context);
+
+        [[nodiscard]]
+        size_t getMeshletCount() const;
+
+    private:
+        size_t meshletCount;
+        std::vector<IndexRange> meshletRanges;
+        // padded up to a multiple of 4 so the SIMD loop never needs a scalar tail
+        std::vector<float> centerX, centerY, centerZ, radius;
+        std::vector<float> coneAxisX, coneAxisY, coneAxisZ, coneCutoff;
+
+        std::vector<IndexRange> visibleRanges;
+
+        // bit i of the result is set when meshlet (first + i) is visible
+        [[nodiscard]]
+        uint32_t testFour(size_t first, const MeshViewContext &context) const;
+    };
+}
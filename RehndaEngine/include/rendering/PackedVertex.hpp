@@ -0,0 +1,37 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "rendering/Vertex.hpp"
+#include "rendering/VertexLayout.hpp"
+
+namespace Rehnda {
+    /**
+     * 16 byte drop in replacement for Vertex (32 bytes) that binds to the same shader inputs, the input assembler expands
+     * the packed formats back to floats. Half float positions are fine for anything within a few thousand units of the origin.
+     */
+    struct PackedVertex {
+        // half float xyz, w is always 1
+        std::array<uint16_t, 4> pos;
+        std::array<uint8_t, 4> color;
+        // half float uv
+        std::array<uint16_t, 2> texCoord;
+
+        using Layout = VertexLayout<vk::Format::eR16G16B16A16Sfloat, vk::Format::eR8G8B8A8Unorm, vk::Format::eR16G16Sfloat>;
+
+        static PackedVertex pack(const Vertex &vertex);
+
+        static std::vector<PackedVertex> packAll(std::span<const Vertex> vertices);
+    };
+
+    static_assert(sizeof(PackedVertex) == PackedVertex::Layout::stride);
+    static_assert(offsetof(PackedVertex, color) == PackedVertex::Layout::offsets[1]);
+    static_assert(offsetof(PackedVertex, texCoord) == PackedVertex::Layout::offsets[2]);
+}
@@ -0,0 +1,19 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include "core/RehndaMath.hpp"
+
+namespace Rehnda {
+    // matches the std430 PointLight in the clustering and shading shaders, 32 bytes
+    struct PointLight {
+        glm::vec3 position;
+        // the light contributes nothing past this distance, which is what lets it be binned into clusters
+        float radius;
+        glm::vec3 color;
+        float intensity;
+    };
+    static_assert(sizeof(PointLight) == 32);
+}
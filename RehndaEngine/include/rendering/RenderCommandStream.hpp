@@ -0,0 +1,92 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <variant>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "rendering/PointLight.hpp"
+#include "scene/TransformStore.hpp"
+
+namespace Rehnda {
+    // the projection depends on the swapchain's aspect ratio, which only the renderer knows, so the camera carries the fov
+    struct RenderCamera {
+        glm::mat4 view;
+        float fovY;
+    };
+
+    struct RenderTransform {
+        TransformHandle transform;
+        glm::vec3 position;
+        glm::quat rotation;
+        glm::vec3 scale;
+    };
+
+    // lights points into the stream, so it's only valid until the stream is cleared
+    using RenderCommand = std::variant<RenderCamera, RenderTransform, std::span<const PointLight>>;
+
+    /**
+     * Everything the game hands the renderer for one frame, as a flat list of commands in a buffer allocated once up front.
+     * Writing a frame never allocates, which keeps the game thread's frame cost flat however much it sends.
+     */
+    class RenderCommandStream {
+    public:
+        explicit RenderCommandStream(size_t capacityBytes);
+
+        void clear();
+
+        void setCamera(const RenderCamera &camera);
+
+        void setTransform(const RenderTransform &transform);
+
+        // replaces all lights for the frame
+        void setLights(std::span<const PointLight> lights);
+
+        // walks the commands in the order they were written
+        class Reader {
+        public:
+            explicit Reader(const RenderCommandStream &stream);
+
+            std::optional<RenderCommand> next();
+
+        private:
+            const RenderCommandStream &stream;
+            size_t offset = 0;
+        };
+
+        [[nodiscard]]
+        Reader read() const;
+
+        [[nodiscard]]
+        size_t size() const;
+
+    private:
+        enum class CommandType : uint32_t {
+            CAMERA,
+            TRANSFORM,
+            LIGHTS,
+        };
+
+        struct CommandHeader {
+            CommandType type;
+            uint32_t payloadSize;
+        };
+
+        // every command starts aligned to this, so payloads can be read in place
+        static constexpr size_t COMMAND_ALIGNMENT = 16;
+
+        size_t capacity;
+        std::unique_ptr<std::byte[]> buffer;
+        size_t used = 0;
+
+        void write(CommandType type, const void *payload, size_t payloadSize);
+    };
+}
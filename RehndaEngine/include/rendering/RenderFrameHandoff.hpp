@@ -0,0 +1,49 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "rendering/RenderCommandStream.hpp"
+
+namespace Rehnda {
+    /**
+     * Passes frames from the game thread to the render thread through two command streams: the game writes frame N+1 into
+     * one while the render thread draws frame N from the other. The only shared state is a pair of frame counters, each side
+     * blocks on the other's counter (atomic wait, so a futex rather than a lock) only when it gets a full frame ahead.
+     *
+     * Also works with both sides on one thread as long as every beginWrite/publish is followed by an acquire/release.
+     */
+    class RenderFrameHandoff {
+    public:
+        explicit RenderFrameHandoff(size_t streamCapacityBytes);
+
+        // game thread. The stream for the next frame, cleared, waits while the render thread is still reading it
+        RenderCommandStream &beginWrite();
+
+        void publish();
+
+        // render thread. The oldest unread frame, waiting for one to be published, or nullptr once closed
+        const RenderCommandStream *acquire();
+
+        // the acquired stream can be written again
+        void release();
+
+        // wakes up and ends both sides, from either thread
+        void close();
+
+        [[nodiscard]]
+        bool isClosed() const;
+
+    private:
+        std::array<RenderCommandStream, 2> streams;
+        // frames published by the game and released by the renderer so far, frame i lives in streams[i % 2]
+        std::atomic<uint64_t> publishedFrames{0};
+        std::atomic<uint64_t> releasedFrames{0};
+        std::atomic<bool> closed{false};
+    };
+}
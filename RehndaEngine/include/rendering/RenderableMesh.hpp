@@ -6,30 +6,85 @@
 
 #include <vector>
 #include <cstdint>
+#include <optional>
+#include <span>
 #include "Vertex.hpp"
 #include "rendering/vulkan/StagedBuffer.hpp"
+#include "assets/MeshCache.hpp"
+#include "rendering/Meshlets.hpp"
+#include "rendering/MeshLod.hpp"
+#include "rendering/MeshViewContext.hpp"
 
 namespace Rehnda {
     struct DeviceContext {
         vkr::Device &device;
         vkr::PhysicalDevice &physicalDevice;
-        vkr::CommandPool &memoryCommandPool;
-        vkr::Queue &graphicsQueue;
+        UploadQueue &uploadQueue;
     };
 
     class RenderableMesh {
     public:
-        RenderableMesh(const DeviceContext &deviceContext, const std::vector<Vertex> &vertices, const std::vector<uint16_t> &indices);
+        // works with any vertex struct (Vertex, PackedVertex...), the pipeline drawing it needs to use the matching VertexLayout
+        template<typename VertexType, typename IndexType>
+        RenderableMesh(const DeviceContext &deviceContext, std::span<const VertexType> vertices, std::span<const IndexType> indices) :
+                RenderableMesh(deviceContext, std::as_bytes(vertices), std::as_bytes(indices),
+                               static_cast<uint32_t>(indices.size()), indexTypeOf<IndexType>()) {
+        }
+
+        // the cached vertex and index blocks are copied straight from the cache mapping into the staging buffers, the
+        // vertices are already PackedVertex so the mesh draws with the same pipeline as everything else. Meshlets in the
+        // cache enable per cluster culling
+        RenderableMesh(const DeviceContext &deviceContext, const CachedMesh &cachedMesh);
 
         RenderableMesh(const RenderableMesh &) = delete;
 
         RenderableMesh &operator=(const RenderableMesh &) = delete;
 
-        void draw(vkr::CommandBuffer &commandBuffer) const;
+        // firstInstance is how shaders find the draw's object record, see ObjectRecord. Both return the draw calls recorded
+        uint32_t draw(vkr::CommandBuffer &commandBuffer, uint32_t firstInstance = 0) const;
+
+        // LOD for an object drawing this mesh, previousLod is the one the object was drawn at last frame so it doesn't pop
+        // back and forth at the threshold. Always 0 for meshes without LODs
+        [[nodiscard]]
+        uint32_t selectLod(const MeshViewContext &viewContext, uint32_t previousLod) const;
+
+        // draws the given LOD or, at full detail, culls meshlets to only draw the survivors
+        uint32_t draw(vkr::CommandBuffer &commandBuffer, const MeshViewContext &viewContext, uint32_t lod,
+                      uint32_t firstInstance = 0);
+
+    private:
+        RenderableMesh(const DeviceContext &deviceContext, std::span<const std::byte> vertexBytes,
+                       std::span<const std::byte> indexBytes, uint32_t indicesCount, vk::IndexType indexType,
+                       std::span<const Meshlet> meshlets = {}, std::span<const MeshLod> lods = {},
+                       MeshBounds bounds = {});
+
+        void bindBuffers(vkr::CommandBuffer &commandBuffer) const;
+
+        template<typename IndexType>
+        static constexpr vk::IndexType indexTypeOf() {
+            static_assert(std::is_same_v<IndexType, uint16_t> || std::is_same_v<IndexType, uint32_t>,
+                          "Index buffers must be uint16_t or uint32_t");
+            return std::is_same_v<IndexType, uint16_t> ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+        }
 
     private:
         StagedBuffer vertexBuffer;
         StagedBuffer indexBuffer;
         uint32_t indicesCount;
+        vk::IndexType indexType;
+        std::optional<MeshletCuller> meshletCuller;
+        std::vector<MeshLod> lods;
+        std::optional<LodSelector> lodSelector;
+        MeshBounds bounds;
+    };
+
+    // an entry in the list of visible meshes the renderer draws each frame
+    struct MeshDraw {
+        RenderableMesh *mesh;
+        MeshViewContext viewContext;
+        // index of the draw's transform and material in the frame's object records
+        uint32_t objectIndex;
+        // picked once per frame so every pass draws the object at the same detail
+        uint32_t lod = 0;
     };
 }
\ No newline at end of file
@@ -5,18 +5,30 @@
 #pragma once
 
 #include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/VertexLayout.hpp"
 #include <glm/glm.hpp>
 
 namespace Rehnda {
+    // full precision vertex, what importers and mesh processing work with before packing for upload
     struct Vertex {
         glm::vec3 pos;
         glm::vec3 color;
         glm::vec2 texCoord;
 
+        using Layout = VertexLayout<vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32B32Sfloat, vk::Format::eR32G32Sfloat>;
+
         // describing the chunk as a single unit of data
-        static vk::VertexInputBindingDescription getBindingDescription();
+        static constexpr vk::VertexInputBindingDescription getBindingDescription() {
+            return Layout::getBindingDescription();
+        }
 
         // describing what's inside a vertex
-        static std::array<vk::VertexInputAttributeDescription, 3> getAttributeDescriptions();
+        static constexpr std::array<vk::VertexInputAttributeDescription, 3> getAttributeDescriptions() {
+            return Layout::getAttributeDescriptions();
+        }
     };
-}
\ No newline at end of file
+
+    static_assert(sizeof(Vertex) == Vertex::Layout::stride);
+    static_assert(offsetof(Vertex, color) == Vertex::Layout::offsets[1]);
+    static_assert(offsetof(Vertex, texCoord) == Vertex::Layout::offsets[2]);
+}
@@ -0,0 +1,103 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+
+namespace Rehnda {
+    // size in bytes of a single attribute of the given format, 0 for formats we don't use as vertex attributes
+    constexpr uint32_t vertexFormatSize(vk::Format format) {
+        switch (format) {
+            case vk::Format::eR32G32B32A32Sfloat:
+                return 16;
+            case vk::Format::eR32G32B32Sfloat:
+                return 12;
+            case vk::Format::eR32G32Sfloat:
+            case vk::Format::eR16G16B16A16Sfloat:
+            case vk::Format::eR16G16B16A16Snorm:
+            case vk::Format::eR16G16B16A16Unorm:
+                return 8;
+            case vk::Format::eR32Sfloat:
+            case vk::Format::eR16G16Sfloat:
+            case vk::Format::eR16G16Snorm:
+            case vk::Format::eR16G16Unorm:
+            case vk::Format::eR8G8B8A8Unorm:
+            case vk::Format::eR8G8B8A8Snorm:
+            case vk::Format::eA2B10G10R10UnormPack32:
+            case vk::Format::eA2B10G10R10SnormPack32:
+                return 4;
+            case vk::Format::eR8G8Snorm:
+                return 2;
+            default:
+                return 0;
+        }
+    }
+
+    // runtime form of a layout, for code that picks the vertex format at runtime (e.g. pipeline creation)
+    struct VertexInputDescription {
+        vk::VertexInputBindingDescription binding;
+        std::vector<vk::VertexInputAttributeDescription> attributes;
+    };
+
+    /**
+     * A tightly packed, single binding vertex layout declared once as its list of attribute formats, in shader location order.
+     * Offsets, stride and the Vulkan binding/attribute descriptions are all worked out at compile time. Vertex structs declare
+     * their layout as `using Layout = VertexLayout<...>` and static_assert their size against Layout::stride.
+     */
+    template<vk::Format... AttributeFormats>
+    struct VertexLayout {
+        static_assert(sizeof...(AttributeFormats) > 0, "A vertex layout needs at least one attribute");
+        static_assert(((vertexFormatSize(AttributeFormats) != 0) && ...), "Vertex format is missing from vertexFormatSize");
+
+        static constexpr uint32_t attributeCount = sizeof...(AttributeFormats);
+        static constexpr std::array<vk::Format, attributeCount> formats{AttributeFormats...};
+        static constexpr uint32_t stride = (vertexFormatSize(AttributeFormats) + ...);
+
+        static constexpr std::array<uint32_t, attributeCount> offsets = []() {
+            std::array<uint32_t, attributeCount> attributeOffsets{};
+            uint32_t offset = 0;
+            for (uint32_t i = 0; i < attributeCount; i++) {
+                attributeOffsets[i] = offset;
+                offset += vertexFormatSize(formats[i]);
+            }
+            return attributeOffsets;
+        }();
+
+        static constexpr vk::VertexInputBindingDescription
+        getBindingDescription(uint32_t binding = 0, vk::VertexInputRate inputRate = vk::VertexInputRate::eVertex) {
+            return {
+                    .binding = binding,
+                    .stride = stride,
+                    .inputRate = inputRate,
+            };
+        }
+
+        static constexpr std::array<vk::VertexInputAttributeDescription, attributeCount>
+        getAttributeDescriptions(uint32_t binding = 0, uint32_t firstLocation = 0) {
+            std::array<vk::VertexInputAttributeDescription, attributeCount> attributeDescriptions{};
+            for (uint32_t i = 0; i < attributeCount; i++) {
+                attributeDescriptions[i] = {
+                        .location = firstLocation + i,
+                        .binding = binding,
+                        .format = formats[i],
+                        .offset = offsets[i],
+                };
+            }
+            return attributeDescriptions;
+        }
+
+        static VertexInputDescription getInputDescription(uint32_t binding = 0) {
+            const auto attributeDescriptions = getAttributeDescriptions(binding);
+            return {
+                    .binding = getBindingDescription(binding),
+                    .attributes = {attributeDescriptions.begin(), attributeDescriptions.end()},
+            };
+        }
+    };
+}
@@ -0,0 +1,15 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// helpers for squeezing full precision attributes into the compact formats the packed vertices use
+namespace Rehnda::VertexQuantization {
+    uint16_t toHalf(float value);
+
+    uint8_t toUnorm8(float value);
+}
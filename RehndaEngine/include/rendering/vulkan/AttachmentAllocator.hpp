@@ -0,0 +1,102 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+
+namespace Rehnda {
+    struct AttachmentDescription {
+        vk::Format format;
+        vk::Extent2D extent;
+        vk::ImageUsageFlags usage;
+        vk::ImageAspectFlags aspect;
+        // cleared or discarded on load and never stored, so on tiled GPUs it can live entirely in tile memory
+        bool transient = false;
+        // first and last pass that touch the attachment within a frame. Attachments whose ranges don't overlap may share
+        // memory, so the first pass of each must not depend on the previous contents (load op clear or don't care). The
+        // allocator only plans the memory, ordering one occupant's last use before the next one's first is up to the caller,
+        // see getMemoryBlock
+        uint32_t firstPass = 0;
+        uint32_t lastPass = 0;
+    };
+
+    using AttachmentHandle = uint32_t;
+
+    struct AttachmentMemoryStats {
+        // what giving every attachment its own device local memory would cost
+        vk::DeviceSize requestedBytes;
+        // device local memory actually allocated, after aliasing
+        vk::DeviceSize allocatedBytes;
+        // reserved as lazily allocated, which a tiled GPU normally never backs
+        vk::DeviceSize lazilyAllocatedBytes;
+    };
+
+    /**
+     * Creates render pass attachments as a batch so their memory can be planned together. Transient attachments use
+     * eTransientAttachment and lazily allocated memory where the device has it, everything else is packed into as few
+     * memory blocks as lifetimes allow, with attachments in the same block aliasing each other.
+     */
+    class AttachmentAllocator {
+    public:
+        AttachmentAllocator(vkr::Device &device, vkr::PhysicalDevice &physicalDevice);
+
+        // handles stay valid until clear
+        AttachmentHandle add(const AttachmentDescription &description);
+
+        // binds memory for and creates views of everything added, call once after adding them all
+        void allocate();
+
+        // the device must be idle
+        void clear();
+
+        [[nodiscard]]
+        const vkr::Image &getImage(AttachmentHandle handle) const;
+
+        [[nodiscard]]
+        const vkr::ImageView &getImageView(AttachmentHandle handle) const;
+
+        // index of the memory block the attachment is bound to, every attachment in a block is bound at offset 0 so two
+        // attachments with the same block alias each other. Empty for lazily allocated ones, which never share
+        [[nodiscard]]
+        std::optional<uint32_t> getMemoryBlock(AttachmentHandle handle) const;
+
+        [[nodiscard]]
+        uint32_t getMemoryBlockCount() const;
+
+        [[nodiscard]]
+        const AttachmentMemoryStats &getStats() const;
+
+    private:
+        struct Attachment {
+            AttachmentDescription description;
+            vkr::Image image;
+            vkr::ImageView imageView;
+            vk::MemoryRequirements requirements;
+            bool lazilyAllocated;
+            std::optional<uint32_t> memoryBlock;
+        };
+
+        struct MemoryBlock {
+            vk::DeviceSize size;
+            uint32_t memoryTypeBits;
+            std::vector<size_t> attachments;
+        };
+
+        vkr::Device &device;
+        vkr::PhysicalDevice &physicalDevice;
+        bool supportsLazyMemory;
+
+        std::vector<Attachment> attachments;
+        std::vector<vkr::DeviceMemory> memories;
+        uint32_t memoryBlockCount = 0;
+        AttachmentMemoryStats stats{};
+
+        [[nodiscard]]
+        bool fitsBlock(const MemoryBlock &block, const Attachment &attachment) const;
+    };
+}
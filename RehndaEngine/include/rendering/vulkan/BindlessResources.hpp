@@ -0,0 +1,90 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/vulkan/WritableDirectBuffer.hpp"
+#include "rendering/vulkan/PipelineLayoutCache.hpp"
+#include "core/RehndaMath.hpp"
+
+namespace Rehnda {
+    struct BindlessResourcesProps {
+        // sizes of the global arrays, slots are never reused so these cap how many get added over the whole run
+        uint32_t maxTextures = 4096;
+        uint32_t maxMaterials = 1024;
+    };
+
+    // matches MaterialRecord in triangle.frag (std430)
+    struct MaterialRecord {
+        uint32_t albedoTexture;
+        uint32_t padding[3];
+    };
+
+    // matches ObjectRecord in triangle.vert and depth_prepass.vert (std430), one per draw indexed by its first instance
+    struct ObjectRecord {
+        alignas(16) glm::mat4 model;
+        uint32_t materialIndex;
+        uint32_t padding[3];
+    };
+
+    /**
+     * One descriptor set for every texture and material, bound once per frame at BINDLESS_SET rather than per draw.
+     * Textures go into a single sampled image array of maxTextures slots and materials into a storage buffer of records
+     * pointing at them, so a draw only needs its object index, which it carries in firstInstance.
+     *
+     * Built on Vulkan 1.2 descriptor indexing: the array is partially bound, so unused slots don't need valid descriptors,
+     * and update after bind, so adding a texture never waits on frames that already have the set bound. Adding only ever
+     * writes new slots, which nothing in flight can be reading yet.
+     *
+     * The set layout is reflected from the shaders that bind it. The texture array is runtime sized in the shaders, the
+     * layout gives it a fixed maxTextures descriptors, filled from the front as textures are added.
+     */
+    class BindlessResources {
+    public:
+        static constexpr uint32_t BINDLESS_SET = 1;
+        static constexpr uint32_t TEXTURES_BINDING = 0;
+        static constexpr uint32_t MATERIALS_BINDING = 1;
+
+        // shaders is every shader that binds BINDLESS_SET, merged
+        BindlessResources(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, PipelineLayoutCache &layoutCache,
+                          const ShaderReflection &shaders, const BindlessResourcesProps &props = {});
+
+        // whether physicalDevice has the descriptor indexing features needed, and the ones to enable when creating the device
+        static bool isSupported(const vkr::PhysicalDevice &physicalDevice);
+
+        static vk::PhysicalDeviceVulkan12Features getRequiredFeatures();
+
+        // the index to put in a MaterialRecord, the image has to be in shader read only layout whenever it's sampled
+        uint32_t addTexture(vk::ImageView imageView, vk::Sampler sampler);
+
+        // the index to put in an ObjectRecord
+        uint32_t addMaterial(const MaterialRecord &material);
+
+        [[nodiscard]]
+        vk::DescriptorSetLayout getSetLayout() const;
+
+        [[nodiscard]]
+        vk::DescriptorSet getDescriptorSet() const;
+
+    private:
+        vkr::Device &device;
+        // limited to what the device can bind
+        BindlessResourcesProps props;
+
+        // owned by the cache
+        vk::DescriptorSetLayout setLayout;
+        vkr::DescriptorPool descriptorPool;
+        vkr::DescriptorSet descriptorSet;
+        WritableDirectBuffer materialBuffer;
+        uint32_t textureCount = 0;
+        uint32_t materialCount = 0;
+
+        static BindlessResourcesProps clampToLimits(const vkr::PhysicalDevice &physicalDevice, BindlessResourcesProps props);
+
+        vkr::DescriptorPool createDescriptorPool();
+
+        vkr::DescriptorSet createDescriptorSet();
+    };
+}
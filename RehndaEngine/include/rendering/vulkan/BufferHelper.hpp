@@ -6,6 +6,8 @@
 
 
 
+#include <vector>
+
 #include "rendering/vulkan/VkTypes.hpp"
 
 namespace Rehnda::BufferHelper {
@@ -13,9 +15,18 @@ namespace Rehnda::BufferHelper {
         vk::DeviceSize size;
         vk::BufferUsageFlags bufferUsage;
         vk::MemoryPropertyFlags requiredMemoryProperties;
+        // only needed when more than one queue family uses the buffer, which then shares it concurrently rather than
+        // transferring ownership back and forth. Must not repeat a family
+        std::vector<uint32_t> queueFamilies{};
     };
 
     std::tuple<vkr::Buffer, vkr::DeviceMemory> createBuffer(vkr::Device& device, vkr::PhysicalDevice& physicalDevice, const CreateBufferAndAssignMemoryProps& props);
 
+    // exclusive to one family unless queueFamilies lists several, the vector has to outlive creating the buffer
+    void setSharingMode(vk::BufferCreateInfo &bufferCreateInfo, const std::vector<uint32_t> &queueFamilies);
+
     uint32_t findMemoryType(vkr::PhysicalDevice& physicalDevice, uint32_t typeFilter, vk::MemoryPropertyFlags properties);
+
+    // e.g. eLazilyAllocated, which tiled GPUs expose and desktop GPUs generally don't
+    bool hasMemoryType(const vkr::PhysicalDevice& physicalDevice, vk::MemoryPropertyFlags properties);
 } // Rehnda
\ No newline at end of file
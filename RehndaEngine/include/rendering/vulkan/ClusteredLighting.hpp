@@ -0,0 +1,116 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "core/RehndaMath.hpp"
+#include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/vulkan/WritableDirectBuffer.hpp"
+#include "rendering/vulkan/StorageBuffer.hpp"
+#include "rendering/vulkan/ComputePipeline.hpp"
+#include "rendering/vulkan/DescriptorAllocator.hpp"
+#include "rendering/PointLight.hpp"
+#include "rendering/vulkan/ShaderLibrary.hpp"
+
+namespace Rehnda {
+    struct ClusteredLightingProps {
+        // froxel grid, screen tiles in x and y and exponentially spaced depth slices in z
+        uint32_t gridX = 16;
+        uint32_t gridY = 9;
+        uint32_t gridZ = 24;
+        // lights past this in a single cluster are dropped, so keep it well above what a scene puts in one place
+        uint32_t maxLightsPerCluster = 128;
+        uint32_t maxLights = 1024;
+    };
+
+    struct ClusterCamera {
+        glm::mat4 view;
+        glm::mat4 projection;
+        float zNear;
+        float zFar;
+        // the area rendered this frame, tiles are a fraction of it so they follow the render scale
+        vk::Extent2D renderExtent;
+    };
+
+    // matches ClusterParams in cluster_lights.comp and triangle.frag (std140)
+    struct ClusterParams {
+        alignas(16) glm::mat4 view;
+        alignas(16) glm::mat4 inverseProjection;
+        alignas(16) glm::vec4 cameraPosition;
+        alignas(8) glm::vec2 renderExtent;
+        float zNear;
+        float zFar;
+        uint32_t gridX;
+        uint32_t gridY;
+        uint32_t gridZ;
+        uint32_t maxLightsPerCluster;
+        uint32_t lightCount;
+    };
+
+    /**
+     * Clustered forward lighting. Each frame a compute pass bins the lights into a froxel grid, writing a fixed size light
+     * index list per cluster, and the fragment shader only iterates the lights in the cluster it falls in. Buffers are per
+     * frame in flight so binning a frame never races shading the previous one.
+     *
+     * The buffers are bound in the frame descriptor set, which the compute pipeline shares, at the bindings below. With
+     * async compute the binning runs on another queue family, so the buffers are shared concurrently between the families
+     * passed in rather than having their ownership passed back and forth every frame.
+     */
+    class ClusteredLighting {
+    public:
+        static constexpr uint32_t PARAMS_BINDING = 2;
+        static constexpr uint32_t LIGHTS_BINDING = 3;
+        static constexpr uint32_t LIGHT_COUNTS_BINDING = 4;
+        static constexpr uint32_t LIGHT_INDICES_BINDING = 5;
+
+        // the frame set layout has to be reflected from cluster_lights.comp along with the graphics shaders sharing it
+        ClusteredLighting(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, ShaderLibrary &shaderLibrary,
+                          PipelineLayoutCache &layoutCache, vk::DescriptorSetLayout descriptorSetLayout, size_t framesInFlight,
+                          std::vector<uint32_t> queueFamilies, const ClusteredLightingProps &props = {});
+
+        // the frame's buffers at the bindings above, for the caller to write along with the rest of the set
+        [[nodiscard]]
+        std::vector<DescriptorWrite> getDescriptorWrites(size_t frameIndex) const;
+
+        // picks up a hot reloaded culling shader, call before recording frameNumber
+        void applyReload(uint64_t frameNumber);
+
+        // lights past maxLights are ignored
+        void update(size_t frameIndex, std::span<const PointLight> lights, const ClusterCamera &camera);
+
+        // call outside a render pass. Writes the cluster buffers below, the caller makes them visible to whatever shades with them
+        void recordLightCulling(vkr::CommandBuffer &commandBuffer, vk::DescriptorSet descriptorSet);
+
+        [[nodiscard]]
+        vk::Buffer getLightCountsBuffer(size_t frameIndex) const;
+
+        [[nodiscard]]
+        vk::Buffer getLightIndicesBuffer(size_t frameIndex) const;
+
+    private:
+        // specialized into the shader, which sizes its shared light batch by it
+        static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+        struct FrameBuffers {
+            WritableDirectBuffer params;
+            WritableDirectBuffer lights;
+            StorageBuffer lightCounts;
+            StorageBuffer lightIndices;
+        };
+
+        vkr::Device &device;
+        vkr::PhysicalDevice &physicalDevice;
+        ClusteredLightingProps props;
+        uint32_t clusterCount;
+        std::vector<uint32_t> queueFamilies;
+
+        std::vector<FrameBuffers> frameBuffers;
+        ComputePipeline pipeline;
+
+        std::vector<FrameBuffers> createFrameBuffers(size_t framesInFlight);
+    };
+}
@@ -0,0 +1,95 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/vulkan/PipelineLayoutCache.hpp"
+#include "rendering/vulkan/PipelineReload.hpp"
+#include "rendering/vulkan/ShaderLibrary.hpp"
+#include "rendering/vulkan/ShaderPermutation.hpp"
+#include "core/RehndaMath.hpp"
+
+namespace Rehnda {
+    struct ComputePipelineProps {
+        // the source's file name, e.g. "cluster_lights.comp", loaded through the shader library
+        std::string shaderName;
+        // bound from set 0 in order, they must cover every set the shader uses. Passed in rather than reflected, as sets
+        // shared with other stages need those stages in their layouts too
+        std::vector<vk::DescriptorSetLayout> setLayouts{};
+        std::vector<SpecializationConstant> specializationConstants{};
+        // local size of the shader, used to round invocation counts up to whole workgroups. If the shader declares it
+        // with local_size_x_id and friends, set workgroupSizeConstantIds and it's passed in as specialization constants
+        glm::uvec3 workgroupSize{64, 1, 1};
+        std::optional<glm::uvec3> workgroupSizeConstantIds{};
+    };
+
+    /**
+     * A single compute shader and its layout. Bind it, push its constants and dispatch, which is all any compute pass needs,
+     * so passes like light culling only own the buffers they work on. Push constants are sized from the shader itself.
+     * Rebuilt when the shader is saved, as long as its layout stays the same.
+     */
+    class ComputePipeline {
+    public:
+        // framesInFlight is how long a pipeline replaced by a hot reload is kept alive
+        ComputePipeline(vkr::Device &device, ShaderLibrary &shaderLibrary, PipelineLayoutCache &layoutCache,
+                        const ComputePipelineProps &props, size_t framesInFlight);
+
+        ComputePipeline(const ComputePipeline &) = delete;
+
+        // swaps in a pipeline rebuilt after the shader was saved, call before recording frameNumber
+        void applyReload(uint64_t frameNumber);
+
+        // binds the pipeline and, if there are any, descriptorSets from set 0
+        void bind(vkr::CommandBuffer &commandBuffer, std::span<const vk::DescriptorSet> descriptorSets = {}) const;
+
+        void pushConstants(vkr::CommandBuffer &commandBuffer, const void *data, uint32_t size, uint32_t offset = 0) const;
+
+        template<typename T>
+        void pushConstants(vkr::CommandBuffer &commandBuffer, const T &constants) const {
+            static_assert(std::is_trivially_copyable_v<T>, "Push constants are copied byte for byte");
+            pushConstants(commandBuffer, &constants, sizeof(T));
+        }
+
+        // in workgroups
+        void dispatch(vkr::CommandBuffer &commandBuffer, uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1) const;
+
+        // enough workgroups for at least this many invocations, the shader has to ignore the ones past the end
+        void dispatchInvocations(vkr::CommandBuffer &commandBuffer, uint32_t countX, uint32_t countY = 1, uint32_t countZ = 1) const;
+
+        [[nodiscard]]
+        vk::PipelineLayout getLayout() const;
+
+        [[nodiscard]]
+        glm::uvec3 getWorkgroupSize() const;
+
+    private:
+        vkr::Device &device;
+        ShaderLibrary &shaderLibrary;
+        PipelineLayoutCache &layoutCache;
+        ComputePipelineProps props;
+
+        // filled in from the shader's reflection when the pipeline is created, the cache owns the layout
+        uint32_t pushConstantSize = 0;
+        vk::PipelineLayout pipelineLayout{};
+        vkr::Pipeline pipeline{nullptr};
+        PipelineReload<vkr::Pipeline> reload;
+        // last, so the watcher can't call back into a half destroyed pipeline
+        ShaderLibrary::Watch shaderWatch;
+
+        vk::PipelineLayout createPipelineLayout(std::span<const uint32_t> code, uint32_t &reflectedPushConstantSize) const;
+
+        vkr::Pipeline createPipeline(std::span<const uint32_t> code) const;
+
+        // watcher thread, compiles and builds a replacement and offers it to the recording thread
+        void rebuild();
+    };
+}
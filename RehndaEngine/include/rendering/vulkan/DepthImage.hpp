@@ -5,24 +5,12 @@
 #pragma once
 
 #include "rendering/vulkan/VkTypes.hpp"
-#include "Image.hpp"
 
 namespace Rehnda {
+    // depth attachments themselves come from an AttachmentAllocator, which makes them transient and lazily allocated when
+    // nothing reads them after the render pass
+    namespace DepthImage {
+        vk::Format findDepthFormat(const vkr::PhysicalDevice &physicalDevice);
+    }
 
-    class DepthImage {
-    public:
-        DepthImage(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, vk::Extent2D extent);
-
-        const vkr::ImageView& getImageView() const;
-
-        void resize(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, vk::Extent2D extent);
-
-        static vk::Format findDepthFormat(const vkr::PhysicalDevice &physicalDevice);
-    private:
-        vk::Format depthImageFormat;
-        std::unique_ptr<Image> image;
-
-        bool hasStencilComponent();
-    };
-
-} // Rehnda
\ No newline at end of file
+} // Rehnda
@@ -0,0 +1,73 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "rendering/vulkan/VkTypes.hpp"
+
+namespace Rehnda {
+    /**
+     * Copies the depth buffer into host visible memory at the end of each frame, one buffer per frame in flight. The CPU
+     * reads a copy once the fence of the frame that recorded it has signalled, so occlusion data is a frame or two old.
+     */
+    class DepthReadback {
+    public:
+        // maxExtent is the largest region that will be copied, e.g. the depth image's size
+        DepthReadback(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, size_t framesInFlight, vk::Extent2D maxExtent,
+                      vk::Format depthFormat);
+
+        // call outside the render pass with depth in TransferSrcOptimal. Copies the top left renderExtent of the image, which
+        // is what was rendered this frame. viewProjection is kept alongside for testing against later
+        void recordCopy(vkr::CommandBuffer &commandBuffer, vk::Image depthImage, vk::Extent2D renderExtent,
+                        size_t frameIndex, uint64_t frameNumber, const glm::mat4 &viewProjection);
+
+        // only valid once the fence for frameIndex has signalled
+        [[nodiscard]]
+        bool hasDepth(size_t frameIndex) const;
+
+        [[nodiscard]]
+        uint64_t getFrameNumber(size_t frameIndex) const;
+
+        [[nodiscard]]
+        const glm::mat4 &getViewProjection(size_t frameIndex) const;
+
+        // the render scale can change between frames, so each copy has its own extent
+        [[nodiscard]]
+        vk::Extent2D getExtent(size_t frameIndex) const;
+
+        // where frameIndex's copy lands, the caller makes the write visible to the host
+        [[nodiscard]]
+        vk::Buffer getBuffer(size_t frameIndex) const;
+
+        // converts the copy to [0, 1] floats whatever the depth format is
+        void readDepth(size_t frameIndex, std::vector<float> &depth) const;
+
+        // throws away any copies in flight, the device must be idle
+        void resize(vk::Extent2D newMaxExtent);
+
+    private:
+        struct FrameCopy {
+            vkr::Buffer buffer;
+            vkr::DeviceMemory memory;
+            const void *mappedMemory;
+            bool hasDepth;
+            uint64_t frameNumber;
+            glm::mat4 viewProjection;
+            vk::Extent2D extent;
+        };
+
+        vkr::Device &device;
+        vkr::PhysicalDevice &physicalDevice;
+        size_t framesInFlight;
+        vk::Extent2D maxExtent;
+        vk::Format depthFormat;
+        std::vector<FrameCopy> frameCopies;
+
+        std::vector<FrameCopy> createFrameCopies();
+    };
+}
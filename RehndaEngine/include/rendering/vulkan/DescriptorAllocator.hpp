@@ -0,0 +1,106 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+
+namespace Rehnda {
+    struct DescriptorAllocatorProps {
+        // descriptors of each type per set, a pool holds this many times its set count
+        std::vector<std::pair<vk::DescriptorType, float>> descriptorsPerSet = {
+                {vk::DescriptorType::eUniformBuffer,        2.f},
+                {vk::DescriptorType::eStorageBuffer,        4.f},
+                {vk::DescriptorType::eCombinedImageSampler, 4.f},
+                {vk::DescriptorType::eSampledImage,         2.f},
+                {vk::DescriptorType::eStorageImage,         1.f},
+                {vk::DescriptorType::eSampler,              1.f},
+        };
+        uint32_t initialSetsPerPool = 16;
+        // each new pool is twice the size of the last, up to this
+        uint32_t maxSetsPerPool = 4096;
+    };
+
+    /**
+     * Hands out descriptor sets from a list of pools, starting a bigger pool whenever the current one runs out so there's
+     * no fixed ceiling on how many sets get allocated. Sets are never freed, they all live as long as the allocator, which
+     * suits sets that are written once and reused every frame like DescriptorSetCache's.
+     */
+    class DescriptorAllocator {
+    public:
+        explicit DescriptorAllocator(vkr::Device &device, DescriptorAllocatorProps props = {});
+
+        DescriptorAllocator(const DescriptorAllocator &) = delete;
+
+        DescriptorAllocator(DescriptorAllocator &&) = default;
+
+        // the set lives until the allocator is destroyed
+        vk::DescriptorSet allocate(vk::DescriptorSetLayout layout);
+
+    private:
+        vkr::Device &device;
+        DescriptorAllocatorProps props;
+        uint32_t setsPerPool;
+
+        std::optional<vkr::DescriptorPool> currentPool;
+        // ran out of space, kept alive for the sets allocated from them
+        std::vector<vkr::DescriptorPool> fullPools;
+
+        vkr::DescriptorPool createPool();
+    };
+
+    // a single descriptor of a set, either a buffer or an image depending on its type
+    struct DescriptorWrite {
+        uint32_t binding;
+        vk::DescriptorType type;
+        vk::DescriptorBufferInfo bufferInfo{};
+        vk::DescriptorImageInfo imageInfo{};
+
+        bool operator==(const DescriptorWrite &) const = default;
+    };
+
+    namespace DescriptorWrites {
+        // writes all of the descriptors into an already allocated set
+        void update(vkr::Device &device, vk::DescriptorSet set, std::span<const DescriptorWrite> writes);
+    }
+
+    /**
+     * Sets whose contents never change after they're written, e.g. a material's textures, looked up by their layout and
+     * the descriptors in them. Asking for the same combination again returns the set written the first time instead of
+     * allocating and writing another.
+     *
+     * The resources referenced have to outlive the cache.
+     */
+    class DescriptorSetCache {
+    public:
+        explicit DescriptorSetCache(vkr::Device &device, DescriptorAllocatorProps props = {});
+
+        vk::DescriptorSet get(vk::DescriptorSetLayout layout, std::span<const DescriptorWrite> writes);
+
+        [[nodiscard]]
+        size_t size() const;
+
+    private:
+        struct Key {
+            vk::DescriptorSetLayout layout;
+            std::vector<DescriptorWrite> writes;
+
+            bool operator==(const Key &) const = default;
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key &key) const;
+        };
+
+        vkr::Device &device;
+        DescriptorAllocator allocator;
+        std::unordered_map<Key, vk::DescriptorSet, KeyHash> sets;
+    };
+}
@@ -7,14 +7,35 @@
 
 
 #include "rendering/vulkan/VkTypes.hpp"
-#include <GLFW/glfw3.h>
+#include <atomic>
+#include <filesystem>
+#include <limits>
+#include <optional>
 
 #include "VkTypes.hpp"
-#include "SwapchainManager.hpp"
+#include "FrameOutput.hpp"
 #include "GraphicsPipeline.hpp"
 #include "TextureImage.hpp"
 #include "TextureSampler.hpp"
 #include "DepthImage.hpp"
+#include "DepthReadback.hpp"
+#include "GpuTimer.hpp"
+#include "RenderTarget.hpp"
+#include "ClusteredLighting.hpp"
+#include "RenderGraph.hpp"
+#include "UploadQueue.hpp"
+#include "DescriptorAllocator.hpp"
+#include "BindlessResources.hpp"
+#include "PipelineLayoutCache.hpp"
+#include "ShaderLibrary.hpp"
+#include "ShaderReflection.hpp"
+#include "rendering/DynamicResolution.hpp"
+#include "rendering/HiZPyramid.hpp"
+#include "rendering/MVPTransforms.hpp"
+#include "rendering/RenderCommandStream.hpp"
+#include "scene/TransformStore.hpp"
+#include "scene/SceneCuller.hpp"
+#include "core/JobSystem.hpp"
 
 
 namespace Rehnda {
@@ -23,66 +44,210 @@ namespace Rehnda {
         SWAPCHAIN_OUT_OF_DATE,
     };
 
+    // what the coordinator builds the scene from until there's a proper scene format. Every object draws the same mesh, laid
+    // out on a grid, textures are all decoded from the same image and materials pick their textures round robin
+    struct SceneProps {
+        uint32_t meshCount = 1;
+        uint32_t textureCount = 1;
+        uint32_t materialCount = 1;
+        // OBJ or glTF file every object draws, imported through the mesh cache. Empty draws the built in quads
+        std::filesystem::path meshPath{};
+    };
+
+    // what the last drawn frame did, for benchmarks and overlays
+    struct FrameStats {
+        uint64_t frameNumber = 0;
+        // after frustum and occlusion culling, capped at the objects a frame can hold
+        uint32_t visibleObjects = 0;
+        // across every subpass, after LOD and meshlet culling
+        uint32_t drawCalls = 0;
+        // unsmoothed timed GPU work of the newest frame the GPU has finished, frames in flight behind this one.
+        // Empty without timestamp support
+        std::optional<double> gpuMilliseconds;
+    };
+
+    struct FrameCoordinatorProps {
+        // keeps each frame's depth and culls objects hidden behind it a frame or two later, worth it in dense interiors
+        bool occlusionCulling = false;
+        // lays down depth with a position only pass first so the main pass shades each pixel once, a win when overdraw
+        // costs more than transforming the geometry twice. Can be flipped at runtime with setDepthPrePass
+        bool depthPrePass = false;
+        // light culling runs on the compute only queue family when the device has one, overlapping the start of the
+        // frame's graphics work instead of running in front of it
+        bool asyncCompute = true;
+        // the scene renders offscreen at a scale picked to hold a GPU frame time, then is upscaled to the swapchain
+        DynamicResolutionProps dynamicResolution{};
+        ClusteredLightingProps clusteredLighting{};
+        // shade with the binned point lights, off leaves albedo and ambient only. Specialized into the shader rather than
+        // branched on per fragment
+        bool clusteredShading = true;
+        ShaderLibraryProps shaders{};
+        SceneProps scene{};
+    };
+
     class FrameCoordinator {
     public:
-        FrameCoordinator(GLFWwindow *window, vkr::Device &device, vkr::PhysicalDevice &physicalDevice,
-                         vkr::SurfaceKHR &surface,
-                         QueueFamilyIndices queueFamilyIndices);
+        // output has to outlive the coordinator
+        FrameCoordinator(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, QueueFamilyIndices queueFamilyIndices,
+                         JobSystem &jobSystem, FrameOutput &output, FrameCoordinatorProps props = {});
+
+        // commands are applied before drawing and not kept, the stream can be reused as soon as this returns
+        DrawFrameResult drawFrame(const RenderCommandStream &commands);
+
+        // these can be called from any thread, e.g. the main thread handling input while another thread draws
+
+        // the new size is only read when the output is recreated on the drawing thread, which waits while it's 0
+        void setFramebufferResized(vk::Extent2D framebufferExtent);
+
+        // takes effect from the next recorded frame, nothing needs recreating
+        void setDepthPrePass(bool enabled);
 
-        DrawFrameResult drawFrame();
+        [[nodiscard]]
+        bool isDepthPrePassEnabled() const;
 
-        void setFramebufferResized();
+        // only from the drawing thread
+        [[nodiscard]]
+        const FrameStats &getFrameStats() const;
 
     private:
         const size_t MAX_FRAMES_IN_FLIGHT = 2;
+        static constexpr float Z_NEAR = 0.1f;
+        static constexpr float Z_FAR = 10.f;
+        // visible draws past this in a frame are dropped
+        static constexpr uint32_t MAX_OBJECTS = 4096;
+        static constexpr uint32_t OBJECTS_BINDING = 1;
         size_t currentFrame = 0;
-        bool framebufferResized = false;
+        // total frames drawn, unlike currentFrame which cycles through the frames in flight
+        uint64_t frameNumber = 0;
+        std::atomic<bool> framebufferResized = false;
+        // width in the high 32 bits and height in the low, so both are always read from the same resize
+        std::atomic<uint64_t> framebufferExtent = 0;
+        FrameCoordinatorProps props;
+        // props.depthPrePass is what the frame being recorded uses, this is what it's been asked to be from now on
+        std::atomic<bool> requestedDepthPrePass;
 
         vkr::Device &device;
         vkr::PhysicalDevice &physicalDevice;
         QueueFamilyIndices queueFamilyIndices;
-        SwapChainSupportDetails swapChainSupportDetails;
+        JobSystem &jobSystem;
+        FrameOutput &output;
+        AssetLoader assetLoader;
+        // outlives the pipelines, which stop watching it when they're destroyed
+        ShaderLibrary shaderLibrary;
 
         vkr::Queue graphicsQueue;
-        vkr::Queue presentQueue;
         vkr::CommandPool graphicsCommandPool;
-        vkr::CommandPool memoryCommandPool;
         std::vector<vkr::CommandBuffer> commandBuffers;
+        UploadQueue uploadQueue;
+
+        // only used with async compute, otherwise light culling is recorded into the graphics command buffer
+        bool asyncCompute;
+        vkr::Queue computeQueue;
+        // not created at all without it
+        std::optional<vkr::CommandPool> computeCommandPool;
+        std::vector<vkr::CommandBuffer> computeCommandBuffers;
 
         std::vector<vkr::Semaphore> imageAvailableSemaphores;
         std::vector<vkr::Semaphore> renderFinishedSemaphores;
+        std::vector<vkr::Semaphore> lightCullingFinishedSemaphores;
         std::vector<vkr::Fence> inFlightFences;
+        GpuTimer gpuTimer;
 
         // UBOs
         std::vector<WritableDirectBuffer> uboBuffers;
-        vkr::DescriptorSetLayout descriptorSetLayout;
-        vkr::DescriptorPool descriptorPool;
-        vkr::DescriptorSets descriptorSets;
+        // a record per visible draw, indexed by the draw's first instance
+        std::vector<WritableDirectBuffer> objectBuffers;
+        std::vector<ObjectRecord> objectRecords;
+        // every set and pipeline layout is built from the reflection of the shaders below
+        PipelineLayoutCache layoutCache;
+        // every shader binding the frame or bindless sets, so each set's layout has all the stages that use it
+        ShaderReflection frameShaders;
+        // set 0, the per frame transforms, objects and lighting. Each frame in flight always points at the same buffers, so
+        // its set is written the first time and looked up from the cache after that
+        vk::DescriptorSetLayout frameSetLayout;
+        DescriptorSetCache frameSetCache;
+        vk::DescriptorSet frameDescriptorSet{};
+        // set 1, every texture and material, bound once for the whole frame
+        std::unique_ptr<BindlessResources> bindless;
+        // object h is drawn with materials[h % size]
+        std::vector<uint32_t> materials;
 
-        std::unique_ptr<SwapchainManager> swapchainManager;
         std::unique_ptr<GraphicsPipeline> graphicsPipeline;
+        // the specialization constants the scene is drawn with, prepared along with the pipeline
+        ShaderPermutation shadingPermutation;
 
         // tempsdf
-        std::unique_ptr<DepthImage> depthImage;
+        std::unique_ptr<RenderTarget> renderTarget;
         std::unique_ptr<RenderableMesh> mesh;
-        std::unique_ptr<TextureImage> textureImage;
+        std::vector<std::unique_ptr<TextureImage>> textureImages;
         std::unique_ptr<TextureSampler> textureSampler;
+
+        TransformStore transformStore;
+        SceneCuller sceneCuller;
+        std::vector<MeshDraw> meshDraws;
+        // LOD each object was last drawn at, indexed by transform
+        std::vector<uint32_t> objectLods;
+        DynamicResolution dynamicResolution;
+
+        std::unique_ptr<ClusteredLighting> clusteredLighting;
+        // the scene as of the last commands applied
+        std::vector<PointLight> lights;
+        RenderCamera camera{.view = glm::mat4(1.f), .fovY = glm::radians(45.f)};
+
+        // the frame's passes, declared once at startup. The pass callbacks read the per frame state below
+        std::unique_ptr<RenderGraph> renderGraph;
+        RenderGraphImage sceneColorImage{};
+        RenderGraphImage sceneDepthImage{};
+        RenderGraphImage outputImage{};
+        RenderGraphBuffer clusterLightCountsBuffer{};
+        RenderGraphBuffer clusterLightIndicesBuffer{};
+        RenderGraphBuffer depthReadbackBuffer{};
+        vk::Extent2D renderExtent{};
+        MVPTransforms frameTransforms{};
+        FrameStats frameStats{};
+
+        // only created with occlusion culling on
+        std::unique_ptr<DepthReadback> depthReadback;
+        std::vector<float> readbackDepth;
+        HiZPyramid hiZPyramid;
+        uint64_t hiZFrameNumber = std::numeric_limits<uint64_t>::max();
     private:
-        vkr::CommandPool createCommandPool(vk::CommandPoolCreateFlags commandPoolCreateFlags);
+        vkr::CommandPool createCommandPool(vk::CommandPoolCreateFlags commandPoolCreateFlags, uint32_t queueFamilyIndex);
 
         std::vector<vkr::Semaphore> createSemaphores(size_t numToCreate);
         std::vector<vkr::Fence> createFences(size_t numToCreate);
 
-        vkr::CommandBuffers createCommandBuffers();
+        vkr::CommandBuffers createCommandBuffers(vkr::CommandPool &commandPool);
+
+        // a transform per mesh in a grid around the origin, registered with the culler
+        void createSceneTransforms(const Aabb &meshBounds);
 
-        vkr::DescriptorSetLayout createDescriptorSetLayout();
+        ShaderReflection reflectFrameShaders();
 
         std::vector<WritableDirectBuffer> createUbos();
 
-        vkr::DescriptorPool createDescriptorPool();
+        std::vector<WritableDirectBuffer> createObjectBuffers();
+
+        // set 0 for the current frame in flight, pointing at its buffers
+        void writeFrameDescriptorSet();
+
+        void applyCommands(const RenderCommandStream &commands);
+
+        MVPTransforms updateUniformBuffer(uint32_t currentImage);
+
+        // submits this frame's light culling to the compute queue, the graphics submit waits on it before shading
+        void submitAsyncLightCulling(std::vector<vk::Semaphore> &waitSemaphores, std::vector<vk::PipelineStageFlags> &waitStages);
+
+        void buildRenderGraph();
+
+        // points the graph at the render target's color and builds the framebuffer around the graph's depth, again whenever
+        // either is recreated
+        void importRenderTarget();
 
-        vkr::DescriptorSets createDescriptorSets();
+        // periodically logs the smoothed GPU timings alongside the pass configuration they were measured with
+        void reportGpuTimings();
 
-        void updateUniformBuffer(uint32_t currentImage);
+        // rebuilds the Hi-Z pyramid from the newest depth readback the GPU has finished
+        void updateHiZPyramid();
     };
 }
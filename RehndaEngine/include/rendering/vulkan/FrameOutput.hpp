@@ -0,0 +1,52 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+
+namespace Rehnda {
+    enum class PresentResult {
+        SUCCESS,
+        SWAPCHAIN_OUT_OF_DATE,
+    };
+
+    /**
+     * Where finished frames end up, the window's swapchain or, when running headless, images nobody looks at. The scene
+     * is rendered offscreen either way and blitted into the output's image as the frame's last pass.
+     */
+    class FrameOutput {
+    public:
+        virtual ~FrameOutput() = default;
+
+        // eErrorOutOfDateKHR when the output has to be resized before it can be drawn to. Presented outputs signal
+        // imageAvailableSemaphore once the image is ready
+        virtual std::pair<vk::Result, uint32_t> acquireNextImageIndex(vkr::Semaphore &imageAvailableSemaphore) = 0;
+
+        virtual PresentResult present(const std::vector<vk::Semaphore> &waitSemaphores, uint32_t imageIndex) = 0;
+
+        // framebufferExtent is the window's size in pixels as last reported to the main thread, outputs never ask the
+        // window themselves since this is called from the drawing thread. Never 0 in either dimension
+        virtual void resize(vk::Extent2D framebufferExtent) = 0;
+
+        [[nodiscard]]
+        virtual vk::Extent2D getExtent() const = 0;
+
+        [[nodiscard]]
+        virtual vk::Format getFormat() const = 0;
+
+        // only ever a transfer destination, nothing renders into it directly
+        [[nodiscard]]
+        virtual vk::Image getImage(size_t imageIndex) const = 0;
+
+        // false for outputs that never reach a presentation engine. Their images are ready as soon as they're acquired and
+        // there's nothing to wait on before presenting, the frame's fence covers reusing them
+        [[nodiscard]]
+        virtual bool isPresented() const = 0;
+    };
+}
@@ -0,0 +1,73 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+
+namespace Rehnda {
+    struct GpuTimerScope {
+        // scope names are expected to be string literals, they're stored as views
+        std::string_view name;
+        // exponentially smoothed so a single slow frame doesn't dominate what gets reported
+        double milliseconds;
+    };
+
+    /**
+     * GPU side timings from timestamp queries, one query pool per frame in flight. Results are read once the frame's fence
+     * has signalled so collecting never stalls. Devices without graphics queue timestamps get a timer that does nothing.
+     */
+    class GpuTimer {
+    public:
+        GpuTimer(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, uint32_t queueFamilyIndex, size_t framesInFlight);
+
+        // resets this frame's queries, must be recorded outside of a render pass
+        void beginFrame(vkr::CommandBuffer &commandBuffer, size_t frameIndex);
+
+        // scopes can't nest, but may be inside a render pass
+        void beginScope(vkr::CommandBuffer &commandBuffer, std::string_view name);
+
+        void endScope(vkr::CommandBuffer &commandBuffer);
+
+        // reads the timestamps the frame's last submission wrote, call after waiting for that frame's fence
+        void collect(size_t frameIndex);
+
+        [[nodiscard]]
+        std::span<const GpuTimerScope> getScopes() const;
+
+        // sum of the smoothed scopes, i.e. the GPU time of everything that's timed in a frame
+        [[nodiscard]]
+        double getTotalMilliseconds() const;
+
+        // the same sum unsmoothed, for the last frame collected
+        [[nodiscard]]
+        double getLastFrameMilliseconds() const;
+
+        [[nodiscard]]
+        bool isSupported() const;
+
+    private:
+        static constexpr uint32_t MAX_SCOPES = 16;
+
+        struct FrameQueries {
+            vkr::QueryPool queryPool;
+            std::vector<std::string_view> scopeNames;
+        };
+
+        vkr::Device &device;
+        bool supported;
+        // nanoseconds per timestamp tick
+        float timestampPeriod;
+        std::vector<FrameQueries> frameQueries;
+        size_t recordingFrame = 0;
+        std::vector<GpuTimerScope> scopes;
+        double lastFrameMilliseconds = 0.0;
+
+        std::vector<FrameQueries> createFrameQueries(size_t framesInFlight);
+    };
+}
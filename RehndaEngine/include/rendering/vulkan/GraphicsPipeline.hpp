@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
 
 #include "rendering/vulkan/VkTypes.hpp"
 #include "core/CoreTypes.hpp"
@@ -11,38 +15,116 @@
 #include "StagedBuffer.hpp"
 #include "rendering/RenderableMesh.hpp"
 #include "WritableDirectBuffer.hpp"
+#include "rendering/VertexLayout.hpp"
+#include "rendering/vulkan/GpuTimer.hpp"
+#include "rendering/vulkan/PipelineLayoutCache.hpp"
+#include "rendering/vulkan/PipelineReload.hpp"
+#include "rendering/vulkan/ShaderLibrary.hpp"
+#include "rendering/vulkan/ShaderPermutation.hpp"
 
 namespace Rehnda {
+    enum class PipelineVariant {
+        // position only, no fragment shader, lays down depth in the first subpass
+        DEPTH_PRE_PASS,
+        // shades and writes depth, used when there's no pre-pass
+        MAIN,
+        // shades only fragments that won the pre-pass, depth is tested for equality and not written
+        MAIN_AFTER_PRE_PASS,
+    };
+
+    /**
+     * The scene's render pass and its pipelines. Pipelines are built per variant and per shader permutation, a set of
+     * specialization constants, so a feature switched off or a count fixed ahead of time compiles out of the shaders instead
+     * of being branched on per fragment.
+     */
     class GraphicsPipeline {
     public:
-        explicit GraphicsPipeline(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, vk::Format imageFormat,
-                                  RenderableMesh &renderableMesh,
-                                  vkr::DescriptorSetLayout &descriptorSetLayout);
+        // constant_ids in triangle.frag
+        // false shades with albedo and ambient only, skipping the cluster's lights
+        static constexpr uint32_t CLUSTERED_LIGHTING_CONSTANT = 0;
+        // the cluster light index stride, must match ClusteredLightingProps::maxLightsPerCluster
+        static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER_CONSTANT = 1;
+
+        // setLayouts must cover every set the shaders use, and the vertex layout every location they read, both are checked
+        // against the shaders' reflection. framesInFlight is how long pipelines replaced by a hot reload are kept alive
+        explicit GraphicsPipeline(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, ShaderLibrary &shaderLibrary, vk::Format imageFormat,
+                                  const VertexInputDescription &vertexInput, PipelineLayoutCache &layoutCache,
+                                  std::span<const vk::DescriptorSetLayout> setLayouts, size_t framesInFlight, bool retainDepth = false);
+
+        GraphicsPipeline(const GraphicsPipeline &) = delete;
 
-        void recordCommandBuffer(vkr::CommandBuffer &commandBuffer, vkr::Framebuffer &targetFramebuffer,
-                                 vkr::DescriptorSet &currentDescriptorSet, vk::Extent2D extent);
+        // swaps in pipelines rebuilt after a shader was saved, call before recording frameNumber
+        void applyReload(uint64_t frameNumber);
+
+        // builds every variant for the permutation now, rather than stalling the first frame that draws with it
+        void preparePermutation(const ShaderPermutation &permutation);
+
+        // records the render pass into an already begun command buffer, the depth pre-pass subpass is left empty unless depthPrePass is set.
+        // extent is the area rendered, which can be smaller than the framebuffer
+        // descriptorSets are bound from set 0 in order, matching the set layouts the pipeline was created with.
+        // Returns the draw calls recorded across both subpasses
+        uint32_t recordRenderPass(vkr::CommandBuffer &commandBuffer, vkr::Framebuffer &targetFramebuffer,
+                              std::span<const vk::DescriptorSet> descriptorSets, vk::Extent2D extent,
+                              std::span<const MeshDraw> meshDraws, const ShaderPermutation &permutation, bool depthPrePass,
+                              GpuTimer &gpuTimer);
 
         [[nodiscard]]
         const vkr::RenderPass &getRenderPass() const;
 
     private:
+        struct PipelineKey {
+            PipelineVariant variant;
+            ShaderPermutation permutation;
+
+            bool operator==(const PipelineKey &) const = default;
+        };
+
+        struct PipelineKeyHash {
+            size_t operator()(const PipelineKey &key) const;
+        };
+
+        // every variant of every permutation prepared so far, rebuilt together on a reload since they share shaders
+        using Pipelines = std::unordered_map<PipelineKey, vkr::Pipeline, PipelineKeyHash>;
+
         vkr::Device &device;
         vkr::PhysicalDevice &physicalDevice;
+        ShaderLibrary &shaderLibrary;
+        PipelineLayoutCache &layoutCache;
+        // kept for rebuilding on a reload
+        VertexInputDescription vertexInput;
+        std::vector<vk::DescriptorSetLayout> setLayouts;
 
         vkr::RenderPass renderPass;
-        vkr::PipelineLayout pipelineLayout;
-        vkr::Pipeline pipeline;
-
-        // temp variables
-        RenderableMesh &mesh;
+        // owned by the cache
+        vk::PipelineLayout pipelineLayout;
+        Pipelines pipelines;
+        // what the watcher thread rebuilds on a reload
+        std::mutex permutationsMutex;
+        std::vector<ShaderPermutation> permutations;
+        PipelineReload<Pipelines> reload;
+        // last, so the watcher can't call back into a half destroyed pipeline
+        ShaderLibrary::Watch shaderWatch;
 
     private:
-        vkr::ShaderModule createShaderModule(const std::vector<char> &code);
+        vkr::ShaderModule createShaderModule(std::span<const uint32_t> code);
+
+        // subpass 0 is the depth only pre-pass, subpass 1 shades
+        // with retainDepth the depth attachment is stored at the end of the pass so it can be copied out afterwards
+        vkr::RenderPass createRenderPass(vk::Format imageFormat, bool retainDepth);
+
+        vk::PipelineLayout createPipelineLayout();
+
+        Pipelines createPipelines(std::span<const ShaderPermutation> pipelinePermutations);
+
+        vkr::Pipeline createPipeline(PipelineVariant variant, const ShaderPermutation &permutation);
 
-        vkr::RenderPass createRenderPass(vk::Format imageFormat);
+        // recording thread, prepares the permutation if it hasn't been
+        vkr::Pipeline &getPipeline(PipelineVariant variant, const ShaderPermutation &permutation);
 
-        vkr::PipelineLayout createPipelineLayout(vkr::DescriptorSetLayout &descriptorSetLayout);
+        // watcher thread, compiles and builds replacements and offers them to the recording thread
+        void rebuild();
 
-        vkr::Pipeline createPipeline();
+        uint32_t drawMeshes(vkr::CommandBuffer &commandBuffer, std::span<const vk::DescriptorSet> descriptorSets, vk::Extent2D extent,
+                            vkr::Pipeline &drawPipeline, std::span<const MeshDraw> meshDraws);
     };
 }
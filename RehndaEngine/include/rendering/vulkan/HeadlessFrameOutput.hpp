@@ -0,0 +1,54 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "rendering/vulkan/FrameOutput.hpp"
+#include "rendering/vulkan/Image.hpp"
+
+namespace Rehnda {
+    struct HeadlessFrameOutputProps {
+        vk::Extent2D extent{1280, 720};
+        // one per frame in flight is enough, the frame's fence has to be waited on before its image comes round again
+        size_t imageCount = 2;
+    };
+
+    /**
+     * Frames rendered into plain images instead of a swapchain, for running without a window or a presentation engine,
+     * e.g. benchmarks on CI under lavapipe. The extent is fixed, so it's never out of date.
+     */
+    class HeadlessFrameOutput : public FrameOutput {
+    public:
+        HeadlessFrameOutput(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, HeadlessFrameOutputProps props = {});
+
+        std::pair<vk::Result, uint32_t> acquireNextImageIndex(vkr::Semaphore &imageAvailableSemaphore) override;
+
+        PresentResult present(const std::vector<vk::Semaphore> &waitSemaphores, uint32_t imageIndex) override;
+
+        void resize(vk::Extent2D framebufferExtent) override;
+
+        [[nodiscard]]
+        vk::Extent2D getExtent() const override;
+
+        [[nodiscard]]
+        vk::Format getFormat() const override;
+
+        [[nodiscard]]
+        vk::Image getImage(size_t imageIndex) const override;
+
+        [[nodiscard]]
+        bool isPresented() const override;
+
+    private:
+        HeadlessFrameOutputProps props;
+        vk::Format format;
+        std::vector<std::unique_ptr<Image>> images;
+        uint32_t nextImageIndex = 0;
+
+        static vk::Format chooseFormat(const vkr::PhysicalDevice &physicalDevice);
+    };
+}
@@ -6,6 +6,7 @@
 
 #include <filesystem>
 #include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/vulkan/ResourceUsage.hpp"
 
 namespace Rehnda {
     struct ImageProps {
@@ -28,7 +29,8 @@ namespace Rehnda {
         [[nodiscard]]
         const vkr::Image & getImage() const;
 
-        void transitionImageLayout(vkr::Queue &queue, vkr::CommandPool &commandPool, vk::ImageLayout oldLayout, vk::ImageLayout newLayout) const;
+        // records the barrier into commandBuffer, any pair of usages works. Per frame transitions belong in the render graph
+        void recordTransition(vkr::CommandBuffer &commandBuffer, ImageUsage oldUsage, ImageUsage newUsage) const;
 
         static vk::Format findSupportedFormat(const vkr::PhysicalDevice& physicalDevice, const std::vector<vk::Format>& candidates, vk::ImageTiling tiling, vk::FormatFeatureFlags features);
 
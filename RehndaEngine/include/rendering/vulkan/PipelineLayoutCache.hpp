@@ -0,0 +1,83 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/vulkan/ShaderReflection.hpp"
+
+namespace Rehnda {
+    struct DescriptorSetLayoutDesc {
+        // sorted by binding, no immutable samplers
+        std::vector<vk::DescriptorSetLayoutBinding> bindings;
+        // empty, or one per binding
+        std::vector<vk::DescriptorBindingFlags> bindingFlags;
+        vk::DescriptorSetLayoutCreateFlags flags{};
+
+        // a set's bindings as the shaders declare them. Runtime arrays get runtimeArrayCapacity descriptors and are made
+        // partially bound and update after bind, which is what bindless arrays need
+        static DescriptorSetLayoutDesc fromReflection(const ShaderReflection &reflection, uint32_t set,
+                                                      uint32_t runtimeArrayCapacity = 0);
+
+        // throws unless every binding the shaders declare in set is in this layout with the same type and count, so sets
+        // allocated for this layout can be bound for them. Runtime arrays are compared at the count this layout gave them
+        void validateReflection(const ShaderReflection &reflection, uint32_t set) const;
+
+        bool operator==(const DescriptorSetLayoutDesc &) const = default;
+    };
+
+    /**
+     * Owns every descriptor set and pipeline layout, handing back the same one for the same description. Pipelines whose
+     * shaders agree on a set end up with the same layout object, so descriptor sets stay bound across pipeline switches
+     * instead of being rebound for a layout that's only different in name. Safe to call from any thread, pipelines being
+     * hot reloaded look their layouts up from the shader watcher thread.
+     */
+    class PipelineLayoutCache {
+    public:
+        explicit PipelineLayoutCache(vkr::Device &device);
+
+        PipelineLayoutCache(const PipelineLayoutCache &) = delete;
+
+        vk::DescriptorSetLayout getSetLayout(const DescriptorSetLayoutDesc &desc);
+
+        // what a layout from getSetLayout was created from, throws for layouts that didn't come from this cache
+        DescriptorSetLayoutDesc getSetLayoutDesc(vk::DescriptorSetLayout layout);
+
+        vk::PipelineLayout getPipelineLayout(std::span<const vk::DescriptorSetLayout> setLayouts,
+                                             std::span<const vk::PushConstantRange> pushConstantRanges);
+
+        [[nodiscard]]
+        size_t getSetLayoutCount() const;
+
+        [[nodiscard]]
+        size_t getPipelineLayoutCount() const;
+
+    private:
+        struct PipelineLayoutKey {
+            std::vector<vk::DescriptorSetLayout> setLayouts;
+            std::vector<vk::PushConstantRange> pushConstantRanges;
+
+            bool operator==(const PipelineLayoutKey &) const = default;
+        };
+
+        struct SetLayoutHash {
+            size_t operator()(const DescriptorSetLayoutDesc &desc) const;
+        };
+
+        struct PipelineLayoutHash {
+            size_t operator()(const PipelineLayoutKey &key) const;
+        };
+
+        vkr::Device &device;
+        // mutable so the const getters can lock it too, reading a map while another thread inserts is still a race
+        mutable std::mutex mutex;
+        std::unordered_map<DescriptorSetLayoutDesc, vkr::DescriptorSetLayout, SetLayoutHash> setLayouts;
+        std::unordered_map<PipelineLayoutKey, vkr::PipelineLayout, PipelineLayoutHash> pipelineLayouts;
+    };
+}
@@ -0,0 +1,56 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace Rehnda {
+    /**
+     * Hands pipelines rebuilt on the shader library's watcher thread over to the thread recording frames. Building happens
+     * entirely off the recording thread, swapping is a move under a lock, and whatever was swapped out is kept alive until
+     * every frame that could still be using it has finished.
+     */
+    template<typename T>
+    class PipelineReload {
+    public:
+        explicit PipelineReload(size_t framesInFlight) : framesInFlight(framesInFlight) {
+        }
+
+        // watcher thread. Replaces anything offered that hasn't been applied yet
+        void offer(T replacement) {
+            std::lock_guard lock(mutex);
+            pending.emplace(std::move(replacement));
+        }
+
+        // recording thread, before recording frameNumber and after waiting on its frame in flight's fence. True if current
+        // was replaced
+        bool apply(T &current, uint64_t frameNumber) {
+            // frames before frameNumber - framesInFlight are known to be finished
+            while (!retired.empty() && retired.front().first + framesInFlight <= frameNumber) {
+                retired.pop_front();
+            }
+
+            std::lock_guard lock(mutex);
+            if (!pending) {
+                return false;
+            }
+            retired.emplace_back(frameNumber, std::move(current));
+            current = std::move(*pending);
+            pending.reset();
+            return true;
+        }
+
+    private:
+        size_t framesInFlight;
+        std::mutex mutex;
+        std::optional<T> pending;
+        // with the frame number they were replaced on, only touched by the recording thread
+        std::deque<std::pair<uint64_t, T>> retired;
+    };
+}
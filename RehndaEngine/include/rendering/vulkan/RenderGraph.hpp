@@ -0,0 +1,190 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/vulkan/ResourceUsage.hpp"
+#include "rendering/vulkan/AttachmentAllocator.hpp"
+
+namespace Rehnda {
+    struct RenderGraphImage {
+        uint32_t index;
+    };
+
+    struct RenderGraphBuffer {
+        uint32_t index;
+    };
+
+    /**
+     * Declares what a pass touches. A write that isn't also a read discards the previous contents, which lets the graph
+     * transition from an undefined layout.
+     */
+    class RenderPassBuilder {
+    public:
+        void read(RenderGraphImage image, ImageUsage usage);
+
+        void write(RenderGraphImage image, ImageUsage usage);
+
+        // reads the existing contents and writes them, e.g. an attachment loaded rather than cleared
+        void readWrite(RenderGraphImage image, ImageUsage usage);
+
+        void read(RenderGraphBuffer buffer, BufferUsage usage);
+
+        void write(RenderGraphBuffer buffer, BufferUsage usage);
+
+        // never culled, for passes whose results leave the graph some other way
+        void hasSideEffects();
+
+    private:
+        friend class RenderGraph;
+
+        struct ImageUse {
+            uint32_t image;
+            ImageUsage usage;
+            bool reads;
+            bool writes;
+        };
+
+        struct BufferUse {
+            uint32_t buffer;
+            BufferUsage usage;
+            bool writes;
+        };
+
+        std::vector<ImageUse> imageUses;
+        std::vector<BufferUse> bufferUses;
+        bool sideEffects = false;
+    };
+
+    /**
+     * A frame's passes and the resources they read and write. Passes are declared once, compile() culls the ones nothing
+     * depends on and allocates the graph's own images (aliasing any whose lifetimes don't overlap), then execute() records
+     * the live passes each frame with batched barriers and layout transitions worked out from the declared usages.
+     *
+     * Resource state carries over between executes, so the first barrier of a frame waits on however the previous frame
+     * left the resource. Aliased images are tracked per memory block too: the first use of an image after another one has
+     * had its memory waits on everything the previous occupant did and starts from an undefined layout, so aliased images
+     * must be written before they're read.
+     */
+    class RenderGraph {
+    public:
+        using PassCallback = std::function<void(vkr::CommandBuffer &)>;
+
+        RenderGraph(vkr::Device &device, vkr::PhysicalDevice &physicalDevice);
+
+        RenderGraphImage importImage(std::string name, vk::ImageAspectFlags aspect);
+
+        // owned by the graph and allocated at compile, usage flags and lifetimes in description are filled in from the passes
+        RenderGraphImage createImage(std::string name, const AttachmentDescription &description);
+
+        // for images the graph created, takes effect at the next compile
+        void resizeImage(RenderGraphImage image, vk::Extent2D extent);
+
+        RenderGraphBuffer importBuffer(std::string name);
+
+        void addPass(std::string name, const std::function<void(RenderPassBuilder &)> &setup, PassCallback execute);
+
+        // the resource is left in finalUsage at the end of every execute, and keeps the passes producing it alive
+        void markOutput(RenderGraphImage image, ImageUsage finalUsage);
+
+        void markOutput(RenderGraphBuffer buffer, BufferUsage finalUsage);
+
+        // again after created images need resizing, the device must be idle
+        void compile();
+
+        /**
+         * Points an imported image at the image to use from now on. previousAccess is how it was last touched outside the
+         * graph, e.g. the stage a swapchain image's acquire semaphore is waited on.
+         */
+        void setImportedImage(RenderGraphImage image, vk::Image vkImage, ResourceAccess previousAccess = {});
+
+        // buffers are assumed idle when set, e.g. per frame in flight buffers behind a fence
+        void setImportedBuffer(RenderGraphBuffer buffer, vk::Buffer vkBuffer);
+
+        void execute(vkr::CommandBuffer &commandBuffer);
+
+        [[nodiscard]]
+        vk::Image getImage(RenderGraphImage image) const;
+
+        // only for images the graph created
+        [[nodiscard]]
+        const vkr::ImageView &getImageView(RenderGraphImage image) const;
+
+        [[nodiscard]]
+        vk::Buffer getBuffer(RenderGraphBuffer buffer) const;
+
+        [[nodiscard]]
+        bool isPassActive(const std::string &name) const;
+
+    private:
+        // what's happened to a resource since it was last written, to work out what the next use has to wait on
+        struct TrackedState {
+            vk::PipelineStageFlags writeStages;
+            vk::AccessFlags writeAccess;
+            vk::PipelineStageFlags readStages;
+            vk::AccessFlags readAccess;
+            vk::ImageLayout layout;
+        };
+
+        struct ImageResource {
+            std::string name;
+            vk::ImageAspectFlags aspect;
+            vk::Image image;
+            std::optional<AttachmentDescription> createDescription;
+            std::optional<AttachmentHandle> attachment;
+            // shared with every other image in the same block, see AttachmentAllocator::getMemoryBlock
+            std::optional<uint32_t> memoryBlock;
+            std::optional<ImageUsage> finalUsage;
+            TrackedState state;
+        };
+
+        struct BufferResource {
+            std::string name;
+            vk::Buffer buffer;
+            std::optional<BufferUsage> finalUsage;
+            TrackedState state;
+        };
+
+        struct Pass {
+            std::string name;
+            RenderPassBuilder uses;
+            PassCallback execute;
+            bool active;
+        };
+
+        struct Barriers {
+            vk::PipelineStageFlags srcStages;
+            vk::PipelineStageFlags dstStages;
+            std::vector<vk::ImageMemoryBarrier> imageBarriers;
+            std::vector<vk::BufferMemoryBarrier> bufferBarriers;
+        };
+
+        AttachmentAllocator attachmentAllocator;
+        std::vector<ImageResource> images;
+        // per memory block, the image whose contents it last held
+        std::vector<std::optional<uint32_t>> memoryOccupants;
+        std::vector<BufferResource> buffers;
+        std::vector<Pass> passes;
+        bool compiled = false;
+
+        void cullPasses();
+
+        void allocateImages();
+
+        // makes image the occupant of its memory block, inheriting what the previous occupant did as what to wait on
+        void takeOverMemory(uint32_t image);
+
+        void addImageBarrier(Barriers &barriers, ImageResource &resource, ImageUsage usage, bool reads, bool writes);
+
+        void addBufferBarrier(Barriers &barriers, BufferResource &resource, BufferUsage usage, bool writes);
+
+        static void recordBarriers(vkr::CommandBuffer &commandBuffer, Barriers &barriers);
+    };
+}
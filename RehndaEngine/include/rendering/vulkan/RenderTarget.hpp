@@ -0,0 +1,61 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <memory>
+
+#include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/vulkan/AttachmentAllocator.hpp"
+
+namespace Rehnda {
+    struct RenderTargetProps {
+        vk::Format colorFormat;
+        // the allocated size, frames can render into any top left sub-rectangle of it
+        vk::Extent2D extent;
+    };
+
+    /**
+     * Offscreen color the scene renders into before being upscaled to the swapchain image, and the framebuffer pairing it
+     * with the scene depth. Depth is a render graph image, so the graph decides whether it's transient. Allocated once at
+     * the largest render extent so changing the render scale never recreates anything, smaller frames just use less of it.
+     */
+    class RenderTarget {
+    public:
+        RenderTarget(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, const RenderTargetProps &props);
+
+        // the device must be idle. The framebuffer is gone until createFramebuffer is called again
+        void resize(vk::Extent2D extent);
+
+        // depthView has to be at least the target's extent
+        void createFramebuffer(const vkr::RenderPass &renderPass, const vkr::ImageView &depthView);
+
+        // blits the renderExtent region of the color target over the whole of the swapchain image, with the color target in
+        // TransferSrcOptimal and the swapchain image in TransferDstOptimal
+        void recordUpscale(vkr::CommandBuffer &commandBuffer, vk::Extent2D renderExtent, vk::Image swapchainImage,
+                           vk::Extent2D swapchainExtent) const;
+
+        [[nodiscard]]
+        vkr::Framebuffer &getFramebuffer();
+
+        [[nodiscard]]
+        const vkr::Image &getColorImage() const;
+
+        [[nodiscard]]
+        vk::Extent2D getExtent() const;
+
+    private:
+        vkr::Device &device;
+        vkr::PhysicalDevice &physicalDevice;
+        RenderTargetProps props;
+        // linear filtering needs format support, nearest always works
+        vk::Filter upscaleFilter;
+
+        AttachmentAllocator attachmentAllocator;
+        AttachmentHandle colorAttachment = 0;
+        std::unique_ptr<vkr::Framebuffer> framebuffer;
+
+        void createColorAttachment();
+    };
+}
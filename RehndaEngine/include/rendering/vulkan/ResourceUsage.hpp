@@ -0,0 +1,58 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include "rendering/vulkan/VkTypes.hpp"
+
+namespace Rehnda {
+    enum class ImageUsage {
+        // nothing has touched it yet, or its contents are being thrown away
+        UNDEFINED,
+        COLOR_ATTACHMENT,
+        DEPTH_ATTACHMENT,
+        DEPTH_READ_ONLY,
+        SAMPLED_FRAGMENT,
+        SAMPLED_COMPUTE,
+        STORAGE_COMPUTE,
+        TRANSFER_SRC,
+        TRANSFER_DST,
+        PRESENT,
+    };
+
+    enum class BufferUsage {
+        VERTEX,
+        INDEX,
+        UNIFORM,
+        STORAGE_READ_VERTEX,
+        STORAGE_READ_FRAGMENT,
+        STORAGE_READ_COMPUTE,
+        STORAGE_WRITE_COMPUTE,
+        TRANSFER_SRC,
+        TRANSFER_DST,
+        HOST_READ,
+    };
+
+    // where in the pipeline a resource is touched, how, and for images which layout it has to be in
+    struct ResourceAccess {
+        vk::PipelineStageFlags stages = vk::PipelineStageFlagBits::eTopOfPipe;
+        vk::AccessFlags access = vk::AccessFlagBits::eNone;
+        vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+    };
+
+    namespace ResourceUsage {
+        ResourceAccess getAccess(ImageUsage usage);
+
+        ResourceAccess getAccess(BufferUsage usage);
+
+        // just the bits of access that write, which are all a barrier has to make available
+        vk::AccessFlags writeAccess(vk::AccessFlags access);
+
+        // a single barrier moving an image between two usages, for one off transitions outside the render graph
+        vk::ImageMemoryBarrier imageBarrier(vk::Image image, vk::ImageAspectFlags aspect, ImageUsage oldUsage, ImageUsage newUsage);
+
+        void recordImageTransition(vkr::CommandBuffer &commandBuffer, vk::Image image, vk::ImageAspectFlags aspect,
+                                   ImageUsage oldUsage, ImageUsage newUsage);
+    }
+}
@@ -0,0 +1,116 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "assets/AssetLoader.hpp"
+#include "core/FileWatcher.hpp"
+
+namespace Rehnda {
+    // a #define passed to the preprocessor ahead of the source
+    struct ShaderDefine {
+        std::string name;
+        std::string value = "1";
+
+        bool operator==(const ShaderDefine &) const = default;
+    };
+
+    struct ShaderLibraryProps {
+        // GLSL sources, compiled at runtime when they're there. Without them, e.g. a build shipped with only the asset
+        // pack, the SPIR-V compiled at build time is loaded instead
+        std::filesystem::path sourceDirectory = "shaders";
+        // SPIR-V keyed by a hash of the preprocessed source, so across runs only what actually changed is recompiled
+        std::filesystem::path cacheDirectory = "shader-cache";
+        // watch the sources and tell pipelines to rebuild when one is saved
+        bool hotReload = true;
+    };
+
+    /**
+     * Compiles GLSL to SPIR-V in the engine with shaderc, so iterating on a shader doesn't need a rebuild and relaunch.
+     * Sources are preprocessed first and the result hashed, which covers includes and defines, and the SPIR-V is cached on
+     * disk under that hash.
+     *
+     * With hot reload the source directory is watched and anything that asked to watch a source, or a file it includes,
+     * is called back on the watcher thread when it's saved. Pipelines rebuild themselves there and hand the result to the
+     * thread recording frames, see PipelineReload, so a reload never stalls a frame.
+     */
+    class ShaderLibrary {
+    public:
+        // stops its callback when destroyed. Must not be destroyed from inside the callback
+        class Watch {
+        public:
+            Watch() = default;
+
+            ~Watch();
+
+            Watch(Watch &&other) noexcept;
+
+            Watch &operator=(Watch &&other) noexcept;
+
+        private:
+            friend class ShaderLibrary;
+
+            Watch(ShaderLibrary *library, uint64_t id);
+
+            ShaderLibrary *library = nullptr;
+            uint64_t id = 0;
+        };
+
+        explicit ShaderLibrary(const AssetLoader &assetLoader, ShaderLibraryProps props = {});
+
+        ShaderLibrary(const ShaderLibrary &) = delete;
+
+        // name is the source's file name, e.g. "triangle.vert", the stage is picked from the extension. Can be called from
+        // any thread. Throws with the compiler's output if the source doesn't compile
+        std::vector<uint32_t> load(std::string_view name, std::span<const ShaderDefine> defines = {});
+
+        // onChanged is called on the watcher thread whenever one of the sources, or anything they include, is saved.
+        // Does nothing without hot reload
+        [[nodiscard]]
+        Watch watch(std::vector<std::string> names, std::function<void()> onChanged);
+
+    private:
+        static constexpr uint32_t CACHE_VERSION = 1;
+        // first word of every SPIR-V module, cached files that don't start with it aren't used
+        static constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+        struct Listener {
+            std::vector<std::string> names;
+            std::function<void()> onChanged;
+        };
+
+        const AssetLoader &assetLoader;
+        ShaderLibraryProps props;
+
+        // the sources each source has pulled in through #include, so saving a shared file reloads everything using it
+        std::mutex dependenciesMutex;
+        std::unordered_map<std::string, std::set<std::string>> dependencies;
+
+        // held while calling back, so a Watch being destroyed waits for its callback to finish
+        std::mutex listenersMutex;
+        std::unordered_map<uint64_t, Listener> listeners;
+        uint64_t nextListenerId = 0;
+
+        // last, so it's stopped before anything its callback touches is destroyed
+        std::unique_ptr<FileWatcher> fileWatcher;
+
+        std::vector<uint32_t> loadPrecompiled(std::string_view name, std::span<const ShaderDefine> defines) const;
+
+        void onFileChanged(const std::filesystem::path &path);
+
+        void unwatch(uint64_t id);
+    };
+}
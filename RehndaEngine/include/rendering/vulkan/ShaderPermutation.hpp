@@ -0,0 +1,73 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+
+namespace Rehnda {
+    // a 32 bit int, uint, float or bool constant_id in the shader
+    struct SpecializationConstant {
+        uint32_t id;
+        uint32_t value;
+
+        static SpecializationConstant fromFloat(uint32_t id, float value);
+
+        // VkBool32, anything but 0 is true
+        static SpecializationConstant fromBool(uint32_t id, bool value);
+
+        bool operator==(const SpecializationConstant &) const = default;
+    };
+
+    /**
+     * One set of specialization constant values for a shader. The driver compiles the pipeline with them folded in, so a
+     * branch on a feature toggle or a loop bounded by a light count costs nothing at runtime, and one GLSL source covers
+     * every variant. Constants not set keep the default the shader declares.
+     *
+     * Kept sorted by id so permutations compare and hash equal however they were built, pipelines are cached per
+     * permutation.
+     */
+    class ShaderPermutation {
+    public:
+        ShaderPermutation() = default;
+
+        explicit ShaderPermutation(std::span<const SpecializationConstant> constants);
+
+        // replaces any value already set for the id
+        ShaderPermutation &set(SpecializationConstant constant);
+
+        [[nodiscard]]
+        std::span<const SpecializationConstant> getConstants() const;
+
+        bool operator==(const ShaderPermutation &) const = default;
+
+        struct Hash {
+            size_t operator()(const ShaderPermutation &permutation) const;
+        };
+
+    private:
+        std::vector<SpecializationConstant> constants;
+    };
+
+    // the vk::SpecializationInfo for a set of constants, pointing into this so it has to outlive pipeline creation
+    class SpecializationData {
+    public:
+        explicit SpecializationData(std::span<const SpecializationConstant> constants);
+
+        SpecializationData(const SpecializationData &) = delete;
+
+        // null without any constants
+        [[nodiscard]]
+        const vk::SpecializationInfo *getInfo() const;
+
+    private:
+        std::vector<vk::SpecializationMapEntry> mapEntries;
+        std::vector<uint32_t> values;
+        vk::SpecializationInfo info;
+    };
+}
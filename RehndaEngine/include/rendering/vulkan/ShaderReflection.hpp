@@ -0,0 +1,78 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/VertexLayout.hpp"
+
+namespace Rehnda {
+    struct ReflectedBinding {
+        uint32_t set;
+        uint32_t binding;
+        vk::DescriptorType type;
+        // 1 unless the shader declares an array of descriptors
+        uint32_t count;
+        // an unsized array, e.g. the bindless textures, whose real size is up to whoever creates the layout
+        bool runtimeArray;
+        vk::ShaderStageFlags stages;
+    };
+
+    struct ReflectedVertexInput {
+        uint32_t location;
+        // e.g. 3 for a vec3
+        uint32_t componentCount;
+    };
+
+    /**
+     * What a SPIR-V module, or a group of them, expects to be bound: descriptor bindings, push constants and, for vertex
+     * shaders, input locations. Layouts are built from this rather than hand written, so they can't drift from the shaders.
+     */
+    class ShaderReflection {
+    public:
+        static ShaderReflection reflect(std::span<const std::byte> spirv);
+
+        // every shader that shares a layout, e.g. a pipeline's stages or everything binding the frame set. A binding used
+        // by several stages gets all of their stage flags, which they must agree on the type and count of
+        static ShaderReflection merge(std::span<const ShaderReflection> shaders);
+
+        [[nodiscard]]
+        vk::ShaderStageFlags getStages() const;
+
+        // sorted by set, then binding
+        [[nodiscard]]
+        const std::vector<ReflectedBinding> &getBindings() const;
+
+        [[nodiscard]]
+        std::vector<ReflectedBinding> getSetBindings(uint32_t set) const;
+
+        // one past the highest set used, 0 with no descriptors
+        [[nodiscard]]
+        uint32_t getSetCount() const;
+
+        // a single range covering the largest push constant block, visible to every stage that declares one
+        [[nodiscard]]
+        std::vector<vk::PushConstantRange> getPushConstantRanges() const;
+
+        [[nodiscard]]
+        const std::vector<ReflectedVertexInput> &getVertexInputs() const;
+
+        // throws if a vertex shader reads a location the layout doesn't provide. Any components the format is short of are
+        // filled in by the input assembler, so those aren't checked
+        void validateVertexInput(const VertexInputDescription &vertexInput) const;
+
+    private:
+        vk::ShaderStageFlags stages{};
+        std::vector<ReflectedBinding> bindings;
+        uint32_t pushConstantSize = 0;
+        vk::ShaderStageFlags pushConstantStages{};
+        std::vector<ReflectedVertexInput> vertexInputs;
+
+        void sortBindings();
+    };
+}
@@ -7,19 +7,24 @@
 
 
 #include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/vulkan/UploadQueue.hpp"
 #include "rendering/Vertex.hpp"
 #include "core/CoreTypes.hpp"
 
 namespace Rehnda {
     struct StagedBufferProps {
+        // copied into the staging buffer once, so this can point straight into a MappedFile to skip any heap copy
         const void *data;
         vk::DeviceSize dataSize;
         vk::BufferUsageFlags bufferUsageFlags;
+        // how the graphics queue first reads it, which the upload hands it over to
+        BufferUsage firstUsage;
     };
 
     class StagedBuffer {
     public:
-        StagedBuffer(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, vkr::CommandPool &commandPool, vkr::Queue &queue,
+        // the copy is recorded into the upload queue's open batch, the buffer is usable by frames recorded after it's flushed
+        StagedBuffer(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, UploadQueue &uploadQueue,
                      const StagedBufferProps &stagedBufferProps);
 
         StagedBuffer(const StagedBuffer &) = delete;
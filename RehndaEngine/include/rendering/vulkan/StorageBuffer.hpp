@@ -0,0 +1,51 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+
+namespace Rehnda {
+    struct StorageBufferProps {
+        vk::DeviceSize dataSize;
+        // on top of storage and transfer dst, e.g. eIndirectBuffer for draws a compute pass writes
+        vk::BufferUsageFlags additionalUsageFlags{};
+        // see BufferHelper::CreateBufferAndAssignMemoryProps::queueFamilies
+        std::vector<uint32_t> queueFamilies{};
+    };
+
+    /**
+     * Device local memory that only the GPU reads and writes, e.g. compute outputs such as cluster light lists, culled
+     * draw lists or particle state. Use a StagedBuffer for data that starts on the CPU and a WritableDirectBuffer for data
+     * the CPU rewrites every frame.
+     */
+    class StorageBuffer {
+    public:
+        StorageBuffer(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, const StorageBufferProps &props);
+
+        StorageBuffer(const StorageBuffer &) = delete;
+
+        StorageBuffer(StorageBuffer &&) = default;
+
+        // fills the whole buffer with a repeated 32 bit value, e.g. zeroing counters before a pass appends to them.
+        // Call outside a render pass, it's a transfer write as far as barriers go
+        void recordFill(vkr::CommandBuffer &commandBuffer, uint32_t value = 0) const;
+
+        [[nodiscard]]
+        vk::DescriptorBufferInfo getDescriptorInfo() const;
+
+        [[nodiscard]]
+        const vkr::Buffer &getBuffer() const;
+
+        [[nodiscard]]
+        vk::DeviceSize getSize() const;
+
+    private:
+        vk::DeviceSize dataSize;
+        vkr::Buffer buffer;
+        vkr::DeviceMemory bufferMemory;
+    };
+}
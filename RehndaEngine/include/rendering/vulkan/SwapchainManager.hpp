@@ -7,16 +7,15 @@
 
 
 #include "rendering/vulkan/VkTypes.hpp"
-#include <GLFW/glfw3.h>
 #include "core/CoreTypes.hpp"
 #include "VkTypes.hpp"
+#include "FrameOutput.hpp"
 
 
 namespace Rehnda {
     class SwapChainSupportDetails {
     public:
-        SwapChainSupportDetails(GLFWwindow *window, const vkr::PhysicalDevice &physicalDevice,
-                                const vkr::SurfaceKHR &surface);
+        SwapChainSupportDetails(const vkr::PhysicalDevice &physicalDevice, const vkr::SurfaceKHR &surface);
 
         [[nodiscard]]
         vk::SurfaceFormatKHR chooseSwapSurfaceFormat() const;
@@ -24,59 +23,60 @@ namespace Rehnda {
         [[nodiscard]]
         vk::PresentModeKHR chooseSwapPresentMode() const;
 
+        // the surface's own extent where it has one, otherwise the framebuffer size clamped to what the surface allows
         [[nodiscard]]
-        vk::Extent2D chooseSwapExtent() const;
+        vk::Extent2D chooseSwapExtent(vk::Extent2D framebufferExtent) const;
 
-        const vk::SurfaceCapabilitiesKHR capabilities;
+        // the current extent and its limits change with the window, so they're queried again before recreating the swapchain
+        void refreshCapabilities(const vkr::PhysicalDevice &physicalDevice, const vkr::SurfaceKHR &surface);
+
+        vk::SurfaceCapabilitiesKHR capabilities;
         const std::vector<vk::SurfaceFormatKHR> formats;
         const std::vector<vk::PresentModeKHR> presentModes;
-    private:
-        NonOwner<GLFWwindow *> window;
-    };
-
-    enum class PresentResult {
-        SUCCESS,
-        SWAPCHAIN_OUT_OF_DATE,
     };
 
-    class SwapchainManager {
+    class SwapchainManager : public FrameOutput {
     public:
-        SwapchainManager(vkr::Device &device,
-                         const vkr::SurfaceKHR &surface, QueueFamilyIndices, const vkr::RenderPass &renderPass, const vkr::ImageView& depthImageView,
-                         const SwapChainSupportDetails &swapChainSupportDetails);
+        SwapchainManager(vkr::Device &device, const vkr::PhysicalDevice &physicalDevice,
+                         const vkr::SurfaceKHR &surface, QueueFamilyIndices,
+                         SwapChainSupportDetails swapChainSupportDetails, vk::Extent2D framebufferExtent);
 
-        void resize(const vkr::RenderPass &renderPass, const vkr::ImageView& depthImageView);
+        void resize(vk::Extent2D framebufferExtent) override;
 
-        std::pair<vk::Result, uint32_t> acquireNextImageIndex(vkr::Semaphore &imageAvailableSemaphore);
+        std::pair<vk::Result, uint32_t> acquireNextImageIndex(vkr::Semaphore &imageAvailableSemaphore) override;
 
-        PresentResult
-        present(const std::vector<vk::Semaphore> &waitSemaphores, vkr::Queue &presentQueue, uint32_t imageIndex);
+        PresentResult present(const std::vector<vk::Semaphore> &waitSemaphores, uint32_t imageIndex) override;
 
         [[nodiscard]]
-        vk::Extent2D getExtent() const;
+        vk::Extent2D getExtent() const override;
 
         [[nodiscard]]
-        vkr::Framebuffer &getSwapchainFramebuffer(size_t bufferIndex);
+        vk::Format getFormat() const override;
 
+        // the scene is rendered offscreen and blitted into these, nothing renders into them directly
+        [[nodiscard]]
+        vk::Image getImage(size_t imageIndex) const override;
+
+        [[nodiscard]]
+        bool isPresented() const override;
 
     private:
         vkr::Device &device;
+        const vkr::PhysicalDevice &physicalDevice;
         const vkr::SurfaceKHR &surface;
         const QueueFamilyIndices queueFamilyIndices;
-        const SwapChainSupportDetails &swapChainSupportDetails;
+        SwapChainSupportDetails swapChainSupportDetails;
+        vkr::Queue presentQueue;
 
         vk::SurfaceFormatKHR swapchainSurfaceFormat;
         vk::Extent2D swapchainExtent;
         std::unique_ptr<vkr::SwapchainKHR> swapchain;
-        std::vector<vkr::ImageView> swapchainImageViews;
-        std::vector<vkr::Framebuffer> swapchainFramebuffers;
+        std::vector<vk::Image> swapchainImages;
 
 
     private:
-        std::vector<vkr::ImageView> createImageViews();
+        std::vector<vk::Image> getSwapchainImages();
 
         std::unique_ptr<vkr::SwapchainKHR> createSwapchain();
-
-        std::vector<vkr::Framebuffer> createFrameBuffers(const vkr::RenderPass &renderPass, const vkr::ImageView& depthImageView);
     };
 }
\ No newline at end of file
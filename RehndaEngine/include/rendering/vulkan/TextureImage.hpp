@@ -5,14 +5,20 @@
 #pragma once
 
 #include <filesystem>
+#include <span>
 #include "rendering/vulkan/VkTypes.hpp"
 #include "Image.hpp"
+#include "UploadQueue.hpp"
 
 namespace Rehnda {
 
     class TextureImage {
     public:
-        TextureImage(vkr::Device& device, vkr::PhysicalDevice &physicalDevice, vkr::Queue& queue, vkr::CommandPool &commandPool, const std::filesystem::path& pathToTexture);
+        TextureImage(vkr::Device& device, vkr::PhysicalDevice &physicalDevice, UploadQueue &uploadQueue, const std::filesystem::path& pathToTexture);
+
+        // decodes an encoded image (png, jpg etc.) that is already in memory, e.g. a mapped file or a pack entry
+        // the upload goes through uploadQueue, so the image can be sampled by frames recorded after it's next flushed
+        TextureImage(vkr::Device& device, vkr::PhysicalDevice &physicalDevice, UploadQueue &uploadQueue, std::span<const std::byte> encodedImage);
 
         [[nodiscard]]
         const vkr::ImageView &getImageView() const;
@@ -28,9 +34,9 @@ namespace Rehnda {
 
         Image image;
 
-        void* loadImage(const std::filesystem::path &pathToTexture);
+        void* loadImage(std::span<const std::byte> encodedImage);
 
-        void copyBufferToImage(vkr::Buffer& stagingBuffer, vkr::Queue &queue, vkr::CommandPool &commandPool) const;
+        void copyBufferToImage(vkr::CommandBuffer &commandBuffer, const vkr::Buffer &stagingBuffer) const;
     };
 
 } // Rehnda
\ No newline at end of file
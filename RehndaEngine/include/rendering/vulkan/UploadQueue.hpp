@@ -0,0 +1,80 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "rendering/vulkan/VkTypes.hpp"
+#include "rendering/vulkan/ResourceUsage.hpp"
+
+namespace Rehnda {
+    /**
+     * Uploads run on the dedicated transfer queue when the device has one, so streaming assets overlaps the graphics
+     * queue instead of stalling it with a submit and wait per upload.
+     *
+     * Copies are recorded into an open batch, flush() submits it with a semaphore, and the next graphics frame waits on
+     * that semaphore and acquires ownership of everything the batch wrote. Staging buffers are kept until the frame that
+     * acquired them has finished. Without a dedicated family the same flow runs on the graphics family, minus the
+     * ownership transfers.
+     *
+     * Only for the thread recording frames, uploads aren't synchronised.
+     */
+    class UploadQueue {
+    public:
+        UploadQueue(vkr::Device &device, QueueFamilyIndices queueFamilyIndices);
+
+        UploadQueue(const UploadQueue &) = delete;
+
+        // opens a batch if there isn't one, record copies into it
+        vkr::CommandBuffer &getCommandBuffer();
+
+        // kept until the batch it was used in has been consumed by a finished frame
+        void keepAlive(vkr::Buffer &&stagingBuffer, vkr::DeviceMemory &&stagingMemory);
+
+        // call after recording the copies into dst, firstUsage is how the graphics queue first uses it
+        void releaseBuffer(vk::Buffer buffer, BufferUsage firstUsage);
+
+        // moves the image from TRANSFER_DST into firstUsage as part of handing it over
+        void releaseImage(vk::Image image, vk::ImageAspectFlags aspect, ImageUsage firstUsage);
+
+        // submits the open batch, does nothing if nothing has been recorded
+        void flush();
+
+        /**
+         * Records the acquire side of every flushed batch at the start of a graphics frame, and appends the semaphores
+         * the frame's submit has to wait on. The batches are freed once collect() is called for the same frame index.
+         */
+        void recordAcquires(vkr::CommandBuffer &commandBuffer, size_t frameIndex, std::vector<vk::Semaphore> &waitSemaphores,
+                            std::vector<vk::PipelineStageFlags> &waitStages);
+
+        // after waiting on frameIndex's fence, frees the batches that frame acquired
+        void collect(size_t frameIndex);
+
+        [[nodiscard]]
+        bool hasDedicatedQueue() const;
+
+    private:
+        struct Batch {
+            vkr::CommandBuffer commandBuffer;
+            vkr::Semaphore uploaded;
+            std::vector<vk::BufferMemoryBarrier> bufferAcquires;
+            std::vector<vk::ImageMemoryBarrier> imageAcquires;
+            vk::PipelineStageFlags acquireStages;
+            std::vector<std::pair<vkr::Buffer, vkr::DeviceMemory>> stagingBuffers;
+            std::optional<size_t> acquiringFrame;
+        };
+
+        vkr::Device &device;
+        uint32_t transferFamily;
+        uint32_t graphicsFamily;
+        vkr::Queue queue;
+        vkr::CommandPool commandPool;
+
+        std::optional<Batch> openBatch;
+        std::vector<Batch> submittedBatches;
+    };
+}
@@ -7,10 +7,11 @@
 #include "rendering/vulkan/VkTypes.hpp"
 
 namespace Rehnda::VkInstanceHelpers {
-    vkr::Instance buildVulkanInstance(vkr::Context& context, std::vector<const char *> validationLayers);
+    // headless instances skip the surface extensions, so they work without a display or GLFW
+    vkr::Instance buildVulkanInstance(vkr::Context& context, std::vector<const char *> validationLayers, bool windowed = true);
 
     bool are_validation_layers_supported(vkr::Context &context, const std::vector<const char *> &validationLayers);
 
-    std::vector<const char *> get_required_extensions(std::vector<const char *> vector);
+    std::vector<const char *> get_required_extensions(std::vector<const char *> vector, bool windowed = true);
 
 }
@@ -13,11 +13,25 @@ namespace Rehnda {
     struct QueueFamilyIndices {
         std::optional<uint32_t> graphicsQueueIndex;
         std::optional<uint32_t> presentQueueIndex;
+        // families without graphics support, which usually map to separate hardware engines that run alongside graphics
+        std::optional<uint32_t> transferQueueIndex;
+        std::optional<uint32_t> computeQueueIndex;
 
         [[nodiscard]]
         bool requiredFamiliesFound() const {
             return graphicsQueueIndex.has_value() && presentQueueIndex.has_value();
         }
+
+        // where uploads are submitted, falls back to graphics when the device has no dedicated transfer family
+        [[nodiscard]]
+        uint32_t getTransferFamily() const {
+            return transferQueueIndex.value_or(graphicsQueueIndex.value());
+        }
+
+        [[nodiscard]]
+        uint32_t getComputeFamily() const {
+            return computeQueueIndex.value_or(graphicsQueueIndex.value());
+        }
     };
 
     namespace vkr = vk::raii;
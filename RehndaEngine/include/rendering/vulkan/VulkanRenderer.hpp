@@ -7,35 +7,75 @@
 #include "rendering/vulkan/VkTypes.hpp"
 #include <GLFW/glfw3.h>
 #include <optional>
+#include <string>
 #include "FrameCoordinator.hpp"
+#include "FrameOutput.hpp"
 
 namespace Rehnda {
     class VulkanRenderer {
     public:
-        explicit VulkanRenderer(GLFWwindow *window);
+        // the layers slow every call down, so release builds go without them
+#ifdef NDEBUG
+        static constexpr bool VALIDATION_LAYERS_BY_DEFAULT = false;
+#else
+        static constexpr bool VALIDATION_LAYERS_BY_DEFAULT = true;
+#endif
 
-        void drawFrame();
+        VulkanRenderer(GLFWwindow *window, JobSystem &jobSystem, FrameCoordinatorProps frameCoordinatorProps = {});
 
-        void resize();
+        // no window, surface or swapchain, frames are drawn into offscreen images of the given size. Works on devices
+        // without any presentation support such as lavapipe
+        VulkanRenderer(vk::Extent2D headlessExtent, JobSystem &jobSystem, FrameCoordinatorProps frameCoordinatorProps = {},
+                       bool validation = VALIDATION_LAYERS_BY_DEFAULT);
+
+        void drawFrame(const RenderCommandStream &commands);
+
+        // from the main thread's framebuffer size callback, 0 in either dimension while minimized
+        void resize(vk::Extent2D framebufferExtent);
 
         void waitForDeviceIdle();
 
+        void setDepthPrePass(bool enabled);
+
+        [[nodiscard]]
+        bool isDepthPrePassEnabled() const;
+
+        [[nodiscard]]
+        const FrameStats &getFrameStats() const;
+
+        [[nodiscard]]
+        std::string getDeviceName() const;
+
+        // false when they weren't asked for or aren't installed
+        [[nodiscard]]
+        bool areValidationLayersEnabled() const;
+
+        // bytes the process has allocated from device local heaps, empty when the device doesn't support VK_EXT_memory_budget
+        [[nodiscard]]
+        std::optional<vk::DeviceSize> getDeviceMemoryUsage() const;
+
     private:
+        // null when headless
         NonOwner<GLFWwindow*> window;
 
         vkr::Context context;
+        bool enableValidationLayers;
         vkr::Instance instance;
         vkr::DebugUtilsMessengerEXT debugMessenger;
         vkr::SurfaceKHR surface;
         vkr::PhysicalDevice physicalDevice;
         QueueFamilyIndices queueFamilyIndices;
+        bool memoryBudgetEnabled;
         vkr::Device device;
 
+        // outlives the coordinator drawing into it
+        std::unique_ptr<FrameOutput> frameOutput;
         std::unique_ptr<FrameCoordinator> frameCoordinator;
 
-        bool enableValidationLayers;
-
     private:
+        VulkanRenderer(GLFWwindow *window, vk::Extent2D headlessExtent, JobSystem &jobSystem,
+                       FrameCoordinatorProps frameCoordinatorProps, bool validation);
+
         vkr::PhysicalDevice pickPhysicalDevice();
 
         vkr::Device createDevice();
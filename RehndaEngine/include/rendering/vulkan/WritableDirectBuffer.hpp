@@ -6,6 +6,8 @@
 
 
 
+#include <vector>
+
 #include "rendering/vulkan/VkTypes.hpp"
 #include "rendering/Vertex.hpp"
 
@@ -14,6 +16,8 @@ namespace Rehnda {
         vk::DeviceSize dataSize;
         vk::BufferUsageFlags bufferUsageFlags;
         const void *data = nullptr;
+        // see BufferHelper::CreateBufferAndAssignMemoryProps::queueFamilies
+        std::vector<uint32_t> queueFamilies{};
     };
 
     class WritableDirectBuffer {
@@ -23,6 +27,9 @@ namespace Rehnda {
 
         void writeData(const void *data);
 
+        // writes only size bytes from offset, for buffers sized to a capacity that's only partly used
+        void writeData(const void *data, vk::DeviceSize size, vk::DeviceSize offset = 0);
+
         [[nodiscard]]
         const vkr::Buffer &getBuffer() const;
 
@@ -35,7 +42,7 @@ namespace Rehnda {
         vkr::Buffer buffer;
         vkr::DeviceMemory bufferMemory;
 
-        vkr::Buffer initBuffer(vk::BufferUsageFlags bufferUsageFlags);
+        vkr::Buffer initBuffer(vk::BufferUsageFlags bufferUsageFlags, const std::vector<uint32_t> &queueFamilies);
         vkr::DeviceMemory initDeviceMemory();
     };
 }
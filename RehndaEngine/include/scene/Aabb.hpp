@@ -0,0 +1,31 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Rehnda {
+    struct Aabb {
+        glm::vec3 min;
+        glm::vec3 max;
+
+        // inverted so expanding it by anything gives exactly that thing
+        static Aabb empty();
+
+        void expand(glm::vec3 point);
+
+        void expand(const Aabb &other);
+
+        [[nodiscard]]
+        glm::vec3 center() const;
+
+        [[nodiscard]]
+        glm::vec3 halfExtent() const;
+
+        // box around this box after transforming it, computed from the center/extent rather than all 8 corners
+        [[nodiscard]]
+        Aabb transformed(const glm::mat4 &transform) const;
+    };
+}
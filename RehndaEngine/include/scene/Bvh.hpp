@@ -0,0 +1,82 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "rendering/Frustum.hpp"
+#include "scene/Aabb.hpp"
+
+namespace Rehnda {
+    /**
+     * Four wide bounding volume hierarchy for frustum culling. Every node stores its four children's boxes in structure of
+     * arrays form so one SSE compare tests all four against a plane, and children fully inside the frustum have their whole
+     * subtree accepted without any further tests.
+     *
+     * Objects that move are refitted in place, which keeps the tree valid but lets it get looser over time, call build() again
+     * when objects have moved a long way from where they started.
+     */
+    class Bvh {
+    public:
+        // object ids are indices into objectBounds
+        void build(std::span<const Aabb> objectBounds);
+
+        // takes effect on the next refit()
+        void updateObject(uint32_t object, const Aabb &bounds);
+
+        // grows/shrinks the boxes of every node above an updated object, bottom up
+        void refit();
+
+        // appends the ids of objects whose box intersects the frustum
+        void cull(const Frustum &frustum, std::vector<uint32_t> &visibleObjects) const;
+
+        [[nodiscard]]
+        size_t getNodeCount() const;
+
+    private:
+        static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFF;
+        // children with this bit set are object ids rather than node indices
+        static constexpr uint32_t OBJECT_BIT = 0x80000000;
+
+        struct alignas(16) Node {
+            float minX[4];
+            float minY[4];
+            float minZ[4];
+            float maxX[4];
+            float maxY[4];
+            float maxZ[4];
+            uint32_t children[4];
+            uint32_t parent;
+            uint32_t slotInParent;
+            uint32_t validMask;
+        };
+
+        struct ObjectSlot {
+            uint32_t node;
+            uint32_t slot;
+        };
+
+        // children are always created after their parent, so walking nodes backwards visits children before parents
+        std::vector<Node> nodes;
+        std::vector<uint8_t> dirtyNodes;
+        std::vector<ObjectSlot> objectSlots;
+        bool needsRefit = false;
+
+        uint32_t buildNode(std::span<uint32_t> objects, std::span<const Aabb> objectBounds, std::span<const glm::vec3> centroids,
+                           uint32_t parent, uint32_t slotInParent);
+
+        static void setSlotBounds(Node &node, uint32_t slot, const Aabb &bounds);
+
+        [[nodiscard]]
+        static Aabb getNodeBounds(const Node &node);
+
+        // bit i of visibleMask is set when child i touches the frustum, of insideMask when it's entirely inside it
+        static void classifyChildren(const Node &node, const Frustum &frustum, uint32_t &visibleMask, uint32_t &insideMask);
+
+        void appendSubtree(uint32_t node, std::vector<uint32_t> &visibleObjects) const;
+    };
+}
@@ -0,0 +1,56 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "core/JobSystem.hpp"
+#include "rendering/Frustum.hpp"
+#include "rendering/HiZPyramid.hpp"
+#include "scene/Aabb.hpp"
+#include "scene/Bvh.hpp"
+#include "scene/TransformStore.hpp"
+
+namespace Rehnda {
+    /**
+     * Visibility for everything the renderer could draw. Objects are registered against a transform with bounds in that
+     * transform's local space, their world bounds live in a Bvh which is refitted with whatever the TransformStore updated.
+     */
+    class SceneCuller {
+    public:
+        explicit SceneCuller(const TransformStore &transformStore);
+
+        void add(TransformHandle transform, const Aabb &localBounds);
+
+        // call after every TransformStore::updateWorldMatrices(), otherwise moved objects are missed
+        void update();
+
+        // transforms of the objects that intersect the world space frustum and, given a pyramid, aren't hidden behind the
+        // depth it was built from. Valid until the next call. Given a job system the occlusion tests are split over it
+        std::span<const TransformHandle> cull(const Frustum &worldFrustum, const HiZPyramid *occluders = nullptr,
+                                              JobSystem *jobSystem = nullptr);
+
+    private:
+        static constexpr uint32_t NO_OBJECT = 0xFFFFFFFF;
+        // occlusion tests per job, each is a handful of pyramid samples so batches need to be fairly big to be worth it
+        static constexpr size_t OCCLUSION_BATCH_SIZE = 256;
+
+        const TransformStore &transformStore;
+        // indexed by object id, which is what the Bvh works in
+        std::vector<TransformHandle> objectTransforms;
+        std::vector<Aabb> localBounds;
+        std::vector<Aabb> worldBounds;
+        // indexed by transform handle
+        std::vector<uint32_t> transformObjects;
+
+        Bvh bvh;
+        bool needsRebuild = false;
+
+        std::vector<uint32_t> visibleObjects;
+        std::vector<uint8_t> occluded;
+        std::vector<TransformHandle> visibleTransforms;
+    };
+}
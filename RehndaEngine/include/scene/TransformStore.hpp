@@ -0,0 +1,92 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Rehnda {
+    // index into the TransformStore, transforms are never removed so handles stay valid for the store's lifetime
+    using TransformHandle = uint32_t;
+
+    constexpr TransformHandle NO_PARENT = std::numeric_limits<TransformHandle>::max();
+
+    struct TransformProps {
+        glm::vec3 position{0.f};
+        glm::quat rotation{1.f, 0.f, 0.f, 0.f};
+        glm::vec3 scale{1.f};
+        // must already exist, which keeps the store sorted with every parent before its children
+        TransformHandle parent = NO_PARENT;
+    };
+
+    /**
+     * Local transforms for every object in structure of arrays form, so world matrices can be built four at a time with SSE.
+     * Handles are allocated in creation order and a parent has to exist before its children, so a single forward pass over the
+     * arrays is a topological walk: by the time a transform is reached its parent's world matrix is already up to date.
+     *
+     * Setters only mark the transform dirty, updateWorldMatrices() then pushes dirtiness down to children and rebuilds the
+     * world matrices of the changed subtrees only.
+     */
+    class TransformStore {
+    public:
+        TransformHandle create(const TransformProps &props = {});
+
+        void setPosition(TransformHandle handle, glm::vec3 position);
+
+        void setRotation(TransformHandle handle, glm::quat rotation);
+
+        void setScale(TransformHandle handle, glm::vec3 scale);
+
+        [[nodiscard]]
+        glm::vec3 getPosition(TransformHandle handle) const;
+
+        [[nodiscard]]
+        glm::quat getRotation(TransformHandle handle) const;
+
+        [[nodiscard]]
+        glm::vec3 getScale(TransformHandle handle) const;
+
+        [[nodiscard]]
+        TransformHandle getParent(TransformHandle handle) const;
+
+        void updateWorldMatrices();
+
+        // valid as of the last updateWorldMatrices()
+        [[nodiscard]]
+        const glm::mat4 &getWorldMatrix(TransformHandle handle) const;
+
+        [[nodiscard]]
+        std::span<const glm::mat4> getWorldMatrices() const;
+
+        // transforms whose world matrix changed in the last updateWorldMatrices(), in handle order
+        [[nodiscard]]
+        std::span<const TransformHandle> getUpdatedTransforms() const;
+
+        [[nodiscard]]
+        size_t size() const;
+
+    private:
+        size_t count = 0;
+        // all padded up to a multiple of 4 with identity transforms so the SIMD loop never needs a scalar tail
+        std::vector<float> positionX, positionY, positionZ;
+        std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+        std::vector<float> scaleX, scaleY, scaleZ;
+        std::vector<TransformHandle> parents;
+        std::vector<uint8_t> dirty;
+
+        std::vector<glm::mat4> worldMatrices;
+        std::vector<TransformHandle> updatedTransforms;
+
+        void markDirty(TransformHandle handle);
+
+        // writes the local TRS matrices of transforms [first, first + 4)
+        void computeLocalMatrices(size_t first, glm::mat4 *localMatrices) const;
+    };
+}
@@ -5,14 +5,16 @@
 #pragma once
 
 #include <GLFW/glfw3.h>
+#include <atomic>
 #include "rendering/vulkan/VkTypes.hpp"
 #include "core/CoreTypes.hpp"
+#include "core/JobSystem.hpp"
 #include "rendering/vulkan/VulkanRenderer.hpp"
 
 namespace Rehnda::Windowing {
     class Window {
     public:
-        explicit Window(Pixels width, Pixels height);
+        Window(Pixels width, Pixels height, JobSystem &jobSystem);
 
         ~Window();
 
@@ -20,7 +22,8 @@ namespace Rehnda::Windowing {
 
         void pollEvents();
 
-        void resize();
+        // main thread only, from GLFW's framebuffer size callback
+        void resize(int newFramebufferWidth, int newFramebufferHeight);
 
     private:
         Owner<GLFWwindow *> window;
@@ -28,6 +31,10 @@ namespace Rehnda::Windowing {
         Pixels height;
 
         std::unique_ptr<VulkanRenderer> vulkanRenderer;
+        // tracked from the resize callback on the main thread, so rendering from another thread never needs to ask GLFW.
+        // 0 while minimized
+        std::atomic<uint32_t> framebufferWidth = 0;
+        std::atomic<uint32_t> framebufferHeight = 0;
     public:
         [[nodiscard]]
         const VulkanRenderer *getVulkanRenderer() const;
@@ -41,11 +48,14 @@ namespace Rehnda::Windowing {
         [[nodiscard]]
         const Pixels &getHeight() const;
 
-        void render();
+        // safe to call from a thread other than the main one, it only talks to the renderer
+        void render(const RenderCommandStream &commands);
 
         void waitIdle();
 
     private:
         bool isWindowMinimized() const;
+
+        void onKey(int key, int action);
     };
 }
\ No newline at end of file
@@ -0,0 +1,24 @@
+#version 450
+
+// depth only pass, must produce bit identical positions to triangle.vert so the main pass can depth test with equal
+layout(binding = 0) uniform MVPTransforms {
+    mat4 view;
+    mat4 proj;
+} mvp;
+
+struct ObjectRecord {
+    mat4 model;
+    uint materialIndex;
+};
+
+layout(std430, binding = 1) readonly buffer Objects {
+    ObjectRecord objects[];
+};
+
+layout(location = 0) in vec3 inPosition;
+
+invariant gl_Position;
+
+void main() {
+    gl_Position = mvp.proj * mvp.view * objects[gl_InstanceIndex].model * vec4(inPosition, 1.0);
+}
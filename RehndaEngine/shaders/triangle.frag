@@ -1,12 +1,105 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) in vec3 fragWorldPosition;
+layout(location = 3) in float fragViewDepth;
+layout(location = 4) flat in uint fragMaterialIndex;
 
-layout(binding = 1) uniform sampler2D texSampler;
+// the bindless set, see BindlessResources
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+// padded to 16 bytes to match the C++ side
+struct MaterialRecord {
+    uint albedoTexture;
+    uint padding[3];
+};
+
+layout(std430, set = 1, binding = 1) readonly buffer Materials {
+    MaterialRecord materials[];
+};
+
+layout(binding = 2) uniform ClusterParams {
+    mat4 view;
+    mat4 inverseProjection;
+    vec4 cameraPosition;
+    vec2 renderExtent;
+    float zNear;
+    float zFar;
+    uint gridX;
+    uint gridY;
+    uint gridZ;
+    uint maxLightsPerCluster;
+    uint lightCount;
+} params;
+
+struct PointLight {
+    vec3 position;
+    float radius;
+    vec3 color;
+    float intensity;
+};
+
+layout(std430, binding = 3) readonly buffer Lights {
+    PointLight lights[];
+};
+
+layout(std430, binding = 4) readonly buffer ClusterLightCounts {
+    uint lightCounts[];
+};
+
+layout(std430, binding = 5) readonly buffer ClusterLightIndices {
+    uint lightIndices[];
+};
 
 layout(location = 0) out vec4 outColor;
 
+// specialized per pipeline permutation, see GraphicsPipeline. Off shades with albedo and ambient only
+layout(constant_id = 0) const bool CLUSTERED_LIGHTING = true;
+// must match ClusteredLightingProps::maxLightsPerCluster, a constant stride and loop bound the compiler can work with
+layout(constant_id = 1) const uint MAX_LIGHTS_PER_CLUSTER = 128;
+
+const vec3 AMBIENT = vec3(0.05);
+
+// must agree with how cluster_lights.comp lays out the grid
+uint clusterIndex() {
+    vec2 uv = gl_FragCoord.xy / params.renderExtent;
+    uint x = min(uint(uv.x * float(params.gridX)), params.gridX - 1);
+    uint y = min(uint(uv.y * float(params.gridY)), params.gridY - 1);
+    float slice = log(max(fragViewDepth, params.zNear) / params.zNear) / log(params.zFar / params.zNear) * float(params.gridZ);
+    uint z = min(uint(slice), params.gridZ - 1);
+    return x + y * params.gridX + z * params.gridX * params.gridY;
+}
+
 void main() {
-    outColor = texture(texSampler, fragTexCoord);
-}
\ No newline at end of file
+    // neighbouring fragments can belong to draws with different materials
+    uint albedoTexture = materials[fragMaterialIndex].albedoTexture;
+    vec4 albedo = texture(textures[nonuniformEXT(albedoTexture)], fragTexCoord);
+
+    vec3 lighting = AMBIENT;
+    if (CLUSTERED_LIGHTING) {
+        // vertices don't carry normals yet, the flat face normal works for any mesh
+        vec3 normal = normalize(cross(dFdx(fragWorldPosition), dFdy(fragWorldPosition)));
+        vec3 toCamera = params.cameraPosition.xyz - fragWorldPosition;
+        if (dot(normal, toCamera) < 0.0) {
+            normal = -normal;
+        }
+
+        uint cluster = clusterIndex();
+        uint count = min(lightCounts[cluster], MAX_LIGHTS_PER_CLUSTER);
+        uint firstIndex = cluster * MAX_LIGHTS_PER_CLUSTER;
+        for (uint i = 0; i < count; i++) {
+            PointLight light = lights[lightIndices[firstIndex + i]];
+            vec3 toLight = light.position - fragWorldPosition;
+            float distanceSquared = dot(toLight, toLight);
+            // inverse square with a window that reaches zero at the radius, so binning by radius loses nothing visible
+            float falloff = clamp(1.0 - pow(distanceSquared / (light.radius * light.radius), 2.0), 0.0, 1.0);
+            float attenuation = falloff * falloff / (distanceSquared + 1.0);
+            float diffuse = max(dot(normal, toLight * inversesqrt(max(distanceSquared, 1e-8))), 0.0);
+            lighting += light.color * light.intensity * diffuse * attenuation;
+        }
+    }
+
+    outColor = vec4(albedo.rgb * lighting, albedo.a);
+}
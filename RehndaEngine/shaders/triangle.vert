@@ -1,20 +1,41 @@
 #version 450
 
 layout(binding = 0) uniform MVPTransforms {
-    mat4 model;
     mat4 view;
     mat4 proj;
 } mvp;
 
+struct ObjectRecord {
+    mat4 model;
+    uint materialIndex;
+};
+
+// one per draw, each draw's first instance is its index
+layout(std430, binding = 1) readonly buffer Objects {
+    ObjectRecord objects[];
+};
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
+// for clustered lighting
+layout(location = 2) out vec3 fragWorldPosition;
+layout(location = 3) out float fragViewDepth;
+layout(location = 4) flat out uint fragMaterialIndex;
+
+// matches depth_prepass.vert exactly so an equal depth test passes after the pre-pass
+invariant gl_Position;
 
 void main() {
-    gl_Position = mvp.proj * mvp.view * mvp.model * vec4(inPosition, 1.0);
+    ObjectRecord object = objects[gl_InstanceIndex];
+    gl_Position = mvp.proj * mvp.view * object.model * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
+    fragMaterialIndex = object.materialIndex;
+    vec4 worldPosition = object.model * vec4(inPosition, 1.0);
+    fragWorldPosition = worldPosition.xyz;
+    fragViewDepth = -(mvp.view * worldPosition).z;
 }
\ No newline at end of file
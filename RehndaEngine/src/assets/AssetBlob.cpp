@@ -0,0 +1,32 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "assets/AssetBlob.hpp"
+
+namespace Rehnda {
+    AssetBlob::AssetBlob(std::span<const std::byte> borrowedBytes) : storage(borrowedBytes) {}
+
+    AssetBlob::AssetBlob(std::vector<std::byte> ownedBytes) : storage(std::move(ownedBytes)) {}
+
+    AssetBlob::AssetBlob(MappedFile mappedFile) : storage(std::move(mappedFile)) {}
+
+    std::span<const std::byte> AssetBlob::bytes() const {
+        return std::visit([](const auto &stored) -> std::span<const std::byte> {
+            using StoredType = std::decay_t<decltype(stored)>;
+            if constexpr (std::is_same_v<StoredType, MappedFile>) {
+                return stored.bytes();
+            } else {
+                return {stored.data(), stored.size()};
+            }
+        }, storage);
+    }
+
+    const void *AssetBlob::data() const {
+        return bytes().data();
+    }
+
+    size_t AssetBlob::size() const {
+        return bytes().size();
+    }
+}
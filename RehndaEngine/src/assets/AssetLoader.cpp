@@ -0,0 +1,25 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "assets/AssetLoader.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace Rehnda {
+    AssetLoader::AssetLoader(const std::filesystem::path &packPath) {
+        if (std::filesystem::exists(packPath)) {
+            assetPack.emplace(packPath);
+            SPDLOG_INFO("Mounted asset pack {} with {} entries", packPath.string(), assetPack->getEntryCount());
+        } else {
+            SPDLOG_INFO("No asset pack at {}, loading loose files", packPath.string());
+        }
+    }
+
+    AssetBlob AssetLoader::load(std::string_view name) const {
+        if (assetPack.has_value() && assetPack->contains(name)) {
+            return assetPack->load(name);
+        }
+        return AssetBlob{MappedFile{std::filesystem::path(name)}};
+    }
+}
@@ -0,0 +1,101 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "assets/AssetPack.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <lz4.h>
+#include <zstd.h>
+
+namespace Rehnda {
+    AssetPack::AssetPack(const std::filesystem::path &packPath) :
+            // TOC lookups and per asset reads jump all over the archive, so read-ahead would mostly be wasted
+            mappedPack(packPath, MappedFileAccess::RANDOM),
+            toc(readToc()) {
+    }
+
+    std::span<const AssetPackFormat::TocEntry> AssetPack::readToc() const {
+        const auto bytes = mappedPack.bytes();
+        if (bytes.size() < sizeof(AssetPackFormat::Header)) {
+            throw std::runtime_error("Asset pack is too small to contain a header");
+        }
+        const auto *header = reinterpret_cast<const AssetPackFormat::Header *>(bytes.data());
+        if (header->magic != AssetPackFormat::MAGIC || header->version != AssetPackFormat::VERSION) {
+            throw std::runtime_error("Asset pack has an unsupported header");
+        }
+        const uint64_t tocSize = uint64_t{header->entryCount} * sizeof(AssetPackFormat::TocEntry);
+        // written so a corrupt offset can't wrap around and pass
+        if (header->tocOffset > bytes.size() || tocSize > bytes.size() - header->tocOffset) {
+            throw std::runtime_error("Asset pack table of contents is truncated");
+        }
+        const std::span<const AssetPackFormat::TocEntry> entries{
+                reinterpret_cast<const AssetPackFormat::TocEntry *>(bytes.data() + header->tocOffset), header->entryCount};
+        // checked once here so load can slice the mapping without checking again
+        for (const auto &entry: entries) {
+            if (entry.offset > bytes.size() || entry.storedSize > bytes.size() - entry.offset) {
+                throw std::runtime_error("Asset pack entry points outside the pack");
+            }
+        }
+        return entries;
+    }
+
+    const AssetPackFormat::TocEntry *AssetPack::findEntry(std::string_view name) const {
+        const uint64_t hash = AssetPackFormat::hashName(name);
+        const auto it = std::lower_bound(toc.begin(), toc.end(), hash,
+                                         [](const AssetPackFormat::TocEntry &entry, uint64_t value) {
+                                             return entry.nameHash < value;
+                                         });
+        if (it == toc.end() || it->nameHash != hash) {
+            return nullptr;
+        }
+        return &*it;
+    }
+
+    bool AssetPack::contains(std::string_view name) const {
+        return findEntry(name) != nullptr;
+    }
+
+    AssetBlob AssetPack::load(std::string_view name) const {
+        const auto *entry = findEntry(name);
+        if (entry == nullptr) {
+            throw std::runtime_error("Asset not found in pack: " + std::string(name));
+        }
+        const auto stored = mappedPack.bytes().subspan(entry->offset, entry->storedSize);
+        // we are about to read the whole blob front to back
+        mappedPack.advise(entry->offset, entry->storedSize, MappedFileAccess::WILL_NEED);
+
+        switch (entry->compression) {
+            case AssetPackFormat::Compression::NONE:
+                return AssetBlob{stored};
+            case AssetPackFormat::Compression::LZ4: {
+                std::vector<std::byte> decompressed(entry->originalSize);
+                const int decompressedSize = LZ4_decompress_safe(reinterpret_cast<const char *>(stored.data()),
+                                                                 reinterpret_cast<char *>(decompressed.data()),
+                                                                 static_cast<int>(stored.size()),
+                                                                 static_cast<int>(decompressed.size()));
+                if (decompressedSize < 0 || static_cast<uint64_t>(decompressedSize) != entry->originalSize) {
+                    throw std::runtime_error("Failed to decompress LZ4 asset: " + std::string(name));
+                }
+                return AssetBlob{std::move(decompressed)};
+            }
+            case AssetPackFormat::Compression::ZSTD: {
+                std::vector<std::byte> decompressed(entry->originalSize);
+                const size_t decompressedSize = ZSTD_decompress(decompressed.data(), decompressed.size(),
+                                                                stored.data(), stored.size());
+                if (ZSTD_isError(decompressedSize) || decompressedSize != entry->originalSize) {
+                    throw std::runtime_error("Failed to decompress zstd asset: " + std::string(name));
+                }
+                return AssetBlob{std::move(decompressed)};
+            }
+        }
+        throw std::runtime_error("Unknown compression for asset: " + std::string(name));
+    }
+
+    size_t AssetPack::getEntryCount() const {
+        return toc.size();
+    }
+}
@@ -0,0 +1,140 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "assets/AssetPackWriter.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <lz4.h>
+#include <zstd.h>
+
+#include "core/MappedFile.hpp"
+
+namespace Rehnda {
+    AssetPackWriter::AssetPackWriter(AssetPackWriterProps props) : props(props) {}
+
+    void AssetPackWriter::addDirectory(const std::filesystem::path &directory) {
+        const auto root = std::filesystem::weakly_canonical(directory);
+        const auto prefix = root.filename();
+        for (const auto &dirEntry: std::filesystem::recursive_directory_iterator(root)) {
+            if (!dirEntry.is_regular_file()) {
+                continue;
+            }
+            const auto relative = std::filesystem::relative(dirEntry.path(), root);
+            addFile(dirEntry.path(), (prefix / relative).generic_string());
+        }
+    }
+
+    void AssetPackWriter::addFile(const std::filesystem::path &file, std::string name) {
+        pendingEntries.push_back(PendingEntry{.name = std::move(name), .source = file});
+    }
+
+    AssetPackFormat::Compression AssetPackWriter::chooseCompression(const std::filesystem::path &file) const {
+        // these are already compressed, running them through lz4/zstd again just costs decode time at load
+        static const std::vector<std::string> precompressedExtensions{".jpg", ".jpeg", ".png", ".ktx2", ".basis"};
+        auto extension = file.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (std::find(precompressedExtensions.begin(), precompressedExtensions.end(), extension) !=
+            precompressedExtensions.end()) {
+            return AssetPackFormat::Compression::NONE;
+        }
+        return props.compression;
+    }
+
+    static std::vector<std::byte> compress(AssetPackFormat::Compression compression, std::span<const std::byte> input) {
+        std::vector<std::byte> output;
+        switch (compression) {
+            case AssetPackFormat::Compression::NONE:
+                break;
+            case AssetPackFormat::Compression::LZ4: {
+                output.resize(LZ4_compressBound(static_cast<int>(input.size())));
+                const int compressedSize = LZ4_compress_default(reinterpret_cast<const char *>(input.data()),
+                                                                reinterpret_cast<char *>(output.data()),
+                                                                static_cast<int>(input.size()),
+                                                                static_cast<int>(output.size()));
+                output.resize(compressedSize > 0 ? compressedSize : 0);
+                break;
+            }
+            case AssetPackFormat::Compression::ZSTD: {
+                output.resize(ZSTD_compressBound(input.size()));
+                const size_t compressedSize = ZSTD_compress(output.data(), output.size(), input.data(), input.size(),
+                                                            ZSTD_CLEVEL_DEFAULT);
+                output.resize(ZSTD_isError(compressedSize) ? 0 : compressedSize);
+                break;
+            }
+        }
+        return output;
+    }
+
+    void AssetPackWriter::write(const std::filesystem::path &outputPath) const {
+        std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open asset pack for writing: " + outputPath.string());
+        }
+
+        const auto writePadding = [&out]() {
+            const auto position = static_cast<uint64_t>(out.tellp());
+            const uint64_t padding = (AssetPackFormat::BLOB_ALIGNMENT - position % AssetPackFormat::BLOB_ALIGNMENT) %
+                                     AssetPackFormat::BLOB_ALIGNMENT;
+            const char zeros[AssetPackFormat::BLOB_ALIGNMENT]{};
+            out.write(zeros, static_cast<std::streamsize>(padding));
+        };
+
+        // header is rewritten once the TOC location is known
+        AssetPackFormat::Header header{
+                .magic = AssetPackFormat::MAGIC,
+                .version = AssetPackFormat::VERSION,
+                .entryCount = static_cast<uint32_t>(pendingEntries.size()),
+                .reserved = 0,
+                .tocOffset = 0,
+        };
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        std::vector<AssetPackFormat::TocEntry> toc;
+        std::unordered_map<uint64_t, std::string> namesByHash;
+        for (const auto &pending: pendingEntries) {
+            const uint64_t hash = AssetPackFormat::hashName(pending.name);
+            if (const auto [it, inserted] = namesByHash.emplace(hash, pending.name); !inserted) {
+                throw std::runtime_error("Asset name hash collision between " + it->second + " and " + pending.name);
+            }
+
+            const MappedFile source{pending.source};
+            auto compression = chooseCompression(pending.source);
+            std::vector<std::byte> compressed = compress(compression, source.bytes());
+            if (compressed.empty() ||
+                static_cast<double>(compressed.size()) > static_cast<double>(source.size()) * props.minCompressionRatio) {
+                compression = AssetPackFormat::Compression::NONE;
+            }
+            const auto stored = compression == AssetPackFormat::Compression::NONE
+                                ? source.bytes()
+                                : std::span<const std::byte>(compressed);
+
+            writePadding();
+            toc.push_back(AssetPackFormat::TocEntry{
+                    .nameHash = hash,
+                    .offset = static_cast<uint64_t>(out.tellp()),
+                    .storedSize = stored.size(),
+                    .originalSize = source.size(),
+                    .compression = compression,
+                    .reserved = 0,
+            });
+            out.write(reinterpret_cast<const char *>(stored.data()), static_cast<std::streamsize>(stored.size()));
+        }
+
+        std::sort(toc.begin(), toc.end(), [](const auto &a, const auto &b) { return a.nameHash < b.nameHash; });
+        writePadding();
+        header.tocOffset = static_cast<uint64_t>(out.tellp());
+        out.write(reinterpret_cast<const char *>(toc.data()),
+                  static_cast<std::streamsize>(toc.size() * sizeof(AssetPackFormat::TocEntry)));
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        if (!out.good()) {
+            throw std::runtime_error("Failed writing asset pack: " + outputPath.string());
+        }
+    }
+}
@@ -0,0 +1,183 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "assets/MeshCache.hpp"
+
+#include <array>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "rendering/MeshOptimizer.hpp"
+
+namespace Rehnda {
+    // the blob is only ever viewed as PackedVertex/index arrays, so the format is only valid if PackedVertex has no padding
+    static_assert(std::is_trivially_copyable_v<PackedVertex>);
+    static_assert(sizeof(MeshCacheFormat::Header) % alignof(PackedVertex) == 0);
+    static_assert(std::is_trivially_copyable_v<Meshlet>);
+    static_assert(std::is_trivially_copyable_v<MeshLod> && alignof(MeshLod) <= alignof(Meshlet));
+
+    namespace {
+        // whether count elements of stride bytes starting at offset are inside the blob and aligned for the element type,
+        // written as a division so a hostile count can't overflow past the check
+        bool isValidSection(uint64_t offset, uint64_t count, uint64_t stride, uint64_t alignment, size_t size) {
+            return offset <= size && offset % alignment == 0 && count <= (size - offset) / stride;
+        }
+
+        template<typename IndexType>
+        bool indicesInRange(std::span<const std::byte> indexBytes, uint64_t vertexCount) {
+            const std::span<const IndexType> indices{reinterpret_cast<const IndexType *>(indexBytes.data()),
+                                                     indexBytes.size() / sizeof(IndexType)};
+            for (const IndexType index: indices) {
+                if (index >= vertexCount) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // firstIndex and indexCount are both uint32_t, so the sum can't overflow in 64 bits
+        template<typename Range>
+        bool rangesInIndices(std::span<const Range> ranges, uint64_t indexCount) {
+            for (const Range &range: ranges) {
+                if (uint64_t{range.firstIndex} + range.indexCount > indexCount) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    CachedMesh::CachedMesh(AssetBlob blob) :
+            blob(std::move(blob)),
+            header(reinterpret_cast<const MeshCacheFormat::Header *>(this->blob.data())) {
+        const auto bytes = this->blob.bytes();
+        if (bytes.size() < sizeof(MeshCacheFormat::Header) ||
+            header->magic != MeshCacheFormat::MAGIC ||
+            header->version != MeshCacheFormat::VERSION) {
+            throw std::runtime_error("Invalid mesh cache header");
+        }
+        if (header->vertexStride != sizeof(PackedVertex) ||
+            (header->indexStride != sizeof(uint16_t) && header->indexStride != sizeof(uint32_t))) {
+            throw std::runtime_error("Mesh cache was written for a different vertex layout");
+        }
+        if (!isValidSection(header->vertexOffset, header->vertexCount, sizeof(PackedVertex), alignof(PackedVertex), bytes.size()) ||
+            !isValidSection(header->indexOffset, header->indexCount, header->indexStride, header->indexStride, bytes.size()) ||
+            !isValidSection(header->meshletOffset, header->meshletCount, sizeof(Meshlet), alignof(Meshlet), bytes.size()) ||
+            !isValidSection(header->lodOffset, header->lodCount, sizeof(MeshLod), alignof(MeshLod), bytes.size())) {
+            throw std::runtime_error("Mesh cache is truncated or misaligned");
+        }
+        // draws take a uint32_t count
+        if (header->indexCount > UINT32_MAX) {
+            throw std::runtime_error("Mesh cache has too many indices");
+        }
+        // a bad index would have the GPU read past the vertex buffer, this is the one pass over the data a load makes
+        const bool indicesValid = header->indexStride == sizeof(uint16_t)
+                                  ? indicesInRange<uint16_t>(getIndexBytes(), header->vertexCount)
+                                  : indicesInRange<uint32_t>(getIndexBytes(), header->vertexCount);
+        if (!indicesValid) {
+            throw std::runtime_error("Mesh cache has indices past its vertices");
+        }
+        if (!rangesInIndices(getMeshlets(), header->indexCount) || !rangesInIndices(getLods(), header->indexCount)) {
+            throw std::runtime_error("Mesh cache has meshlets or LODs past its indices");
+        }
+    }
+
+    std::span<const PackedVertex> CachedMesh::getVertices() const {
+        return {reinterpret_cast<const PackedVertex *>(blob.bytes().data() + header->vertexOffset), header->vertexCount};
+    }
+
+    std::span<const std::byte> CachedMesh::getIndexBytes() const {
+        return blob.bytes().subspan(header->indexOffset, header->indexCount * header->indexStride);
+    }
+
+    uint32_t CachedMesh::getIndexCount() const {
+        return static_cast<uint32_t>(header->indexCount);
+    }
+
+    vk::IndexType CachedMesh::getIndexType() const {
+        return header->indexStride == sizeof(uint16_t) ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+    }
+
+    std::span<const Meshlet> CachedMesh::getMeshlets() const {
+        return {reinterpret_cast<const Meshlet *>(blob.bytes().data() + header->meshletOffset), header->meshletCount};
+    }
+
+    std::span<const MeshLod> CachedMesh::getLods() const {
+        return {reinterpret_cast<const MeshLod *>(blob.bytes().data() + header->lodOffset), header->lodCount};
+    }
+
+    MeshBounds CachedMesh::getBounds() const {
+        return header->bounds;
+    }
+
+    namespace MeshCache {
+        void write(const std::filesystem::path &cachePath, const MeshData &meshData) {
+            if (cachePath.has_parent_path()) {
+                std::filesystem::create_directories(cachePath.parent_path());
+            }
+            // written next to the cache and renamed over it once complete, an interrupted import must never leave a truncated
+            // file at cachePath that a later load would take as valid
+            std::filesystem::path temporaryPath = cachePath;
+            temporaryPath += fmt::format(".{:x}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                throw std::runtime_error("Failed to open mesh cache for writing: " + temporaryPath.string());
+            }
+
+            const std::vector<PackedVertex> packedVertices = PackedVertex::packAll(meshData.vertices);
+            const uint64_t vertexBytes = packedVertices.size() * sizeof(PackedVertex);
+            const bool use16BitIndices = MeshOptimizer::fitsUint16Indices(meshData.vertices.size());
+            const uint64_t indexStride = use16BitIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+            const uint64_t indexEnd = sizeof(MeshCacheFormat::Header) + vertexBytes + meshData.indices.size() * indexStride;
+            // 16 bit indices can leave the meshlet table misaligned
+            const uint64_t meshletOffset = (indexEnd + alignof(Meshlet) - 1) & ~uint64_t{alignof(Meshlet) - 1};
+            const MeshCacheFormat::Header header{
+                    .magic = MeshCacheFormat::MAGIC,
+                    .version = MeshCacheFormat::VERSION,
+                    .vertexStride = sizeof(PackedVertex),
+                    .indexStride = static_cast<uint32_t>(indexStride),
+                    .vertexCount = meshData.vertices.size(),
+                    .indexCount = meshData.indices.size(),
+                    // vertices directly follow the header, indices directly follow the vertices
+                    .vertexOffset = sizeof(MeshCacheFormat::Header),
+                    .indexOffset = sizeof(MeshCacheFormat::Header) + vertexBytes,
+                    .meshletCount = meshData.meshlets.size(),
+                    .meshletOffset = meshletOffset,
+                    // Meshlet is a multiple of MeshLod's alignment so the LODs can directly follow
+                    .lodCount = meshData.lods.size(),
+                    .lodOffset = meshletOffset + meshData.meshlets.size() * sizeof(Meshlet),
+                    .bounds = meshData.bounds,
+            };
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char *>(packedVertices.data()), static_cast<std::streamsize>(vertexBytes));
+            if (use16BitIndices) {
+                const std::vector<uint16_t> narrowIndices(meshData.indices.begin(), meshData.indices.end());
+                out.write(reinterpret_cast<const char *>(narrowIndices.data()),
+                          static_cast<std::streamsize>(narrowIndices.size() * sizeof(uint16_t)));
+            } else {
+                out.write(reinterpret_cast<const char *>(meshData.indices.data()),
+                          static_cast<std::streamsize>(meshData.indices.size() * sizeof(uint32_t)));
+            }
+            const std::array<char, alignof(Meshlet)> padding{};
+            out.write(padding.data(), static_cast<std::streamsize>(meshletOffset - indexEnd));
+            out.write(reinterpret_cast<const char *>(meshData.meshlets.data()),
+                      static_cast<std::streamsize>(meshData.meshlets.size() * sizeof(Meshlet)));
+            out.write(reinterpret_cast<const char *>(meshData.lods.data()),
+                      static_cast<std::streamsize>(meshData.lods.size() * sizeof(MeshLod)));
+            out.close();
+            std::error_code error;
+            if (out) {
+                std::filesystem::rename(temporaryPath, cachePath, error);
+            }
+            if (!out || error) {
+                std::filesystem::remove(temporaryPath, error);
+                throw std::runtime_error("Failed writing mesh cache: " + cachePath.string());
+            }
+        }
+    }
+}
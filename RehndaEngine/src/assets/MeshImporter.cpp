@@ -0,0 +1,492 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "assets/MeshImporter.hpp"
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#define CGLTF_IMPLEMENTATION
+
+#include <cgltf.h>
+
+#include "assets/AssetPackFormat.hpp"
+#include "core/MappedFile.hpp"
+
+namespace Rehnda {
+    namespace {
+        // runs fn(i) for every i in [0, count) across up to workerCount threads, the calling thread takes part too
+        void parallelFor(size_t count, uint32_t workerCount, JobSystem *jobSystem, const std::function<void(size_t)> &fn) {
+            if (jobSystem) {
+                jobSystem->parallelFor(count, 1, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) {
+                        fn(i);
+                    }
+                });
+                return;
+            }
+            std::atomic<size_t> next{0};
+            // the first throw stops handing out work and is rethrown once every thread is joined, escaping a thread terminates
+            std::mutex exceptionMutex;
+            std::exception_ptr exception;
+            const auto work = [&]() {
+                try {
+                    for (size_t i = next++; i < count; i = next++) {
+                        fn(i);
+                    }
+                } catch (...) {
+                    next = count;
+                    std::lock_guard lock(exceptionMutex);
+                    if (!exception) {
+                        exception = std::current_exception();
+                    }
+                }
+            };
+            const size_t threadCount = std::min<size_t>(workerCount, count);
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < threadCount; i++) {
+                threads.emplace_back(work);
+            }
+            work();
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        // vertices are compared bitwise, which is what we want for dedup (two NaNs with the same bits are the same vertex)
+        struct VertexBitsHash {
+            size_t operator()(const Vertex &vertex) const {
+                const auto *bytes = reinterpret_cast<const unsigned char *>(&vertex);
+                uint64_t hash = 0xcbf29ce484222325ull;
+                for (size_t i = 0; i < sizeof(Vertex); i++) {
+                    hash ^= bytes[i];
+                    hash *= 0x100000001b3ull;
+                }
+                return static_cast<size_t>(hash);
+            }
+        };
+
+        struct VertexBitsEqual {
+            bool operator()(const Vertex &a, const Vertex &b) const {
+                return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+            }
+        };
+
+        // turns a flat list of triangle corners into unique vertices plus an index buffer
+        MeshData buildIndexed(const std::vector<Vertex> &corners) {
+            MeshData meshData;
+            meshData.indices.reserve(corners.size());
+            std::unordered_map<Vertex, uint32_t, VertexBitsHash, VertexBitsEqual> uniqueVertices;
+            uniqueVertices.reserve(corners.size());
+            for (const auto &corner: corners) {
+                const auto [it, inserted] = uniqueVertices.try_emplace(corner, static_cast<uint32_t>(meshData.vertices.size()));
+                if (inserted) {
+                    meshData.vertices.push_back(corner);
+                }
+                meshData.indices.push_back(it->second);
+            }
+            return meshData;
+        }
+
+        void appendMesh(MeshData &target, const MeshData &source) {
+            const auto baseVertex = static_cast<uint32_t>(target.vertices.size());
+            target.vertices.insert(target.vertices.end(), source.vertices.begin(), source.vertices.end());
+            for (const uint32_t index: source.indices) {
+                target.indices.push_back(baseVertex + index);
+            }
+        }
+
+        // ---- OBJ ----
+
+        // OBJ indices are 1 based and may be negative (relative to the number of elements read so far). Negative
+        // indices can only be resolved once we know how many elements the earlier chunks read, so they are kept relative to the chunk
+        struct ObjIndex {
+            int64_t index = -1;
+            bool chunkRelative = false;
+        };
+
+        struct ObjCorner {
+            ObjIndex position;
+            ObjIndex texCoord;
+        };
+
+        struct ObjChunk {
+            std::vector<glm::vec3> positions;
+            std::vector<glm::vec3> colors;
+            std::vector<glm::vec2> texCoords;
+            // already triangulated, 3 corners per triangle
+            std::vector<ObjCorner> corners;
+            size_t lineCount = 0;
+            // first line of the chunk that couldn't be parsed, counted from 1 within the chunk. 0 when every line was fine
+            size_t malformedLine = 0;
+        };
+
+        void skipSpaces(std::string_view &text) {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+                text.remove_prefix(1);
+            }
+        }
+
+        bool parseFloat(std::string_view &text, float &out) {
+            skipSpaces(text);
+            const auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+            if (result.ec != std::errc{}) {
+                return false;
+            }
+            text.remove_prefix(result.ptr - text.data());
+            return true;
+        }
+
+        bool parseInt(std::string_view &text, int64_t &out) {
+            const auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+            if (result.ec != std::errc{}) {
+                return false;
+            }
+            text.remove_prefix(result.ptr - text.data());
+            return true;
+        }
+
+        ObjIndex resolveObjIndex(int64_t rawIndex, size_t elementsReadInChunk) {
+            if (rawIndex > 0) {
+                return {.index = rawIndex - 1, .chunkRelative = false};
+            }
+            return {.index = static_cast<int64_t>(elementsReadInChunk) + rawIndex, .chunkRelative = true};
+        }
+
+        // parses "v", "v/vt", "v//vn" or "v/vt/vn"
+        bool parseFaceCorner(std::string_view &text, const ObjChunk &chunk, ObjCorner &corner) {
+            skipSpaces(text);
+            int64_t rawPosition;
+            // OBJ indices start at 1, 0 refers to nothing
+            if (!parseInt(text, rawPosition) || rawPosition == 0) {
+                return false;
+            }
+            corner.position = resolveObjIndex(rawPosition, chunk.positions.size());
+            corner.texCoord = {};
+            if (!text.empty() && text.front() == '/') {
+                text.remove_prefix(1);
+                int64_t rawTexCoord;
+                if (parseInt(text, rawTexCoord)) {
+                    corner.texCoord = resolveObjIndex(rawTexCoord, chunk.texCoords.size());
+                }
+                if (!text.empty() && text.front() == '/') {
+                    // normals aren't part of Vertex (yet), skip them
+                    text.remove_prefix(1);
+                    int64_t ignoredNormal;
+                    parseInt(text, ignoredNormal);
+                }
+            }
+            return true;
+        }
+
+        ObjChunk parseObjChunk(std::string_view text) {
+            ObjChunk chunk;
+            while (!text.empty()) {
+                const size_t lineEnd = text.find('\n');
+                std::string_view line = text.substr(0, lineEnd);
+                text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+                chunk.lineCount++;
+                skipSpaces(line);
+
+                if (line.starts_with("v ")) {
+                    line.remove_prefix(2);
+                    std::array<float, 7> values{};
+                    size_t valueCount = 0;
+                    while (valueCount < values.size() && parseFloat(line, values[valueCount])) {
+                        valueCount++;
+                    }
+                    if (valueCount < 3) {
+                        // the whole chunk is thrown away once the file is known to be broken, no point parsing on
+                        chunk.malformedLine = chunk.lineCount;
+                        return chunk;
+                    }
+                    // "x y z" or "x y z w", some exporters append a colour as "x y z r g b" or "x y z r g b a"
+                    glm::vec3 color{1.0f, 1.0f, 1.0f};
+                    if (valueCount >= 6) {
+                        color = {values[3], values[4], values[5]};
+                    }
+                    chunk.positions.push_back({values[0], values[1], values[2]});
+                    chunk.colors.push_back(color);
+                } else if (line.starts_with("vt ")) {
+                    line.remove_prefix(3);
+                    glm::vec2 texCoord{};
+                    parseFloat(line, texCoord.x);
+                    parseFloat(line, texCoord.y);
+                    // OBJ uv origin is bottom left, Vulkan samples with the origin at the top left
+                    texCoord.y = 1.0f - texCoord.y;
+                    chunk.texCoords.push_back(texCoord);
+                } else if (line.starts_with("f ")) {
+                    line.remove_prefix(2);
+                    ObjCorner first{}, previous{}, current{};
+                    if (!parseFaceCorner(line, chunk, first) || !parseFaceCorner(line, chunk, previous) ||
+                        !parseFaceCorner(line, chunk, current)) {
+                        chunk.malformedLine = chunk.lineCount;
+                        return chunk;
+                    }
+                    // triangle fan over the polygon
+                    do {
+                        chunk.corners.push_back(first);
+                        chunk.corners.push_back(previous);
+                        chunk.corners.push_back(current);
+                        previous = current;
+                    } while (parseFaceCorner(line, chunk, current));
+                }
+            }
+            return chunk;
+        }
+
+        // splits the text into roughly equal pieces, each ending on a line break
+        std::vector<std::string_view> splitIntoLineChunks(std::string_view text, size_t chunkCount) {
+            std::vector<std::string_view> chunks;
+            const size_t targetSize = std::max<size_t>(text.size() / chunkCount, 1);
+            while (!text.empty()) {
+                size_t end = std::min(targetSize, text.size());
+                const size_t lineEnd = text.find('\n', end > 0 ? end - 1 : 0);
+                end = lineEnd == std::string_view::npos ? text.size() : lineEnd + 1;
+                chunks.push_back(text.substr(0, end));
+                text.remove_prefix(end);
+            }
+            return chunks;
+        }
+
+        // ---- glTF ----
+
+        struct GltfPrimitiveJob {
+            const cgltf_primitive *primitive;
+            float worldTransform[16];
+        };
+
+        const cgltf_accessor *findAttribute(const cgltf_primitive &primitive, cgltf_attribute_type type) {
+            for (size_t i = 0; i < primitive.attributes_count; i++) {
+                if (primitive.attributes[i].type == type && primitive.attributes[i].index == 0) {
+                    return primitive.attributes[i].data;
+                }
+            }
+            return nullptr;
+        }
+
+        MeshData importGltfPrimitive(const GltfPrimitiveJob &job) {
+            const cgltf_primitive &primitive = *job.primitive;
+            const cgltf_accessor *positions = findAttribute(primitive, cgltf_attribute_type_position);
+            if (positions == nullptr) {
+                return {};
+            }
+            const cgltf_accessor *colors = findAttribute(primitive, cgltf_attribute_type_color);
+            const cgltf_accessor *texCoords = findAttribute(primitive, cgltf_attribute_type_texcoord);
+
+            std::vector<Vertex> primitiveVertices(positions->count);
+            for (size_t i = 0; i < positions->count; i++) {
+                float position[3]{};
+                cgltf_accessor_read_float(positions, i, position, 3);
+                // glTF matrices are column major, same as what cgltf_node_transform_world gives us
+                const float *m = job.worldTransform;
+                Vertex &vertex = primitiveVertices[i];
+                vertex.pos = {
+                        m[0] * position[0] + m[4] * position[1] + m[8] * position[2] + m[12],
+                        m[1] * position[0] + m[5] * position[1] + m[9] * position[2] + m[13],
+                        m[2] * position[0] + m[6] * position[1] + m[10] * position[2] + m[14],
+                };
+                vertex.color = {1.0f, 1.0f, 1.0f};
+                if (colors != nullptr) {
+                    float color[4]{1.0f, 1.0f, 1.0f, 1.0f};
+                    cgltf_accessor_read_float(colors, i, color, 4);
+                    vertex.color = {color[0], color[1], color[2]};
+                }
+                vertex.texCoord = {};
+                if (texCoords != nullptr) {
+                    float texCoord[2]{};
+                    cgltf_accessor_read_float(texCoords, i, texCoord, 2);
+                    vertex.texCoord = {texCoord[0], texCoord[1]};
+                }
+            }
+
+            // glTF is usually already indexed, but not necessarily uniquely, so expand and let buildIndexed merge duplicates
+            std::vector<Vertex> corners;
+            if (primitive.indices != nullptr) {
+                corners.reserve(primitive.indices->count);
+                for (size_t i = 0; i < primitive.indices->count; i++) {
+                    const size_t index = cgltf_accessor_read_index(primitive.indices, i);
+                    if (index >= primitiveVertices.size()) {
+                        throw std::runtime_error(fmt::format("glTF primitive index {} is past its {} vertices", index,
+                                                             primitiveVertices.size()));
+                    }
+                    corners.push_back(primitiveVertices[index]);
+                }
+            } else {
+                corners = std::move(primitiveVertices);
+            }
+            return buildIndexed(corners);
+        }
+    }
+
+    MeshImporter::MeshImporter(MeshImporterProps props) : props(std::move(props)) {}
+
+    MeshData MeshImporter::import(const std::filesystem::path &sourcePath) const {
+        auto extension = sourcePath.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        MeshData meshData;
+        if (extension == ".obj") {
+            meshData = importObj(sourcePath);
+        } else if (extension == ".gltf" || extension == ".glb") {
+            meshData = importGltf(sourcePath);
+        } else {
+            throw std::runtime_error("Unsupported mesh format: " + sourcePath.string());
+        }
+        if (props.optimize) {
+            MeshOptimizer::optimize(meshData, props.optimizerProps);
+        }
+        if (props.buildMeshlets) {
+            // builds on the cache optimized order, meshoptimizer's meshlet builder keeps locality within each cluster
+            meshData.meshlets = Meshlets::build(meshData);
+        }
+        // after meshlets as both rewrite indices, the LODs are appended after the meshlet ordered LOD 0
+        if (props.generateLods) {
+            meshData.lods = MeshLods::build(meshData, props.lodProps);
+        }
+        meshData.bounds = MeshLods::computeBounds(meshData.vertices);
+        return meshData;
+    }
+
+    MeshData MeshImporter::importObj(const std::filesystem::path &sourcePath) const {
+        const MappedFile objFile{sourcePath, MappedFileAccess::WILL_NEED};
+        const std::string_view text{static_cast<const char *>(objFile.data()), objFile.size()};
+
+        const auto textChunks = splitIntoLineChunks(text, props.workerCount);
+        std::vector<ObjChunk> chunks(textChunks.size());
+        parallelFor(textChunks.size(), props.workerCount, props.jobSystem, [&](size_t i) {
+            chunks[i] = parseObjChunk(textChunks[i]);
+        });
+
+        // chunks only count their own lines, the ones before them give the line in the file
+        size_t lineBase = 0;
+        for (const auto &chunk: chunks) {
+            if (chunk.malformedLine != 0) {
+                throw std::runtime_error(fmt::format("Malformed OBJ vertex or face at {}:{}", sourcePath.string(),
+                                                     lineBase + chunk.malformedLine));
+            }
+            lineBase += chunk.lineCount;
+        }
+
+        // stitch the chunks back together, now the per chunk element counts are known negative indices can be resolved
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> colors;
+        std::vector<glm::vec2> texCoords;
+        std::vector<Vertex> corners;
+        for (const auto &chunk: chunks) {
+            const auto positionBase = static_cast<int64_t>(positions.size());
+            const auto texCoordBase = static_cast<int64_t>(texCoords.size());
+            positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+            colors.insert(colors.end(), chunk.colors.begin(), chunk.colors.end());
+            texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+
+            for (const auto &corner: chunk.corners) {
+                const int64_t positionIndex = corner.position.index + (corner.position.chunkRelative ? positionBase : 0);
+                if (positionIndex < 0 || positionIndex >= static_cast<int64_t>(positions.size())) {
+                    throw std::runtime_error("OBJ face references a missing position in " + sourcePath.string());
+                }
+                glm::vec2 texCoord{};
+                if (corner.texCoord.index >= 0 || corner.texCoord.chunkRelative) {
+                    const int64_t texCoordIndex = corner.texCoord.index + (corner.texCoord.chunkRelative ? texCoordBase : 0);
+                    if (texCoordIndex >= 0 && texCoordIndex < static_cast<int64_t>(texCoords.size())) {
+                        texCoord = texCoords[texCoordIndex];
+                    }
+                }
+                corners.push_back(Vertex{
+                        .pos = positions[positionIndex],
+                        .color = colors[positionIndex],
+                        .texCoord = texCoord,
+                });
+            }
+        }
+        return buildIndexed(corners);
+    }
+
+    MeshData MeshImporter::importGltf(const std::filesystem::path &sourcePath) const {
+        const std::string pathString = sourcePath.string();
+        cgltf_options options{};
+        cgltf_data *rawData = nullptr;
+        if (cgltf_parse_file(&options, pathString.c_str(), &rawData) != cgltf_result_success) {
+            throw std::runtime_error("Failed to parse glTF: " + pathString);
+        }
+        std::unique_ptr<cgltf_data, decltype(&cgltf_free)> data{rawData, cgltf_free};
+        if (cgltf_load_buffers(&options, data.get(), pathString.c_str()) != cgltf_result_success) {
+            throw std::runtime_error("Failed to load glTF buffers: " + pathString);
+        }
+        // checks every accessor fits inside its buffer, without it a malformed file reads out of bounds
+        if (cgltf_validate(data.get()) != cgltf_result_success) {
+            throw std::runtime_error("Invalid glTF: " + pathString);
+        }
+
+        // flatten the node hierarchy, baking each node's world transform into its primitives
+        std::vector<GltfPrimitiveJob> jobs;
+        for (size_t n = 0; n < data->nodes_count; n++) {
+            const cgltf_node &node = data->nodes[n];
+            if (node.mesh == nullptr) {
+                continue;
+            }
+            for (size_t p = 0; p < node.mesh->primitives_count; p++) {
+                const cgltf_primitive &primitive = node.mesh->primitives[p];
+                if (primitive.type != cgltf_primitive_type_triangles) {
+                    SPDLOG_WARN("Skipping non triangle list primitive in {}", pathString);
+                    continue;
+                }
+                GltfPrimitiveJob job{.primitive = &primitive, .worldTransform = {}};
+                cgltf_node_transform_world(&node, job.worldTransform);
+                jobs.push_back(job);
+            }
+        }
+
+        std::vector<MeshData> primitiveMeshes(jobs.size());
+        parallelFor(jobs.size(), props.workerCount, props.jobSystem, [&](size_t i) {
+            primitiveMeshes[i] = importGltfPrimitive(jobs[i]);
+        });
+
+        MeshData meshData;
+        for (const auto &primitiveMesh: primitiveMeshes) {
+            appendMesh(meshData, primitiveMesh);
+        }
+        return meshData;
+    }
+
+    std::filesystem::path MeshImporter::cachePathFor(const std::filesystem::path &sourcePath) const {
+        // the name alone would have meshes with the same name in different directories overwrite each other's cache, the
+        // hash of the full path keeps them apart and the name keeps the directory readable
+        const std::string fullPath = std::filesystem::absolute(sourcePath).lexically_normal().generic_string();
+        auto cacheName = sourcePath.filename();
+        cacheName += fmt::format(".{:016x}.rmesh", AssetPackFormat::hashName(fullPath));
+        return props.cacheDirectory / cacheName;
+    }
+
+    CachedMesh MeshImporter::importCached(const std::filesystem::path &sourcePath) const {
+        const auto cachePath = cachePathFor(sourcePath);
+        const bool cacheIsFresh = std::filesystem::exists(cachePath) &&
+                                  std::filesystem::last_write_time(cachePath) >= std::filesystem::last_write_time(sourcePath);
+        if (cacheIsFresh) {
+            // newer than the source but possibly written by an older build, a cache in a format this build can't read is
+            // imported again like a missing one
+            try {
+                return CachedMesh{AssetBlob{MappedFile{cachePath}}};
+            } catch (const std::runtime_error &e) {
+                SPDLOG_WARN("Discarding mesh cache {}: {}", cachePath.string(), e.what());
+            }
+        }
+        SPDLOG_INFO("Importing mesh {} into {}", sourcePath.string(), cachePath.string());
+        MeshCache::write(cachePath, import(sourcePath));
+        return CachedMesh{AssetBlob{MappedFile{cachePath}}};
+    }
+}
@@ -3,20 +3,13 @@
 //
 
 #include "core/FileUtils.hpp"
+#include "core/MappedFile.hpp"
 
 namespace Rehnda::FileUtils {
     std::vector<char> readFileAsBytes(const std::string &filename) {
-        std::ifstream file(filename, std::ios::ate | std::ios::binary);
-
-        if (!file.is_open()) {
-            throw std::runtime_error("failed to open file!");
-        }
-        size_t fileSize = (size_t) file.tellg();
-        std::vector<char> buffer(fileSize);
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-        file.close();
-
-        return buffer;
+        // only for callers that need to own (and mutate) the bytes, anything read only should use a MappedFile directly
+        const MappedFile file{filename};
+        const auto *begin = static_cast<const char *>(file.data());
+        return {begin, begin + file.size()};
     }
 }
\ No newline at end of file
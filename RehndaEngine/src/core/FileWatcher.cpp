@@ -0,0 +1,101 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "core/FileWatcher.hpp"
+
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Rehnda {
+    FileWatcher::FileWatcher(std::filesystem::path directory, Callback onChanged) :
+            directory(std::move(directory)),
+            onChanged(std::move(onChanged)) {
+#ifdef __linux__
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to create inotify instance");
+        }
+        // close write for saves in place, moved to for editors that write a temporary file and rename it over the original
+        if (inotify_add_watch(inotifyFd, this->directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            const int error = errno;
+            close(inotifyFd);
+            throw std::system_error(error, std::generic_category(), "Failed to watch " + this->directory.string());
+        }
+#endif
+        thread = std::thread([this]() { run(); });
+    }
+
+    FileWatcher::~FileWatcher() {
+        running = false;
+        thread.join();
+#ifdef __linux__
+        close(inotifyFd);
+#endif
+    }
+
+#ifdef __linux__
+    void FileWatcher::run() {
+        alignas(inotify_event) char buffer[4096];
+        pollfd pollFd{.fd = inotifyFd, .events = POLLIN, .revents = 0};
+        while (running) {
+            // wakes up every interval regardless so a stop request is noticed
+            if (poll(&pollFd, 1, static_cast<int>(POLL_INTERVAL.count())) <= 0) {
+                continue;
+            }
+            std::set<std::filesystem::path> changed;
+            // keep draining until the directory has been quiet for a moment, so one save is one batch
+            do {
+                ssize_t length;
+                while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+                    for (ssize_t offset = 0; offset < length;) {
+                        const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                        if (event->len > 0) {
+                            changed.insert(directory / event->name);
+                        }
+                        offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                    }
+                }
+            } while (running && poll(&pollFd, 1, 50) > 0);
+
+            for (const auto &path: changed) {
+                onChanged(path);
+            }
+        }
+    }
+#else
+    void FileWatcher::run() {
+        const auto scan = [this]() {
+            std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes;
+            std::error_code error;
+            for (const auto &entry: std::filesystem::directory_iterator(directory, error)) {
+                if (entry.is_regular_file(error)) {
+                    writeTimes[entry.path().string()] = entry.last_write_time(error);
+                }
+            }
+            return writeTimes;
+        };
+
+        auto lastWriteTimes = scan();
+        while (running) {
+            std::this_thread::sleep_for(POLL_INTERVAL);
+            auto writeTimes = scan();
+            for (const auto &[path, writeTime]: writeTimes) {
+                const auto previous = lastWriteTimes.find(path);
+                if (previous == lastWriteTimes.end() || previous->second != writeTime) {
+                    onChanged(path);
+                }
+            }
+            lastWriteTimes = std::move(writeTimes);
+        }
+    }
+#endif
+}
@@ -0,0 +1,332 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "core/JobSystem.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace Rehnda {
+    struct Job {
+        JobSystem::JobFunction function;
+        JobCounter *counter;
+        JobAffinity affinity;
+    };
+
+    namespace {
+        constexpr uint32_t NO_QUEUE = 0xFFFFFFFF;
+
+        // which system's queue the current thread owns, a thread only ever belongs to one
+        thread_local const JobSystem *threadJobSystem = nullptr;
+        thread_local uint32_t threadQueueIndex = NO_QUEUE;
+        thread_local uint32_t stealSeed = 0x9E3779B9u;
+
+        uint32_t nextRandom() {
+            // xorshift, only used to spread thieves over victims
+            stealSeed ^= stealSeed << 13;
+            stealSeed ^= stealSeed >> 17;
+            stealSeed ^= stealSeed << 5;
+            return stealSeed;
+        }
+    }
+
+    bool JobCounter::isDone() const {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+
+    JobSystem::JobSystem(const JobSystemProps &props) : mainThreadId(std::this_thread::get_id()) {
+        const uint32_t workerCount = props.workerCount > 0 ? props.workerCount
+                                                           : std::max(2u, std::thread::hardware_concurrency()) - 1;
+        queues.reserve(workerCount + 1);
+        for (uint32_t i = 0; i <= workerCount; i++) {
+            queues.push_back(std::make_unique<ThreadQueue>(props.queueCapacity));
+        }
+        threadJobSystem = this;
+        threadQueueIndex = 0;
+        workers.reserve(workerCount);
+        for (uint32_t i = 1; i <= workerCount; i++) {
+            workers.emplace_back([this, i]() { workerLoop(i); });
+        }
+        SPDLOG_INFO("Job system started with {} worker threads", workerCount);
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard lock(sleepMutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto &worker: workers) {
+            worker.join();
+        }
+
+        for (auto &queue: queues) {
+            while (auto job = queue->deque.pop()) {
+                delete *job;
+            }
+        }
+        for (Job *job: sharedJobs) {
+            delete job;
+        }
+        for (Job *job: mainThreadJobs) {
+            delete job;
+        }
+        if (threadJobSystem == this) {
+            threadJobSystem = nullptr;
+            threadQueueIndex = NO_QUEUE;
+        }
+    }
+
+    void JobSystem::run(JobFunction function, JobCounter *counter, JobAffinity affinity) {
+        if (counter) {
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        schedule(new Job{.function = std::move(function), .counter = counter, .affinity = affinity});
+    }
+
+    void JobSystem::runAfter(JobCounter &dependency, JobFunction function, JobCounter *counter, JobAffinity affinity) {
+        if (counter) {
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        Job *job = new Job{.function = std::move(function), .counter = counter, .affinity = affinity};
+        {
+            std::lock_guard lock(dependency.mutex);
+            if (dependency.pending.load(std::memory_order_acquire) != 0) {
+                // whoever finishes the last job on dependency schedules it
+                dependency.continuations.push_back(job);
+                return;
+            }
+        }
+        schedule(job);
+    }
+
+    void JobSystem::parallelFor(size_t count, size_t batchSize, const RangeFunction &function) {
+        if (count == 0) {
+            return;
+        }
+        batchSize = std::max<size_t>(batchSize, 1);
+        JobCounter counter;
+        for (size_t begin = batchSize; begin < count; begin += batchSize) {
+            const size_t end = std::min(begin + batchSize, count);
+            run([&function, begin, end]() { function(begin, end); }, &counter);
+        }
+        // the caller does the first batch itself rather than queueing it and popping it straight back off. A throw still has to
+        // wait for the other batches, they reference function and counter
+        try {
+            function(0, std::min(batchSize, count));
+        } catch (...) {
+            recordException(counter, std::current_exception());
+        }
+        wait(counter);
+    }
+
+    void JobSystem::wait(JobCounter &counter) {
+        while (!counter.isDone()) {
+            if (!runOneJob()) {
+                std::this_thread::yield();
+            }
+        }
+        // the job that brought it to zero may still be inside finish(), holding the lock is what lets the caller destroy
+        // the counter as soon as this returns
+        std::exception_ptr exception;
+        {
+            std::lock_guard lock(counter.mutex);
+            exception = std::exchange(counter.exception, nullptr);
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void JobSystem::runMainThreadJobs() {
+        if (!isMainThread()) {
+            throw std::runtime_error("Main thread jobs can only be run from the thread that created the job system");
+        }
+        std::deque<Job *> jobs;
+        {
+            std::lock_guard lock(mainThreadMutex);
+            jobs.swap(mainThreadJobs);
+        }
+        for (Job *job: jobs) {
+            execute(job, 0);
+        }
+    }
+
+    uint32_t JobSystem::getWorkerCount() const {
+        return static_cast<uint32_t>(workers.size());
+    }
+
+    bool JobSystem::isMainThread() const {
+        return std::this_thread::get_id() == mainThreadId;
+    }
+
+    JobSystemStats JobSystem::getStats() const {
+        JobSystemStats stats{0, 0};
+        for (const auto &queue: queues) {
+            stats.executed += queue->executed.load(std::memory_order_relaxed);
+            stats.stolen += queue->stolen.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    void JobSystem::workerLoop(uint32_t queueIndex) {
+        threadJobSystem = this;
+        threadQueueIndex = queueIndex;
+        stealSeed ^= queueIndex * 0x85EBCA6Bu;
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (Job *job = findJob(queueIndex)) {
+                execute(job, queueIndex);
+                continue;
+            }
+            std::unique_lock lock(sleepMutex);
+            // paired with the queuedJobs increment then sleepingWorkers check in schedule, one of the two sides always sees
+            // the other so a queued job can't be slept through
+            sleepingWorkers.fetch_add(1);
+            wakeCondition.wait(lock, [this]() { return stopping.load() || queuedJobs.load() > 0; });
+            sleepingWorkers.fetch_sub(1);
+        }
+    }
+
+    void JobSystem::schedule(Job *job) {
+        if (job->affinity == JobAffinity::MAIN_THREAD) {
+            std::lock_guard lock(mainThreadMutex);
+            mainThreadJobs.push_back(job);
+            return;
+        }
+        // counted before it's visible, so the count can run ahead of the queues but never behind them
+        queuedJobs.fetch_add(1);
+        const uint32_t queueIndex = currentQueueIndex();
+        if (queueIndex == NO_QUEUE || !queues[queueIndex]->deque.push(job)) {
+            std::lock_guard lock(sharedMutex);
+            sharedJobs.push_back(job);
+            sharedJobCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        wakeWorker();
+    }
+
+    Job *JobSystem::findJob(uint32_t queueIndex) {
+        if (queueIndex != NO_QUEUE) {
+            if (auto job = queues[queueIndex]->deque.pop()) {
+                queuedJobs.fetch_sub(1);
+                return *job;
+            }
+        }
+        if (sharedJobCount.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard lock(sharedMutex);
+            if (!sharedJobs.empty()) {
+                Job *job = sharedJobs.front();
+                sharedJobs.pop_front();
+                sharedJobCount.fetch_sub(1, std::memory_order_relaxed);
+                queuedJobs.fetch_sub(1);
+                return job;
+            }
+        }
+        // start from a random victim so thieves don't all pile onto the same queue
+        const auto queueCount = static_cast<uint32_t>(queues.size());
+        const uint32_t firstVictim = nextRandom() % queueCount;
+        for (uint32_t i = 0; i < queueCount; i++) {
+            const uint32_t victim = (firstVictim + i) % queueCount;
+            if (victim == queueIndex) {
+                continue;
+            }
+            if (auto job = queues[victim]->deque.steal()) {
+                queuedJobs.fetch_sub(1);
+                if (queueIndex != NO_QUEUE) {
+                    queues[queueIndex]->stolen.fetch_add(1, std::memory_order_relaxed);
+                }
+                return *job;
+            }
+        }
+        return nullptr;
+    }
+
+    bool JobSystem::runOneJob() {
+        const uint32_t queueIndex = currentQueueIndex();
+        if (Job *job = findJob(queueIndex)) {
+            execute(job, queueIndex);
+            return true;
+        }
+        if (queueIndex == 0) {
+            // the main thread waiting on something may be waiting on a job only it can run
+            Job *job = nullptr;
+            {
+                std::lock_guard lock(mainThreadMutex);
+                if (!mainThreadJobs.empty()) {
+                    job = mainThreadJobs.front();
+                    mainThreadJobs.pop_front();
+                }
+            }
+            if (job) {
+                execute(job, queueIndex);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void JobSystem::execute(Job *job, uint32_t queueIndex) {
+        // letting it escape would terminate a worker, or leave the counter pending forever on a waiting thread
+        try {
+            job->function();
+        } catch (...) {
+            if (job->counter) {
+                recordException(*job->counter, std::current_exception());
+            } else {
+                // nobody waits on the job, so there's nowhere to hand it to
+                try {
+                    throw;
+                } catch (const std::exception &e) {
+                    SPDLOG_ERROR("Job without a counter threw: {}", e.what());
+                } catch (...) {
+                    SPDLOG_ERROR("Job without a counter threw");
+                }
+            }
+        }
+        if (queueIndex != NO_QUEUE) {
+            queues[queueIndex]->executed.fetch_add(1, std::memory_order_relaxed);
+        }
+        finish(job);
+    }
+
+    void JobSystem::finish(Job *job) {
+        if (JobCounter *counter = job->counter) {
+            std::vector<Job *> ready;
+            {
+                std::lock_guard lock(counter->mutex);
+                if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    ready.swap(counter->continuations);
+                }
+            }
+            for (Job *continuation: ready) {
+                schedule(continuation);
+            }
+        }
+        delete job;
+    }
+
+    void JobSystem::recordException(JobCounter &counter, std::exception_ptr exception) {
+        std::lock_guard lock(counter.mutex);
+        if (!counter.exception) {
+            counter.exception = std::move(exception);
+        }
+    }
+
+    void JobSystem::wakeWorker() {
+        if (sleepingWorkers.load() == 0) {
+            return;
+        }
+        {
+            // a worker between checking its predicate and blocking holds this, so once we have it the worker is waiting
+            std::lock_guard lock(sleepMutex);
+        }
+        wakeCondition.notify_one();
+    }
+
+    uint32_t JobSystem::currentQueueIndex() const {
+        return threadJobSystem == this ? threadQueueIndex : NO_QUEUE;
+    }
+}
@@ -0,0 +1,164 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "core/MappedFile.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Rehnda {
+#ifndef _WIN32
+    static int toMadvise(MappedFileAccess access) {
+        switch (access) {
+            case MappedFileAccess::SEQUENTIAL:
+                return MADV_SEQUENTIAL;
+            case MappedFileAccess::RANDOM:
+                return MADV_RANDOM;
+            case MappedFileAccess::WILL_NEED:
+                return MADV_WILLNEED;
+        }
+        return MADV_NORMAL;
+    }
+#endif
+
+    MappedFile::MappedFile(const std::filesystem::path &path, MappedFileAccess access) {
+#ifdef _WIN32
+        fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 access == MappedFileAccess::RANDOM ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN,
+                                 nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            fileHandle = nullptr;
+            throw std::runtime_error("Failed to open file for mapping: " + path.string());
+        }
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(fileHandle, &fileSize);
+        mappingSize = static_cast<size_t>(fileSize.QuadPart);
+        if (mappingSize == 0) {
+            // can't create a mapping of an empty file, an empty span is all we need
+            return;
+        }
+        mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr) {
+            unmap();
+            throw std::runtime_error("Failed to create file mapping: " + path.string());
+        }
+        mapping = static_cast<const std::byte *>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (mapping == nullptr) {
+            unmap();
+            throw std::runtime_error("Failed to map view of file: " + path.string());
+        }
+#else
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open file for mapping: " + path.string());
+        }
+        struct stat fileStat{};
+        if (fstat(fd, &fileStat) != 0) {
+            close(fd);
+            throw std::runtime_error("Failed to stat file: " + path.string());
+        }
+        mappingSize = static_cast<size_t>(fileStat.st_size);
+        if (mappingSize == 0) {
+            close(fd);
+            return;
+        }
+        void *address = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping holds its own reference to the file, so the descriptor isn't needed any more
+        close(fd);
+        if (address == MAP_FAILED) {
+            mappingSize = 0;
+            throw std::runtime_error("Failed to map file: " + path.string());
+        }
+        mapping = static_cast<const std::byte *>(address);
+        advise(0, mappingSize, access);
+#endif
+    }
+
+    MappedFile::~MappedFile() {
+        unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept:
+            mapping(std::exchange(other.mapping, nullptr)),
+            mappingSize(std::exchange(other.mappingSize, 0))
+#ifdef _WIN32
+            , fileHandle(std::exchange(other.fileHandle, nullptr)),
+            mappingHandle(std::exchange(other.mappingHandle, nullptr))
+#endif
+    {
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            unmap();
+            mapping = std::exchange(other.mapping, nullptr);
+            mappingSize = std::exchange(other.mappingSize, 0);
+#ifdef _WIN32
+            fileHandle = std::exchange(other.fileHandle, nullptr);
+            mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    std::span<const std::byte> MappedFile::bytes() const {
+        return {mapping, mappingSize};
+    }
+
+    const void *MappedFile::data() const {
+        return mapping;
+    }
+
+    size_t MappedFile::size() const {
+        return mappingSize;
+    }
+
+    void MappedFile::advise([[maybe_unused]] size_t offset, [[maybe_unused]] size_t length,
+                            [[maybe_unused]] MappedFileAccess access) const {
+#ifndef _WIN32
+        if (mapping == nullptr || offset >= mappingSize) {
+            return;
+        }
+        // madvise needs a page aligned start address, so round the start down to the containing page
+        const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t alignedOffset = offset - (offset % pageSize);
+        const size_t alignedLength = std::min(length + (offset - alignedOffset), mappingSize - alignedOffset);
+        // purely a hint, if the kernel ignores it we still have a perfectly valid mapping
+        madvise(const_cast<std::byte *>(mapping) + alignedOffset, alignedLength, toMadvise(access));
+#endif
+    }
+
+    void MappedFile::unmap() {
+#ifdef _WIN32
+        if (mapping != nullptr) {
+            UnmapViewOfFile(mapping);
+        }
+        if (mappingHandle != nullptr) {
+            CloseHandle(mappingHandle);
+        }
+        if (fileHandle != nullptr) {
+            CloseHandle(fileHandle);
+        }
+        fileHandle = nullptr;
+        mappingHandle = nullptr;
+#else
+        if (mapping != nullptr) {
+            munmap(const_cast<std::byte *>(mapping), mappingSize);
+        }
+#endif
+        mapping = nullptr;
+        mappingSize = 0;
+    }
+}
@@ -5,14 +5,68 @@
 #include "game/Application.hpp"
 #include <core/CoreTypes.hpp>
 
+#include <chrono>
+#include <exception>
+#include <thread>
+
 namespace Rehnda {
-    Application::Application() : window(Windowing::Window(Pixels(800), Pixels(600))) {}
+    Application::Application(ApplicationProps props) :
+            props(props),
+            window(Windowing::Window(Pixels(800), Pixels(600), jobSystem)),
+            frameHandoff(props.renderCommandCapacity) {}
 
     void Application::run() {
-        while (!window.shouldClose()) {
-            window.pollEvents();
-            window.render();
+        if (props.pipelinedRendering) {
+            runPipelined();
+        } else {
+            runSingleThreaded();
         }
         window.waitIdle();
     }
-}
\ No newline at end of file
+
+    void Application::runSingleThreaded() {
+        const auto startTime = std::chrono::steady_clock::now();
+        while (!window.shouldClose()) {
+            updateGame(std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count());
+            const RenderCommandStream *frame = frameHandoff.acquire();
+            window.render(*frame);
+            frameHandoff.release();
+        }
+    }
+
+    void Application::runPipelined() {
+        // GLFW has to stay on the main thread, so that's the game thread and rendering moves out to its own
+        std::exception_ptr renderError;
+        std::thread renderThread([this, &renderError]() {
+            try {
+                while (const RenderCommandStream *frame = frameHandoff.acquire()) {
+                    window.render(*frame);
+                    frameHandoff.release();
+                }
+            } catch (...) {
+                renderError = std::current_exception();
+            }
+            // stops the game thread too if rendering failed
+            frameHandoff.close();
+        });
+
+        const auto startTime = std::chrono::steady_clock::now();
+        while (!window.shouldClose() && !frameHandoff.isClosed()) {
+            updateGame(std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count());
+        }
+        frameHandoff.close();
+        renderThread.join();
+        if (renderError) {
+            std::rethrow_exception(renderError);
+        }
+    }
+
+    void Application::updateGame(float time) {
+        window.pollEvents();
+        // jobs that have to touch GLFW or the window are queued for the main thread, which picks them up between frames
+        jobSystem.runMainThreadJobs();
+        RenderCommandStream &commands = frameHandoff.beginWrite();
+        gameWorld.update(time, commands);
+        frameHandoff.publish();
+    }
+}
@@ -0,0 +1,68 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "game/GameWorld.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Rehnda {
+    GameWorld::GameWorld() : lights(createLights()) {}
+
+    void GameWorld::update(float time, RenderCommandStream &commands) {
+        commands.setCamera(RenderCamera{
+                .view = glm::lookAt(glm::vec3(2.0, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0, 0.0f, 1.0f)),
+                .fovY = glm::radians(45.f),
+        });
+        commands.setTransform(RenderTransform{
+                .transform = QUAD_TRANSFORM,
+                .position = glm::vec3(0.f),
+                .rotation = glm::angleAxis(time * glm::radians(90.f), glm::vec3(0.0, 0.0, 1.0f)),
+                .scale = glm::vec3(1.f),
+        });
+        animateLights(time);
+        commands.setLights(lights);
+    }
+
+    std::vector<PointLight> GameWorld::createLights() {
+        constexpr size_t LIGHT_COUNT = 256;
+        std::vector<PointLight> createdLights;
+        createdLights.reserve(LIGHT_COUNT);
+        for (size_t i = 0; i < LIGHT_COUNT; i++) {
+            const float t = static_cast<float>(i) / static_cast<float>(LIGHT_COUNT);
+            // spread the hues around the colour wheel so individual lights are easy to pick out
+            const float hue = t * 6.f;
+            const glm::vec3 color{
+                    std::clamp(std::abs(hue - 3.f) - 1.f, 0.f, 1.f),
+                    std::clamp(2.f - std::abs(hue - 2.f), 0.f, 1.f),
+                    std::clamp(2.f - std::abs(hue - 4.f), 0.f, 1.f),
+            };
+            createdLights.push_back(PointLight{
+                    .position = glm::vec3(0.f),
+                    .radius = 0.35f,
+                    .color = color,
+                    .intensity = 0.5f,
+            });
+        }
+        return createdLights;
+    }
+
+    void GameWorld::animateLights(float time) {
+        // lights orbit in a few rings at different heights and speeds
+        for (size_t i = 0; i < lights.size(); i++) {
+            const float t = static_cast<float>(i) / static_cast<float>(lights.size());
+            const size_t ring = i % 4;
+            const float ringRadius = 0.3f + 0.25f * static_cast<float>(ring);
+            const float angle = t * glm::radians(360.f) * 7.f + time * (0.5f + 0.2f * static_cast<float>(ring));
+            lights[i].position = glm::vec3(ringRadius * std::cos(angle), ringRadius * std::sin(angle),
+                                           0.15f - 0.2f * static_cast<float>(ring));
+        }
+    }
+}
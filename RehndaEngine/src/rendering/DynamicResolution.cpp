@@ -0,0 +1,65 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Rehnda {
+    DynamicResolution::DynamicResolution(const DynamicResolutionProps &props) :
+            props(props),
+            scale(props.maxScale) {
+        if (props.minScale <= 0.f || props.minScale > props.maxScale) {
+            throw std::runtime_error("Dynamic resolution needs 0 < minScale <= maxScale");
+        }
+    }
+
+    bool DynamicResolution::update(double gpuFrameMilliseconds) {
+        if (!props.enabled || gpuFrameMilliseconds <= 0.0) {
+            return false;
+        }
+        if (++framesSinceAdjustment < props.framesBetweenAdjustments) {
+            return false;
+        }
+
+        const double target = props.targetFrameMilliseconds;
+        const bool overTarget = gpuFrameMilliseconds > target;
+        const bool wellUnderTarget = gpuFrameMilliseconds < target * (1.0 - props.headroom);
+        if (!overTarget && !wellUnderTarget) {
+            return false;
+        }
+
+        // aim for the middle of the band rather than the target itself so the next frame isn't immediately back over
+        const double aim = target * (1.0 - props.headroom * 0.5);
+        const auto ideal = static_cast<float>(scale * std::sqrt(aim / gpuFrameMilliseconds));
+        const float stepped = std::clamp(ideal, scale - props.maxStep, scale + props.maxStep);
+        const float newScale = std::clamp(stepped, props.minScale, props.maxScale);
+        if (newScale == scale) {
+            return false;
+        }
+        scale = newScale;
+        framesSinceAdjustment = 0;
+        return true;
+    }
+
+    float DynamicResolution::getScale() const {
+        return scale;
+    }
+
+    vk::Extent2D DynamicResolution::getRenderExtent(vk::Extent2D outputExtent) const {
+        return scaleExtent(outputExtent, props.enabled ? scale : props.maxScale);
+    }
+
+    vk::Extent2D DynamicResolution::getMaxRenderExtent(vk::Extent2D outputExtent) const {
+        return scaleExtent(outputExtent, props.maxScale);
+    }
+
+    vk::Extent2D DynamicResolution::scaleExtent(vk::Extent2D extent, float scale) {
+        return {
+                .width = std::max(1u, static_cast<uint32_t>(static_cast<float>(extent.width) * scale)),
+                .height = std::max(1u, static_cast<uint32_t>(static_cast<float>(extent.height) * scale)),
+        };
+    }
+}
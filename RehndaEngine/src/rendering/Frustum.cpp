@@ -0,0 +1,48 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/Frustum.hpp"
+
+namespace Rehnda {
+    Frustum Frustum::fromMatrix(const glm::mat4 &clipMatrix) {
+        // Gribb/Hartmann plane extraction, glm is column major so row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+        const auto row = [&clipMatrix](int i) {
+            return glm::vec4(clipMatrix[0][i], clipMatrix[1][i], clipMatrix[2][i], clipMatrix[3][i]);
+        };
+        Frustum frustum{};
+        frustum.planes[LEFT_PLANE] = row(3) + row(0);
+        frustum.planes[RIGHT_PLANE] = row(3) - row(0);
+        frustum.planes[BOTTOM_PLANE] = row(3) + row(1);
+        frustum.planes[TOP_PLANE] = row(3) - row(1);
+        // with a [0, 1] depth range the near plane is just z >= 0
+        frustum.planes[NEAR_PLANE] = row(2);
+        frustum.planes[FAR_PLANE] = row(3) - row(2);
+        for (auto &plane: frustum.planes) {
+            plane /= glm::length(glm::vec3(plane.x, plane.y, plane.z));
+        }
+        return frustum;
+    }
+
+    bool Frustum::intersectsSphere(glm::vec3 center, float radius) const {
+        for (const auto &plane: planes) {
+            if (glm::dot(glm::vec3(plane.x, plane.y, plane.z), center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Frustum::intersectsAabb(glm::vec3 min, glm::vec3 max) const {
+        for (const auto &plane: planes) {
+            // test the corner furthest along the plane normal, if that is outside the whole box is
+            const glm::vec3 positiveCorner{plane.x >= 0 ? max.x : min.x,
+                                           plane.y >= 0 ? max.y : min.y,
+                                           plane.z >= 0 ? max.z : min.z};
+            if (glm::dot(glm::vec3(plane.x, plane.y, plane.z), positiveCorner) + plane.w < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,95 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/HiZPyramid.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace Rehnda {
+    void HiZPyramid::build(std::span<const float> depth, uint32_t width, uint32_t height, const glm::mat4 &viewProjection) {
+        this->viewProjection = viewProjection;
+        // reuse last frame's allocations, the extent rarely changes
+        const auto levelCount = static_cast<size_t>(std::bit_width(std::max(width, height)));
+        levels.resize(levelCount);
+        levels[0].width = width;
+        levels[0].height = height;
+        levels[0].maxDepth.assign(depth.begin(), depth.end());
+
+        for (size_t level = 1; level < levelCount; level++) {
+            const Level &source = levels[level - 1];
+            Level &target = levels[level];
+            target.width = std::max(1u, (source.width + 1) / 2);
+            target.height = std::max(1u, (source.height + 1) / 2);
+            target.maxDepth.resize(static_cast<size_t>(target.width) * target.height);
+            for (uint32_t y = 0; y < target.height; y++) {
+                // clamping means an odd sized source's last row/column is still covered
+                const uint32_t sourceY0 = std::min(y * 2, source.height - 1);
+                const uint32_t sourceY1 = std::min(y * 2 + 1, source.height - 1);
+                const float *row0 = &source.maxDepth[static_cast<size_t>(sourceY0) * source.width];
+                const float *row1 = &source.maxDepth[static_cast<size_t>(sourceY1) * source.width];
+                float *targetRow = &target.maxDepth[static_cast<size_t>(y) * target.width];
+                for (uint32_t x = 0; x < target.width; x++) {
+                    const uint32_t sourceX0 = std::min(x * 2, source.width - 1);
+                    const uint32_t sourceX1 = std::min(x * 2 + 1, source.width - 1);
+                    targetRow[x] = std::max(std::max(row0[sourceX0], row0[sourceX1]), std::max(row1[sourceX0], row1[sourceX1]));
+                }
+            }
+        }
+    }
+
+    void HiZPyramid::clear() {
+        levels.clear();
+    }
+
+    bool HiZPyramid::isEmpty() const {
+        return levels.empty();
+    }
+
+    bool HiZPyramid::isOccluded(const Aabb &worldBounds) const {
+        if (levels.empty()) {
+            return false;
+        }
+        const Level &base = levels[0];
+        glm::vec2 screenMin{std::numeric_limits<float>::max()};
+        glm::vec2 screenMax{std::numeric_limits<float>::lowest()};
+        float nearestDepth = 1.f;
+        for (uint32_t corner = 0; corner < 8; corner++) {
+            const glm::vec4 clip = viewProjection * glm::vec4(corner & 1 ? worldBounds.max.x : worldBounds.min.x,
+                                                              corner & 2 ? worldBounds.max.y : worldBounds.min.y,
+                                                              corner & 4 ? worldBounds.max.z : worldBounds.min.z, 1.f);
+            if (clip.w <= 0.f) {
+                return false;
+            }
+            const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            // ndc y is already flipped by the projection, so -1 is the top row
+            const glm::vec2 screen{(ndc.x * 0.5f + 0.5f) * static_cast<float>(base.width),
+                                   (ndc.y * 0.5f + 0.5f) * static_cast<float>(base.height)};
+            screenMin = glm::min(screenMin, screen);
+            screenMax = glm::max(screenMax, screen);
+            nearestDepth = std::min(nearestDepth, ndc.z);
+        }
+        if (screenMin.x < 0.f || screenMin.y < 0.f ||
+            screenMax.x >= static_cast<float>(base.width) || screenMax.y >= static_cast<float>(base.height)) {
+            return false;
+        }
+
+        const auto x0 = static_cast<uint32_t>(screenMin.x);
+        const auto y0 = static_cast<uint32_t>(screenMin.y);
+        const auto x1 = static_cast<uint32_t>(screenMax.x);
+        const auto y1 = static_cast<uint32_t>(screenMax.y);
+        // the level where the rect spans at most two texels each way
+        const uint32_t span = std::max(x1 - x0, y1 - y0);
+        const auto levelIndex = std::min<size_t>(static_cast<size_t>(std::bit_width(span)), levels.size() - 1);
+        const Level &level = levels[levelIndex];
+        float farthestOccluder = 0.f;
+        for (uint32_t y = y0 >> levelIndex; y <= std::min(y1 >> levelIndex, level.height - 1); y++) {
+            for (uint32_t x = x0 >> levelIndex; x <= std::min(x1 >> levelIndex, level.width - 1); x++) {
+                farthestOccluder = std::max(farthestOccluder, level.maxDepth[static_cast<size_t>(y) * level.width + x]);
+            }
+        }
+        return nearestDepth > farthestOccluder;
+    }
+}
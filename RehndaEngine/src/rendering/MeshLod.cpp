@@ -0,0 +1,105 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/MeshLod.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <meshoptimizer.h>
+#include <spdlog/spdlog.h>
+
+#include "rendering/MeshData.hpp"
+
+namespace Rehnda {
+    namespace MeshLods {
+        std::vector<MeshLod> build(MeshData &meshData, const MeshLodProps &props) {
+            std::vector<MeshLod> lods{{.firstIndex = 0, .indexCount = static_cast<uint32_t>(meshData.indices.size()), .error = 0.f}};
+            if (meshData.indices.empty()) {
+                return lods;
+            }
+            // simplifier errors are relative to the mesh extents, this converts them back to model space
+            const float errorScale = meshopt_simplifyScale(&meshData.vertices[0].pos.x, meshData.vertices.size(), sizeof(Vertex));
+            // a LOD that barely reduced the triangle count costs memory for no gain, usually means the simplifier hit the error limit
+            constexpr float MIN_USEFUL_REDUCTION = 0.85f;
+
+            std::vector<uint32_t> previousLod = meshData.indices;
+            while (lods.size() < props.maxLodCount) {
+                const size_t targetIndexCount = static_cast<size_t>(static_cast<float>(previousLod.size()) * props.reductionPerLod) / 3 * 3;
+                if (targetIndexCount < size_t{props.minTriangleCount} * 3) {
+                    break;
+                }
+                std::vector<uint32_t> simplified(previousLod.size());
+                float resultError = 0.f;
+                const size_t simplifiedCount = meshopt_simplify(simplified.data(), previousLod.data(), previousLod.size(),
+                                                                &meshData.vertices[0].pos.x, meshData.vertices.size(),
+                                                                sizeof(Vertex), targetIndexCount, props.maxRelativeError,
+                                                                0, &resultError);
+                if (simplifiedCount == 0 ||
+                    static_cast<float>(simplifiedCount) > static_cast<float>(previousLod.size()) * MIN_USEFUL_REDUCTION) {
+                    break;
+                }
+                simplified.resize(simplifiedCount);
+                std::vector<uint32_t> cacheOrdered(simplifiedCount);
+                meshopt_optimizeVertexCache(cacheOrdered.data(), simplified.data(), simplifiedCount, meshData.vertices.size());
+
+                // each LOD is simplified from the last, so errors stack
+                lods.push_back({
+                        .firstIndex = static_cast<uint32_t>(meshData.indices.size()),
+                        .indexCount = static_cast<uint32_t>(simplifiedCount),
+                        .error = lods.back().error + resultError * errorScale,
+                });
+                meshData.indices.insert(meshData.indices.end(), cacheOrdered.begin(), cacheOrdered.end());
+                previousLod = std::move(cacheOrdered);
+            }
+            SPDLOG_INFO("Built {} LODs, coarsest has {} of {} tris", lods.size(), lods.back().indexCount / 3, lods.front().indexCount / 3);
+            return lods;
+        }
+
+        MeshBounds computeBounds(std::span<const Vertex> vertices) {
+            if (vertices.empty()) {
+                return {};
+            }
+            glm::vec3 min{std::numeric_limits<float>::max()};
+            glm::vec3 max{std::numeric_limits<float>::lowest()};
+            for (const auto &vertex: vertices) {
+                min = glm::min(min, vertex.pos);
+                max = glm::max(max, vertex.pos);
+            }
+            const glm::vec3 center = (min + max) * 0.5f;
+            float radius = 0.f;
+            for (const auto &vertex: vertices) {
+                radius = std::max(radius, glm::distance(center, vertex.pos));
+            }
+            return {.center = center, .radius = radius};
+        }
+    }
+
+    LodSelector::LodSelector(std::span<const MeshLod> lods, LodSelectionProps props) : props(props) {
+        lodErrors.reserve(lods.size());
+        for (const auto &lod: lods) {
+            lodErrors.push_back(lod.error);
+        }
+    }
+
+    /**
+     * Error projects to error * projectionScale / distance pixels. Moving to a coarser LOD needs its error to be comfortably under
+     * the threshold and moving back to a finer one waits until the current LOD is comfortably over it, so a mesh sitting at
+     * the threshold distance doesn't flip between LODs every frame.
+     */
+    uint32_t LodSelector::select(float distance, float projectionScale, uint32_t previousLod) const {
+        const float pixelsPerUnit = projectionScale / std::max(distance, std::numeric_limits<float>::epsilon());
+        const float refineAbove = props.maxPixelError * (1.f + props.hysteresis);
+        const float coarsenBelow = props.maxPixelError * (1.f - props.hysteresis);
+
+        uint32_t currentLod = std::min<uint32_t>(previousLod, static_cast<uint32_t>(lodErrors.size()) - 1);
+        while (currentLod > 0 && lodErrors[currentLod] * pixelsPerUnit > refineAbove) {
+            currentLod--;
+        }
+        while (currentLod + 1 < lodErrors.size() && lodErrors[currentLod + 1] * pixelsPerUnit < coarsenBelow) {
+            currentLod++;
+        }
+        return currentLod;
+    }
+}
@@ -0,0 +1,73 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/MeshOptimizer.hpp"
+
+#include <limits>
+
+#include <meshoptimizer.h>
+#include <spdlog/spdlog.h>
+
+namespace Rehnda::MeshOptimizer {
+    namespace {
+        struct Analysis {
+            float acmr;
+            float atvr;
+            float overdraw;
+        };
+
+        Analysis analyze(const MeshData &meshData, uint32_t vertexCacheSize) {
+            const auto cacheStats = meshopt_analyzeVertexCache(meshData.indices.data(), meshData.indices.size(),
+                                                               meshData.vertices.size(), vertexCacheSize, 0, 0);
+            const auto overdrawStats = meshopt_analyzeOverdraw(meshData.indices.data(), meshData.indices.size(),
+                                                               &meshData.vertices[0].pos.x, meshData.vertices.size(),
+                                                               sizeof(Vertex));
+            return {
+                    .acmr = cacheStats.acmr,
+                    .atvr = cacheStats.atvr,
+                    .overdraw = overdrawStats.overdraw,
+            };
+        }
+    }
+
+    MeshOptimizationStats optimize(MeshData &meshData, const MeshOptimizerProps &props) {
+        if (meshData.indices.empty() || meshData.vertices.empty()) {
+            return {};
+        }
+        const Analysis before = analyze(meshData, props.vertexCacheSize);
+
+        const size_t indexCount = meshData.indices.size();
+        const size_t vertexCount = meshData.vertices.size();
+        std::vector<uint32_t> reordered(indexCount);
+
+        meshopt_optimizeVertexCache(reordered.data(), meshData.indices.data(), indexCount, vertexCount);
+        meshopt_optimizeOverdraw(meshData.indices.data(), reordered.data(), indexCount, &meshData.vertices[0].pos.x,
+                                 vertexCount, sizeof(Vertex), props.overdrawThreshold);
+
+        // rewrites the index buffer in place to point at the reordered vertices, unreferenced vertices get dropped
+        std::vector<Vertex> fetchOrderedVertices(vertexCount);
+        const size_t usedVertexCount = meshopt_optimizeVertexFetch(fetchOrderedVertices.data(), meshData.indices.data(),
+                                                                   indexCount, meshData.vertices.data(), vertexCount,
+                                                                   sizeof(Vertex));
+        fetchOrderedVertices.resize(usedVertexCount);
+        meshData.vertices = std::move(fetchOrderedVertices);
+
+        const Analysis after = analyze(meshData, props.vertexCacheSize);
+        SPDLOG_INFO("Optimized mesh ({} tris, {} verts): ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, overdraw {:.3f} -> {:.3f}",
+                    indexCount / 3, usedVertexCount, before.acmr, after.acmr, before.atvr, after.atvr,
+                    before.overdraw, after.overdraw);
+        return {
+                .acmrBefore = before.acmr,
+                .acmrAfter = after.acmr,
+                .atvrBefore = before.atvr,
+                .atvrAfter = after.atvr,
+                .overdrawBefore = before.overdraw,
+                .overdrawAfter = after.overdraw,
+        };
+    }
+
+    bool fitsUint16Indices(size_t vertexCount) {
+        return vertexCount <= std::numeric_limits<uint16_t>::max() + size_t{1};
+    }
+}
@@ -0,0 +1,172 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/Meshlets.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <meshoptimizer.h>
+
+#include "rendering/MeshData.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define REHNDA_MESHLET_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Rehnda {
+    namespace Meshlets {
+        std::vector<Meshlet> build(MeshData &meshData) {
+            if (meshData.indices.empty()) {
+                return {};
+            }
+            // 0 favours tight bounding spheres, 1 favours tight normal cones, in between gives meshlets good at both
+            constexpr float CONE_WEIGHT = 0.25f;
+
+            const size_t maxMeshlets = meshopt_buildMeshletsBound(meshData.indices.size(), MAX_VERTICES, MAX_TRIANGLES);
+            std::vector<meshopt_Meshlet> builtMeshlets(maxMeshlets);
+            std::vector<uint32_t> meshletVertices(maxMeshlets * MAX_VERTICES);
+            std::vector<uint8_t> meshletTriangles(maxMeshlets * MAX_TRIANGLES * 3);
+            const size_t meshletCount = meshopt_buildMeshlets(builtMeshlets.data(), meshletVertices.data(),
+                                                              meshletTriangles.data(), meshData.indices.data(),
+                                                              meshData.indices.size(), &meshData.vertices[0].pos.x,
+                                                              meshData.vertices.size(), sizeof(Vertex),
+                                                              MAX_VERTICES, MAX_TRIANGLES, CONE_WEIGHT);
+
+            // meshlet triangles index into a per meshlet vertex list, flatten them back into one global index buffer
+            // with each meshlet's triangles next to each other
+            std::vector<uint32_t> meshletOrderedIndices;
+            meshletOrderedIndices.reserve(meshData.indices.size());
+            std::vector<Meshlet> meshlets;
+            meshlets.reserve(meshletCount);
+            for (size_t i = 0; i < meshletCount; i++) {
+                const auto &built = builtMeshlets[i];
+                const uint32_t *localVertices = &meshletVertices[built.vertex_offset];
+                const uint8_t *localTriangles = &meshletTriangles[built.triangle_offset];
+                const auto firstIndex = static_cast<uint32_t>(meshletOrderedIndices.size());
+                for (size_t t = 0; t < built.triangle_count * 3; t++) {
+                    meshletOrderedIndices.push_back(localVertices[localTriangles[t]]);
+                }
+
+                const meshopt_Bounds bounds = meshopt_computeMeshletBounds(localVertices, localTriangles,
+                                                                           built.triangle_count,
+                                                                           &meshData.vertices[0].pos.x,
+                                                                           meshData.vertices.size(), sizeof(Vertex));
+                meshlets.push_back(Meshlet{
+                        .firstIndex = firstIndex,
+                        .indexCount = built.triangle_count * 3,
+                        .center = {bounds.center[0], bounds.center[1], bounds.center[2]},
+                        .radius = bounds.radius,
+                        .coneAxis = {bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]},
+                        .coneCutoff = bounds.cone_cutoff,
+                });
+            }
+            meshData.indices = std::move(meshletOrderedIndices);
+            return meshlets;
+        }
+    }
+
+    MeshletCuller::MeshletCuller(std::span<const Meshlet> meshlets) : meshletCount(meshlets.size()) {
+        const size_t paddedCount = (meshletCount + 3) & ~size_t{3};
+        meshletRanges.reserve(meshletCount);
+        for (auto *column: {&centerX, &centerY, &centerZ, &radius, &coneAxisX, &coneAxisY, &coneAxisZ}) {
+            column->resize(paddedCount, 0.f);
+        }
+        // a cutoff of 1 can never cull by cone, the padding lanes are masked off anyway
+        coneCutoff.resize(paddedCount, 1.f);
+
+        for (size_t i = 0; i < meshletCount; i++) {
+            const auto &meshlet = meshlets[i];
+            meshletRanges.push_back({meshlet.firstIndex, meshlet.indexCount});
+            centerX[i] = meshlet.center.x;
+            centerY[i] = meshlet.center.y;
+            centerZ[i] = meshlet.center.z;
+            radius[i] = meshlet.radius;
+            coneAxisX[i] = meshlet.coneAxis.x;
+            coneAxisY[i] = meshlet.coneAxis.y;
+            coneAxisZ[i] = meshlet.coneAxis.z;
+            coneCutoff[i] = meshlet.coneCutoff;
+        }
+        visibleRanges.reserve(meshletCount);
+    }
+
+    std::span<const IndexRange> MeshletCuller::cull(const MeshViewContext &context) {
+        visibleRanges.clear();
+        for (size_t first = 0; first < meshletCount; first += 4) {
+            uint32_t visibleMask = testFour(first, context);
+            const size_t lanes = std::min<size_t>(4, meshletCount - first);
+            for (size_t lane = 0; lane < lanes; lane++) {
+                if ((visibleMask & (1u << lane)) == 0) {
+                    continue;
+                }
+                const IndexRange &range = meshletRanges[first + lane];
+                // meshlets are stored back to back so neighbouring survivors collapse into one draw
+                if (!visibleRanges.empty() &&
+                    visibleRanges.back().firstIndex + visibleRanges.back().indexCount == range.firstIndex) {
+                    visibleRanges.back().indexCount += range.indexCount;
+                } else {
+                    visibleRanges.push_back(range);
+                }
+            }
+        }
+        return visibleRanges;
+    }
+
+    size_t MeshletCuller::getMeshletCount() const {
+        return meshletCount;
+    }
+
+    /**
+     * A meshlet is visible if its sphere is inside all six planes and the camera isn't inside its backface cone. The cone test is
+     * the sphere based one from meshoptimizer: cull if dot(center - camera, axis) >= cutoff * |center - camera| + radius,
+     * which is conservative for every point in the bounding sphere so it doesn't need the cone apex.
+     */
+    uint32_t MeshletCuller::testFour(size_t first, const MeshViewContext &context) const {
+#ifdef REHNDA_MESHLET_SSE
+        const __m128 cx = _mm_loadu_ps(&centerX[first]);
+        const __m128 cy = _mm_loadu_ps(&centerY[first]);
+        const __m128 cz = _mm_loadu_ps(&centerZ[first]);
+        const __m128 r = _mm_loadu_ps(&radius[first]);
+        const __m128 negativeR = _mm_sub_ps(_mm_setzero_ps(), r);
+
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const auto &plane: context.frustum.planes) {
+            const __m128 distance = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_mul_ps(cy, _mm_set1_ps(plane.y))),
+                    _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negativeR));
+        }
+
+        const __m128 dx = _mm_sub_ps(cx, _mm_set1_ps(context.cameraPosition.x));
+        const __m128 dy = _mm_sub_ps(cy, _mm_set1_ps(context.cameraPosition.y));
+        const __m128 dz = _mm_sub_ps(cz, _mm_set1_ps(context.cameraPosition.z));
+        const __m128 distanceToCamera = _mm_sqrt_ps(
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+        const __m128 alongAxis = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(&coneAxisX[first])), _mm_mul_ps(dy, _mm_loadu_ps(&coneAxisY[first]))),
+                _mm_mul_ps(dz, _mm_loadu_ps(&coneAxisZ[first])));
+        const __m128 coneLimit = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&coneCutoff[first]), distanceToCamera), r);
+        visible = _mm_and_ps(visible, _mm_cmplt_ps(alongAxis, coneLimit));
+
+        return static_cast<uint32_t>(_mm_movemask_ps(visible));
+#else
+        uint32_t visibleMask = 0;
+        for (size_t lane = 0; lane < 4; lane++) {
+            const size_t i = first + lane;
+            const glm::vec3 center{centerX[i], centerY[i], centerZ[i]};
+            if (!context.frustum.intersectsSphere(center, radius[i])) {
+                continue;
+            }
+            const glm::vec3 toMeshlet = center - context.cameraPosition;
+            const glm::vec3 axis{coneAxisX[i], coneAxisY[i], coneAxisZ[i]};
+            if (glm::dot(toMeshlet, axis) >= coneCutoff[i] * glm::length(toMeshlet) + radius[i]) {
+                continue;
+            }
+            visibleMask |= 1u << lane;
+        }
+        return visibleMask;
+#endif
+    }
+}
@@ -0,0 +1,26 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/PackedVertex.hpp"
+#include "rendering/VertexQuantization.hpp"
+
+namespace Rehnda {
+    PackedVertex PackedVertex::pack(const Vertex &vertex) {
+        using namespace VertexQuantization;
+        return {
+                .pos = {toHalf(vertex.pos.x), toHalf(vertex.pos.y), toHalf(vertex.pos.z), toHalf(1.0f)},
+                .color = {toUnorm8(vertex.color.x), toUnorm8(vertex.color.y), toUnorm8(vertex.color.z), toUnorm8(1.0f)},
+                .texCoord = {toHalf(vertex.texCoord.x), toHalf(vertex.texCoord.y)},
+        };
+    }
+
+    std::vector<PackedVertex> PackedVertex::packAll(std::span<const Vertex> vertices) {
+        std::vector<PackedVertex> packed;
+        packed.reserve(vertices.size());
+        for (const auto &vertex: vertices) {
+            packed.push_back(pack(vertex));
+        }
+        return packed;
+    }
+}
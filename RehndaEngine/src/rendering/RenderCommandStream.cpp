@@ -0,0 +1,92 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/RenderCommandStream.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace Rehnda {
+    namespace {
+        constexpr size_t alignUp(size_t value, size_t alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    RenderCommandStream::RenderCommandStream(size_t capacityBytes) :
+            capacity(alignUp(capacityBytes, COMMAND_ALIGNMENT)),
+            // new[] of bytes is aligned to at least 16 which covers COMMAND_ALIGNMENT
+            buffer(std::make_unique<std::byte[]>(capacity)) {
+    }
+
+    void RenderCommandStream::clear() {
+        used = 0;
+    }
+
+    void RenderCommandStream::setCamera(const RenderCamera &camera) {
+        write(CommandType::CAMERA, &camera, sizeof(camera));
+    }
+
+    void RenderCommandStream::setTransform(const RenderTransform &transform) {
+        write(CommandType::TRANSFORM, &transform, sizeof(transform));
+    }
+
+    void RenderCommandStream::setLights(std::span<const PointLight> lights) {
+        write(CommandType::LIGHTS, lights.data(), lights.size_bytes());
+    }
+
+    void RenderCommandStream::write(CommandType type, const void *payload, size_t payloadSize) {
+        const size_t payloadOffset = alignUp(used + sizeof(CommandHeader), COMMAND_ALIGNMENT);
+        const size_t end = alignUp(payloadOffset + payloadSize, COMMAND_ALIGNMENT);
+        if (end > capacity) {
+            // growing would mean allocating mid frame, better to find out the capacity is too small
+            throw std::runtime_error("Render command stream is full, it needs more than " + std::to_string(capacity) + " bytes");
+        }
+        const CommandHeader header{.type = type, .payloadSize = static_cast<uint32_t>(payloadSize)};
+        std::memcpy(buffer.get() + used, &header, sizeof(header));
+        if (payloadSize > 0) {
+            std::memcpy(buffer.get() + payloadOffset, payload, payloadSize);
+        }
+        used = end;
+    }
+
+    RenderCommandStream::Reader RenderCommandStream::read() const {
+        return Reader{*this};
+    }
+
+    size_t RenderCommandStream::size() const {
+        return used;
+    }
+
+    RenderCommandStream::Reader::Reader(const RenderCommandStream &stream) : stream(stream) {}
+
+    std::optional<RenderCommand> RenderCommandStream::Reader::next() {
+        if (offset >= stream.used) {
+            return std::nullopt;
+        }
+        CommandHeader header{};
+        std::memcpy(&header, stream.buffer.get() + offset, sizeof(header));
+        const size_t payloadOffset = alignUp(offset + sizeof(CommandHeader), COMMAND_ALIGNMENT);
+        const std::byte *payload = stream.buffer.get() + payloadOffset;
+        offset = alignUp(payloadOffset + header.payloadSize, COMMAND_ALIGNMENT);
+
+        switch (header.type) {
+            case CommandType::CAMERA: {
+                RenderCamera camera{};
+                std::memcpy(&camera, payload, sizeof(camera));
+                return camera;
+            }
+            case CommandType::TRANSFORM: {
+                RenderTransform transform{};
+                std::memcpy(&transform, payload, sizeof(transform));
+                return transform;
+            }
+            case CommandType::LIGHTS:
+                return std::span<const PointLight>(reinterpret_cast<const PointLight *>(payload),
+                                                   header.payloadSize / sizeof(PointLight));
+        }
+        throw std::runtime_error("Unknown render command");
+    }
+}
@@ -0,0 +1,63 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/RenderFrameHandoff.hpp"
+
+namespace Rehnda {
+    RenderFrameHandoff::RenderFrameHandoff(size_t streamCapacityBytes) :
+            streams{RenderCommandStream{streamCapacityBytes}, RenderCommandStream{streamCapacityBytes}} {
+    }
+
+    RenderCommandStream &RenderFrameHandoff::beginWrite() {
+        // only the game thread publishes, so this is the frame about to be written
+        const uint64_t frame = publishedFrames.load(std::memory_order_relaxed);
+        // the stream was last used for frame - 2, which the render thread has to be done with
+        uint64_t released = releasedFrames.load(std::memory_order_acquire);
+        while (released + streams.size() <= frame && !isClosed()) {
+            releasedFrames.wait(released, std::memory_order_acquire);
+            released = releasedFrames.load(std::memory_order_acquire);
+        }
+        RenderCommandStream &stream = streams[frame % streams.size()];
+        stream.clear();
+        return stream;
+    }
+
+    void RenderFrameHandoff::publish() {
+        publishedFrames.fetch_add(1, std::memory_order_release);
+        publishedFrames.notify_one();
+    }
+
+    const RenderCommandStream *RenderFrameHandoff::acquire() {
+        // only the render thread releases, so this is the frame to read next
+        const uint64_t frame = releasedFrames.load(std::memory_order_relaxed);
+        uint64_t published = publishedFrames.load(std::memory_order_acquire);
+        while (published <= frame) {
+            if (isClosed()) {
+                return nullptr;
+            }
+            publishedFrames.wait(published, std::memory_order_acquire);
+            published = publishedFrames.load(std::memory_order_acquire);
+        }
+        return isClosed() ? nullptr : &streams[frame % streams.size()];
+    }
+
+    void RenderFrameHandoff::release() {
+        releasedFrames.fetch_add(1, std::memory_order_release);
+        releasedFrames.notify_one();
+    }
+
+    void RenderFrameHandoff::close() {
+        closed.store(true, std::memory_order_release);
+        // atomic waits only return once the value changes, so bump both counters to get anyone blocked out of their wait.
+        // Nothing reads the streams after close, so the extra frames don't matter
+        publishedFrames.fetch_add(1, std::memory_order_release);
+        publishedFrames.notify_all();
+        releasedFrames.fetch_add(1, std::memory_order_release);
+        releasedFrames.notify_all();
+    }
+
+    bool RenderFrameHandoff::isClosed() const {
+        return closed.load(std::memory_order_acquire);
+    }
+}
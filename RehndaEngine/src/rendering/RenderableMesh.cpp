@@ -6,32 +6,92 @@
 
 namespace Rehnda {
 
-    RenderableMesh::RenderableMesh(const DeviceContext &deviceContext, const std::vector<Vertex> &vertices,
-                                   const std::vector<uint16_t> &indices) :
+    RenderableMesh::RenderableMesh(const DeviceContext &deviceContext, std::span<const std::byte> vertexBytes,
+                                   std::span<const std::byte> indexBytes, uint32_t indicesCount,
+                                   vk::IndexType indexType, std::span<const Meshlet> meshlets,
+                                   std::span<const MeshLod> lods, MeshBounds bounds) :
             vertexBuffer(
-                    deviceContext.device, deviceContext.physicalDevice, deviceContext.memoryCommandPool,
-                    deviceContext.graphicsQueue, StagedBufferProps{
-                            .data = vertices.data(),
-                            .dataSize = sizeof(vertices[0]) * vertices.size(),
-                            .bufferUsageFlags = vk::BufferUsageFlagBits::eVertexBuffer
+                    deviceContext.device, deviceContext.physicalDevice, deviceContext.uploadQueue, StagedBufferProps{
+                            .data = vertexBytes.data(),
+                            .dataSize = vertexBytes.size(),
+                            .bufferUsageFlags = vk::BufferUsageFlagBits::eVertexBuffer,
+                            .firstUsage = BufferUsage::VERTEX,
                     }),
-            indexBuffer(deviceContext.device, deviceContext.physicalDevice, deviceContext.memoryCommandPool,
-                        deviceContext.graphicsQueue, StagedBufferProps{
-                            .data = indices.data(),
-                            .dataSize = sizeof(indices[0]) * indices.size(),
-                            .bufferUsageFlags = vk::BufferUsageFlagBits::eIndexBuffer
+            indexBuffer(deviceContext.device, deviceContext.physicalDevice, deviceContext.uploadQueue, StagedBufferProps{
+                            .data = indexBytes.data(),
+                            .dataSize = indexBytes.size(),
+                            .bufferUsageFlags = vk::BufferUsageFlagBits::eIndexBuffer,
+                            .firstUsage = BufferUsage::INDEX,
                     }),
-            indicesCount(indices.size()) {
+            // the index buffer also holds the coarser LODs, a plain draw is only LOD 0
+            indicesCount(lods.empty() ? indicesCount : lods.front().indexCount),
+            indexType(indexType),
+            lods(lods.begin(), lods.end()),
+            bounds(bounds) {
+        if (!meshlets.empty()) {
+            meshletCuller.emplace(meshlets);
+        }
+        if (lods.size() > 1) {
+            lodSelector.emplace(lods);
+        }
     }
 
-    void RenderableMesh::draw(vkr::CommandBuffer &commandBuffer) const {
+    RenderableMesh::RenderableMesh(const DeviceContext &deviceContext, const CachedMesh &cachedMesh) :
+            RenderableMesh(deviceContext, std::as_bytes(cachedMesh.getVertices()), cachedMesh.getIndexBytes(),
+                           cachedMesh.getIndexCount(), cachedMesh.getIndexType(), cachedMesh.getMeshlets(), cachedMesh.getLods(),
+                           cachedMesh.getBounds()) {
+    }
+
+    uint32_t RenderableMesh::draw(vkr::CommandBuffer &commandBuffer, uint32_t firstInstance) const {
+        bindBuffers(commandBuffer);
+
+        // indices count, instance count
+        commandBuffer.drawIndexed(indicesCount, 1, 0, 0, firstInstance);
+        return 1;
+    }
+
+    uint32_t RenderableMesh::selectLod(const MeshViewContext &viewContext, uint32_t previousLod) const {
+        if (!lodSelector || bounds.radius <= 0.f) {
+            return 0;
+        }
+        const float distance = glm::distance(viewContext.cameraPosition, bounds.center) - bounds.radius;
+        return lodSelector->select(distance, viewContext.projectionScale, previousLod);
+    }
+
+    uint32_t RenderableMesh::draw(vkr::CommandBuffer &commandBuffer, const MeshViewContext &viewContext, uint32_t lod,
+                                  uint32_t firstInstance) {
+        // meshes built from raw vertices have no bounds, they're always drawn
+        const bool hasBounds = bounds.radius > 0.f;
+        if (hasBounds && !viewContext.frustum.intersectsSphere(bounds.center, bounds.radius)) {
+            return 0;
+        }
+
+        if (lod > 0 && lod < lods.size()) {
+            // coarse LODs are small enough that meshlet culling them isn't worth it
+            bindBuffers(commandBuffer);
+            commandBuffer.drawIndexed(lods[lod].indexCount, 1, lods[lod].firstIndex, 0, firstInstance);
+            return 1;
+        }
+
+        if (!meshletCuller) {
+            return draw(commandBuffer, firstInstance);
+        }
+        const auto visibleRanges = meshletCuller->cull(viewContext);
+        if (visibleRanges.empty()) {
+            return 0;
+        }
+        bindBuffers(commandBuffer);
+        for (const auto &range: visibleRanges) {
+            commandBuffer.drawIndexed(range.indexCount, 1, range.firstIndex, 0, firstInstance);
+        }
+        return static_cast<uint32_t>(visibleRanges.size());
+    }
+
+    void RenderableMesh::bindBuffers(vkr::CommandBuffer &commandBuffer) const {
         vk::Buffer vertexBuffers[] = {*vertexBuffer.getBuffer()};
         vk::DeviceSize offsets[] = {0};
         commandBuffer.bindVertexBuffers(0, vertexBuffers, offsets);
 
-        commandBuffer.bindIndexBuffer(*indexBuffer.getBuffer(), 0, vk::IndexType::eUint16);
-
-        // indices count, instance count
-        commandBuffer.drawIndexed(indicesCount, 1, 0, 0, 0);
+        commandBuffer.bindIndexBuffer(*indexBuffer.getBuffer(), 0, indexType);
     }
 }
\ No newline at end of file
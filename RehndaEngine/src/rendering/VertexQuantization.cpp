@@ -0,0 +1,17 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/VertexQuantization.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+namespace Rehnda::VertexQuantization {
+    uint16_t toHalf(float value) {
+        return glm::packHalf1x16(value);
+    }
+
+    uint8_t toUnorm8(float value) {
+        return glm::packUnorm1x8(value);
+    }
+}
@@ -0,0 +1,178 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/AttachmentAllocator.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include <spdlog/spdlog.h>
+
+#include "rendering/vulkan/BufferHelper.hpp"
+
+namespace Rehnda {
+    namespace {
+        constexpr vk::MemoryPropertyFlags LAZY_MEMORY =
+                vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated;
+
+        bool lifetimesOverlap(const AttachmentDescription &a, const AttachmentDescription &b) {
+            return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+        }
+    }
+
+    AttachmentAllocator::AttachmentAllocator(vkr::Device &device, vkr::PhysicalDevice &physicalDevice) :
+            device(device),
+            physicalDevice(physicalDevice),
+            supportsLazyMemory(BufferHelper::hasMemoryType(physicalDevice, LAZY_MEMORY)) {
+    }
+
+    AttachmentHandle AttachmentAllocator::add(const AttachmentDescription &description) {
+        const bool lazilyAllocated = description.transient && supportsLazyMemory;
+        vk::ImageCreateInfo imageCreateInfo{
+                .imageType = vk::ImageType::e2D,
+                .format = description.format,
+                .extent = {
+                        .width = description.extent.width,
+                        .height = description.extent.height,
+                        .depth = 1,
+                },
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = vk::SampleCountFlagBits::e1,
+                .tiling = vk::ImageTiling::eOptimal,
+                .usage = description.usage | (lazilyAllocated ? vk::ImageUsageFlags{vk::ImageUsageFlagBits::eTransientAttachment} : vk::ImageUsageFlags{}),
+                .sharingMode = vk::SharingMode::eExclusive,
+                .initialLayout = vk::ImageLayout::eUndefined,
+        };
+        vkr::Image image{device, imageCreateInfo};
+        const vk::MemoryRequirements requirements = image.getMemoryRequirements();
+        attachments.push_back(Attachment{
+                .description = description,
+                .image = std::move(image),
+                .imageView = nullptr,
+                .requirements = requirements,
+                .lazilyAllocated = lazilyAllocated,
+                .memoryBlock = std::nullopt,
+        });
+        return static_cast<AttachmentHandle>(attachments.size() - 1);
+    }
+
+    bool AttachmentAllocator::fitsBlock(const MemoryBlock &block, const Attachment &attachment) const {
+        if ((block.memoryTypeBits & attachment.requirements.memoryTypeBits) == 0) {
+            return false;
+        }
+        return std::none_of(block.attachments.begin(), block.attachments.end(), [&](size_t other) {
+            return lifetimesOverlap(attachments[other].description, attachment.description);
+        });
+    }
+
+    void AttachmentAllocator::allocate() {
+        stats = {};
+        memoryBlockCount = 0;
+        std::vector<MemoryBlock> blocks;
+
+        // biggest first so smaller attachments slot into the blocks the big ones already need
+        std::vector<size_t> order(attachments.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return attachments[a].requirements.size > attachments[b].requirements.size;
+        });
+
+        for (const size_t index: order) {
+            Attachment &attachment = attachments[index];
+            stats.requestedBytes += attachment.requirements.size;
+            if (attachment.lazilyAllocated) {
+                // each gets its own allocation, there's nothing to gain sharing memory that's never committed
+                vkr::DeviceMemory memory{device, vk::MemoryAllocateInfo{
+                        .allocationSize = attachment.requirements.size,
+                        .memoryTypeIndex = BufferHelper::findMemoryType(physicalDevice, attachment.requirements.memoryTypeBits, LAZY_MEMORY),
+                }};
+                attachment.image.bindMemory(*memory, 0);
+                memories.push_back(std::move(memory));
+                stats.lazilyAllocatedBytes += attachment.requirements.size;
+                continue;
+            }
+
+            auto block = std::find_if(blocks.begin(), blocks.end(), [&](const MemoryBlock &candidate) {
+                return fitsBlock(candidate, attachment);
+            });
+            if (block == blocks.end()) {
+                blocks.push_back(MemoryBlock{
+                        .size = 0,
+                        .memoryTypeBits = attachment.requirements.memoryTypeBits,
+                        .attachments = {},
+                });
+                block = blocks.end() - 1;
+            }
+            block->size = std::max(block->size, attachment.requirements.size);
+            block->memoryTypeBits &= attachment.requirements.memoryTypeBits;
+            block->attachments.push_back(index);
+        }
+
+        for (const MemoryBlock &block: blocks) {
+            vkr::DeviceMemory memory{device, vk::MemoryAllocateInfo{
+                    .allocationSize = block.size,
+                    .memoryTypeIndex = BufferHelper::findMemoryType(physicalDevice, block.memoryTypeBits,
+                                                                    vk::MemoryPropertyFlagBits::eDeviceLocal),
+            }};
+            // every attachment in a block starts at offset 0, which satisfies any alignment
+            for (const size_t index: block.attachments) {
+                attachments[index].image.bindMemory(*memory, 0);
+                attachments[index].memoryBlock = memoryBlockCount;
+            }
+            memoryBlockCount++;
+            memories.push_back(std::move(memory));
+            stats.allocatedBytes += block.size;
+        }
+
+        for (Attachment &attachment: attachments) {
+            attachment.imageView = vkr::ImageView{device, vk::ImageViewCreateInfo{
+                    .image = *attachment.image,
+                    .viewType = vk::ImageViewType::e2D,
+                    .format = attachment.description.format,
+                    .subresourceRange = {
+                            .aspectMask = attachment.description.aspect,
+                            .baseMipLevel = 0,
+                            .levelCount = 1,
+                            .baseArrayLayer = 0,
+                            .layerCount = 1,
+                    },
+            }};
+        }
+
+        SPDLOG_INFO("Attachments: {} requested {:.2f}MB, allocated {:.2f}MB device local + {:.2f}MB lazily allocated, saved {:.2f}MB",
+                    attachments.size(), static_cast<double>(stats.requestedBytes) / (1024.0 * 1024.0),
+                    static_cast<double>(stats.allocatedBytes) / (1024.0 * 1024.0),
+                    static_cast<double>(stats.lazilyAllocatedBytes) / (1024.0 * 1024.0),
+                    static_cast<double>(stats.requestedBytes - stats.allocatedBytes) / (1024.0 * 1024.0));
+    }
+
+    void AttachmentAllocator::clear() {
+        // views and images before the memory they're bound to
+        attachments.clear();
+        memories.clear();
+        memoryBlockCount = 0;
+        stats = {};
+    }
+
+    const vkr::Image &AttachmentAllocator::getImage(AttachmentHandle handle) const {
+        return attachments[handle].image;
+    }
+
+    const vkr::ImageView &AttachmentAllocator::getImageView(AttachmentHandle handle) const {
+        return attachments[handle].imageView;
+    }
+
+    std::optional<uint32_t> AttachmentAllocator::getMemoryBlock(AttachmentHandle handle) const {
+        return attachments[handle].memoryBlock;
+    }
+
+    uint32_t AttachmentAllocator::getMemoryBlockCount() const {
+        return memoryBlockCount;
+    }
+
+    const AttachmentMemoryStats &AttachmentAllocator::getStats() const {
+        return stats;
+    }
+}
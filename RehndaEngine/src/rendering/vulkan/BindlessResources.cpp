@@ -0,0 +1,130 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/BindlessResources.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace Rehnda {
+    static_assert(sizeof(MaterialRecord) == 16, "MaterialRecord must match the std430 struct in the shaders");
+    static_assert(sizeof(ObjectRecord) == 80, "ObjectRecord must match the std430 struct in the shaders");
+
+    BindlessResources::BindlessResources(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, PipelineLayoutCache &layoutCache,
+                                         const ShaderReflection &shaders, const BindlessResourcesProps &props) :
+            device(device),
+            props(clampToLimits(physicalDevice, props)),
+            setLayout(layoutCache.getSetLayout(DescriptorSetLayoutDesc::fromReflection(shaders, BINDLESS_SET, this->props.maxTextures))),
+            descriptorPool(createDescriptorPool()),
+            descriptorSet(createDescriptorSet()),
+            materialBuffer(device, physicalDevice, WritableDirectBufferProps{
+                    .dataSize = static_cast<vk::DeviceSize>(this->props.maxMaterials) * sizeof(MaterialRecord),
+                    .bufferUsageFlags = vk::BufferUsageFlagBits::eStorageBuffer,
+            }) {
+        // the materials buffer never moves, so its descriptor is written once up front
+        const vk::DescriptorBufferInfo materialsInfo{.buffer = *materialBuffer.getBuffer(), .offset = 0, .range = VK_WHOLE_SIZE};
+        device.updateDescriptorSets(vk::WriteDescriptorSet{
+                .dstSet = *descriptorSet,
+                .dstBinding = MATERIALS_BINDING,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType = vk::DescriptorType::eStorageBuffer,
+                .pBufferInfo = &materialsInfo,
+        }, nullptr);
+    }
+
+    bool BindlessResources::isSupported(const vkr::PhysicalDevice &physicalDevice) {
+        if (physicalDevice.getProperties().apiVersion < VK_API_VERSION_1_2) {
+            return false;
+        }
+        const auto featureChain = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+        const auto &features = featureChain.get<vk::PhysicalDeviceVulkan12Features>();
+        return features.runtimeDescriptorArray && features.descriptorBindingPartiallyBound &&
+               features.descriptorBindingSampledImageUpdateAfterBind && features.descriptorBindingUpdateUnusedWhilePending &&
+               features.shaderSampledImageArrayNonUniformIndexing;
+    }
+
+    vk::PhysicalDeviceVulkan12Features BindlessResources::getRequiredFeatures() {
+        return vk::PhysicalDeviceVulkan12Features{
+                // a draw's material can differ from its neighbours' within a subgroup, so indexing has to be non uniform
+                .shaderSampledImageArrayNonUniformIndexing = true,
+                .descriptorBindingSampledImageUpdateAfterBind = true,
+                .descriptorBindingUpdateUnusedWhilePending = true,
+                .descriptorBindingPartiallyBound = true,
+                .runtimeDescriptorArray = true,
+        };
+    }
+
+    BindlessResourcesProps BindlessResources::clampToLimits(const vkr::PhysicalDevice &physicalDevice, BindlessResourcesProps props) {
+        const auto propertyChain = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceDescriptorIndexingProperties>();
+        const auto &limits = propertyChain.get<vk::PhysicalDeviceDescriptorIndexingProperties>();
+        props.maxTextures = std::min({props.maxTextures, limits.maxDescriptorSetUpdateAfterBindSampledImages,
+                                      limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                      limits.maxDescriptorSetUpdateAfterBindSamplers,
+                                      limits.maxPerStageDescriptorUpdateAfterBindSamplers});
+        return props;
+    }
+
+    vkr::DescriptorPool BindlessResources::createDescriptorPool() {
+        const std::array<vk::DescriptorPoolSize, 2> poolSizes{
+                vk::DescriptorPoolSize{.type = vk::DescriptorType::eCombinedImageSampler, .descriptorCount = props.maxTextures},
+                vk::DescriptorPoolSize{.type = vk::DescriptorType::eStorageBuffer, .descriptorCount = 1},
+        };
+        // the one set lives as long as the pool, so the pool doesn't come from a DescriptorAllocator
+        return {device, vk::DescriptorPoolCreateInfo{
+                .flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind | vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+                .maxSets = 1,
+                .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+                .pPoolSizes = poolSizes.data(),
+        }};
+    }
+
+    vkr::DescriptorSet BindlessResources::createDescriptorSet() {
+        vkr::DescriptorSets sets{device, vk::DescriptorSetAllocateInfo{
+                .descriptorPool = *descriptorPool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &setLayout,
+        }};
+        return std::move(sets.front());
+    }
+
+    uint32_t BindlessResources::addTexture(vk::ImageView imageView, vk::Sampler sampler) {
+        if (textureCount >= props.maxTextures) {
+            throw std::runtime_error("Out of bindless texture slots");
+        }
+        const uint32_t index = textureCount++;
+        const vk::DescriptorImageInfo imageInfo{
+                .sampler = sampler,
+                .imageView = imageView,
+                .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        };
+        device.updateDescriptorSets(vk::WriteDescriptorSet{
+                .dstSet = *descriptorSet,
+                .dstBinding = TEXTURES_BINDING,
+                .dstArrayElement = index,
+                .descriptorCount = 1,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                .pImageInfo = &imageInfo,
+        }, nullptr);
+        return index;
+    }
+
+    uint32_t BindlessResources::addMaterial(const MaterialRecord &material) {
+        if (materialCount >= props.maxMaterials) {
+            throw std::runtime_error("Out of bindless material slots");
+        }
+        const uint32_t index = materialCount++;
+        materialBuffer.writeData(&material, sizeof(MaterialRecord), static_cast<vk::DeviceSize>(index) * sizeof(MaterialRecord));
+        return index;
+    }
+
+    vk::DescriptorSetLayout BindlessResources::getSetLayout() const {
+        return setLayout;
+    }
+
+    vk::DescriptorSet BindlessResources::getDescriptorSet() const {
+        return *descriptorSet;
+    }
+}
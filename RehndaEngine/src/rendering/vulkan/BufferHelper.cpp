@@ -10,9 +10,8 @@ namespace Rehnda::BufferHelper {
         vk::BufferCreateInfo bufferCreateInfo{
                 .size = props.size,
                 .usage = props.bufferUsage,
-                // this buffer is only used by the graphics queue, so can be exclusive
-                .sharingMode = vk::SharingMode::eExclusive
         };
+        setSharingMode(bufferCreateInfo, props.queueFamilies);
         vkr::Buffer outBuffer{device, bufferCreateInfo};
 
 
@@ -29,6 +28,19 @@ namespace Rehnda::BufferHelper {
         return {std::move(outBuffer), std::move(bufferMemory)};
     }
 
+    void setSharingMode(vk::BufferCreateInfo &bufferCreateInfo, const std::vector<uint32_t> &queueFamilies) {
+        if (queueFamilies.size() < 2) {
+            // only used by one queue family, so can be exclusive
+            bufferCreateInfo.sharingMode = vk::SharingMode::eExclusive;
+            bufferCreateInfo.queueFamilyIndexCount = 0;
+            bufferCreateInfo.pQueueFamilyIndices = nullptr;
+            return;
+        }
+        bufferCreateInfo.sharingMode = vk::SharingMode::eConcurrent;
+        bufferCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+        bufferCreateInfo.pQueueFamilyIndices = queueFamilies.data();
+    }
+
     uint32_t findMemoryType(vkr::PhysicalDevice &physicalDevice, uint32_t typeFilter, vk::MemoryPropertyFlags properties) {
         vk::PhysicalDeviceMemoryProperties memoryProperties = physicalDevice.getMemoryProperties();
 
@@ -41,4 +53,14 @@ namespace Rehnda::BufferHelper {
         }
         throw std::runtime_error("Failed to find suitable memory for a vertex buffer");
     }
+
+    bool hasMemoryType(const vkr::PhysicalDevice &physicalDevice, vk::MemoryPropertyFlags properties) {
+        const vk::PhysicalDeviceMemoryProperties memoryProperties = physicalDevice.getMemoryProperties();
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+            if ((memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+                return true;
+            }
+        }
+        return false;
+    }
 } // Rehnda
\ No newline at end of file
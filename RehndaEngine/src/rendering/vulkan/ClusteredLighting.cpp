@@ -0,0 +1,125 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/ClusteredLighting.hpp"
+
+#include <algorithm>
+
+namespace Rehnda {
+    static_assert(sizeof(ClusterParams) == 192, "ClusterParams must match the std140 block in the shaders");
+
+    ClusteredLighting::ClusteredLighting(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, ShaderLibrary &shaderLibrary,
+                                         PipelineLayoutCache &layoutCache, vk::DescriptorSetLayout descriptorSetLayout,
+                                         size_t framesInFlight, std::vector<uint32_t> queueFamilies,
+                                         const ClusteredLightingProps &props) :
+            device(device),
+            physicalDevice(physicalDevice),
+            props(props),
+            clusterCount(props.gridX * props.gridY * props.gridZ),
+            queueFamilies(std::move(queueFamilies)),
+            frameBuffers(createFrameBuffers(framesInFlight)),
+            // shares the graphics frame set layout so the same descriptor set binds at both bind points
+            pipeline(device, shaderLibrary, layoutCache, ComputePipelineProps{
+                    .shaderName = "cluster_lights.comp",
+                    .setLayouts = {descriptorSetLayout},
+                    .workgroupSize = {WORKGROUP_SIZE, 1, 1},
+                    .workgroupSizeConstantIds = glm::uvec3(0, 1, 2),
+            }, framesInFlight) {
+    }
+
+    void ClusteredLighting::applyReload(uint64_t frameNumber) {
+        pipeline.applyReload(frameNumber);
+    }
+
+    std::vector<ClusteredLighting::FrameBuffers> ClusteredLighting::createFrameBuffers(size_t framesInFlight) {
+        std::vector<FrameBuffers> buffers;
+        for (size_t i = 0; i < framesInFlight; i++) {
+            buffers.push_back(FrameBuffers{
+                    .params = {device, physicalDevice, {
+                            .dataSize = sizeof(ClusterParams),
+                            .bufferUsageFlags = vk::BufferUsageFlagBits::eUniformBuffer,
+                            .queueFamilies = queueFamilies,
+                    }},
+                    .lights = {device, physicalDevice, {
+                            .dataSize = static_cast<vk::DeviceSize>(props.maxLights) * sizeof(PointLight),
+                            .bufferUsageFlags = vk::BufferUsageFlagBits::eStorageBuffer,
+                            .queueFamilies = queueFamilies,
+                    }},
+                    // cluster lists are only ever touched by the GPU
+                    .lightCounts = {device, physicalDevice, {
+                            .dataSize = static_cast<vk::DeviceSize>(clusterCount) * sizeof(uint32_t),
+                            .queueFamilies = queueFamilies,
+                    }},
+                    .lightIndices = {device, physicalDevice, {
+                            .dataSize = static_cast<vk::DeviceSize>(clusterCount) * props.maxLightsPerCluster * sizeof(uint32_t),
+                            .queueFamilies = queueFamilies,
+                    }},
+            });
+        }
+        return buffers;
+    }
+
+    std::vector<DescriptorWrite> ClusteredLighting::getDescriptorWrites(size_t frameIndex) const {
+        const FrameBuffers &buffers = frameBuffers[frameIndex];
+        return {
+                DescriptorWrite{
+                        .binding = PARAMS_BINDING,
+                        .type = vk::DescriptorType::eUniformBuffer,
+                        .bufferInfo = {.buffer = *buffers.params.getBuffer(), .offset = 0, .range = sizeof(ClusterParams)},
+                },
+                DescriptorWrite{
+                        .binding = LIGHTS_BINDING,
+                        .type = vk::DescriptorType::eStorageBuffer,
+                        .bufferInfo = {.buffer = *buffers.lights.getBuffer(), .offset = 0, .range = VK_WHOLE_SIZE},
+                },
+                DescriptorWrite{
+                        .binding = LIGHT_COUNTS_BINDING,
+                        .type = vk::DescriptorType::eStorageBuffer,
+                        .bufferInfo = buffers.lightCounts.getDescriptorInfo(),
+                },
+                DescriptorWrite{
+                        .binding = LIGHT_INDICES_BINDING,
+                        .type = vk::DescriptorType::eStorageBuffer,
+                        .bufferInfo = buffers.lightIndices.getDescriptorInfo(),
+                },
+        };
+    }
+
+    void ClusteredLighting::update(size_t frameIndex, std::span<const PointLight> lights, const ClusterCamera &camera) {
+        const auto lightCount = static_cast<uint32_t>(std::min<size_t>(lights.size(), props.maxLights));
+        FrameBuffers &buffers = frameBuffers[frameIndex];
+        if (lightCount > 0) {
+            buffers.lights.writeData(lights.data(), static_cast<vk::DeviceSize>(lightCount) * sizeof(PointLight));
+        }
+
+        const ClusterParams params{
+                .view = camera.view,
+                .inverseProjection = glm::inverse(camera.projection),
+                .cameraPosition = glm::inverse(camera.view) * glm::vec4(0.f, 0.f, 0.f, 1.f),
+                .renderExtent = glm::vec2(static_cast<float>(camera.renderExtent.width), static_cast<float>(camera.renderExtent.height)),
+                .zNear = camera.zNear,
+                .zFar = camera.zFar,
+                .gridX = props.gridX,
+                .gridY = props.gridY,
+                .gridZ = props.gridZ,
+                .maxLightsPerCluster = props.maxLightsPerCluster,
+                .lightCount = lightCount,
+        };
+        buffers.params.writeData(&params);
+    }
+
+    void ClusteredLighting::recordLightCulling(vkr::CommandBuffer &commandBuffer, vk::DescriptorSet descriptorSet) {
+        pipeline.bind(commandBuffer, std::span(&descriptorSet, 1));
+        // one invocation per cluster
+        pipeline.dispatchInvocations(commandBuffer, clusterCount);
+    }
+
+    vk::Buffer ClusteredLighting::getLightCountsBuffer(size_t frameIndex) const {
+        return *frameBuffers[frameIndex].lightCounts.getBuffer();
+    }
+
+    vk::Buffer ClusteredLighting::getLightIndicesBuffer(size_t frameIndex) const {
+        return *frameBuffers[frameIndex].lightIndices.getBuffer();
+    }
+}
@@ -0,0 +1,118 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/ComputePipeline.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+namespace Rehnda {
+    ComputePipeline::ComputePipeline(vkr::Device &device, ShaderLibrary &shaderLibrary, PipelineLayoutCache &layoutCache,
+                                     const ComputePipelineProps &props, size_t framesInFlight) :
+            device(device),
+            shaderLibrary(shaderLibrary),
+            layoutCache(layoutCache),
+            props(props),
+            reload(framesInFlight) {
+        const std::vector<uint32_t> code = shaderLibrary.load(props.shaderName);
+        pipelineLayout = createPipelineLayout(code, pushConstantSize);
+        pipeline = createPipeline(code);
+        shaderWatch = shaderLibrary.watch({props.shaderName}, [this]() { rebuild(); });
+    }
+
+    vk::PipelineLayout ComputePipeline::createPipelineLayout(std::span<const uint32_t> code, uint32_t &reflectedPushConstantSize) const {
+        const ShaderReflection reflection = ShaderReflection::reflect(std::as_bytes(code));
+        if (reflection.getSetCount() > props.setLayouts.size()) {
+            throw std::runtime_error(fmt::format("{} uses {} descriptor sets but only {} layouts were given", props.shaderName,
+                                                 reflection.getSetCount(), props.setLayouts.size()));
+        }
+        for (uint32_t set = 0; set < reflection.getSetCount(); set++) {
+            layoutCache.getSetLayoutDesc(props.setLayouts[set]).validateReflection(reflection, set);
+        }
+        const auto pushConstantRanges = reflection.getPushConstantRanges();
+        reflectedPushConstantSize = pushConstantRanges.empty() ? 0 : pushConstantRanges.front().size;
+        return layoutCache.getPipelineLayout(props.setLayouts, pushConstantRanges);
+    }
+
+    void ComputePipeline::rebuild() {
+        const std::vector<uint32_t> code = shaderLibrary.load(props.shaderName);
+        // descriptor sets and push constants are recorded against the current layouts, a new one needs a restart. Creating
+        // the layout checks every binding the new shader declares against the set layouts
+        uint32_t reflectedPushConstantSize = 0;
+        if (createPipelineLayout(code, reflectedPushConstantSize) != pipelineLayout) {
+            throw std::runtime_error(fmt::format("{} changed its pipeline layout, restart to pick that up", props.shaderName));
+        }
+        reload.offer(createPipeline(code));
+    }
+
+    void ComputePipeline::applyReload(uint64_t frameNumber) {
+        if (reload.apply(pipeline, frameNumber)) {
+            SPDLOG_INFO("Reloaded {}", props.shaderName);
+        }
+    }
+
+    vkr::Pipeline ComputePipeline::createPipeline(std::span<const uint32_t> code) const {
+        vkr::ShaderModule shaderModule{device, vk::ShaderModuleCreateInfo{
+                .codeSize = code.size_bytes(),
+                .pCode = code.data(),
+        }};
+
+        std::vector<SpecializationConstant> constants = props.specializationConstants;
+        if (props.workgroupSizeConstantIds) {
+            for (glm::length_t i = 0; i < 3; i++) {
+                constants.push_back({.id = (*props.workgroupSizeConstantIds)[i], .value = props.workgroupSize[i]});
+            }
+        }
+        const SpecializationData specializationData(constants);
+
+        vk::ComputePipelineCreateInfo computePipelineCreateInfo{
+                .stage = {
+                        .stage = vk::ShaderStageFlagBits::eCompute,
+                        .module = *shaderModule,
+                        .pName = "main",
+                        .pSpecializationInfo = specializationData.getInfo(),
+                },
+                .layout = pipelineLayout,
+        };
+        return {device, VK_NULL_HANDLE, computePipelineCreateInfo};
+    }
+
+    void ComputePipeline::bind(vkr::CommandBuffer &commandBuffer, std::span<const vk::DescriptorSet> descriptorSets) const {
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+        if (!descriptorSets.empty()) {
+            commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, pipelineLayout, 0, descriptorSets, nullptr);
+        }
+    }
+
+    void ComputePipeline::pushConstants(vkr::CommandBuffer &commandBuffer, const void *data, uint32_t size, uint32_t offset) const {
+        assert(offset + size <= pushConstantSize);
+        commandBuffer.pushConstants<std::byte>(pipelineLayout, vk::ShaderStageFlagBits::eCompute, offset,
+                                               vk::ArrayProxy<const std::byte>(size, static_cast<const std::byte *>(data)));
+    }
+
+    void ComputePipeline::dispatch(vkr::CommandBuffer &commandBuffer, uint32_t groupCountX, uint32_t groupCountY,
+                                   uint32_t groupCountZ) const {
+        commandBuffer.dispatch(groupCountX, groupCountY, groupCountZ);
+    }
+
+    void ComputePipeline::dispatchInvocations(vkr::CommandBuffer &commandBuffer, uint32_t countX, uint32_t countY,
+                                              uint32_t countZ) const {
+        dispatch(commandBuffer,
+                 (countX + props.workgroupSize.x - 1) / props.workgroupSize.x,
+                 (countY + props.workgroupSize.y - 1) / props.workgroupSize.y,
+                 (countZ + props.workgroupSize.z - 1) / props.workgroupSize.z);
+    }
+
+    vk::PipelineLayout ComputePipeline::getLayout() const {
+        return pipelineLayout;
+    }
+
+    glm::uvec3 ComputePipeline::getWorkgroupSize() const {
+        return props.workgroupSize;
+    }
+}
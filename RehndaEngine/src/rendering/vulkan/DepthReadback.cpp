@@ -0,0 +1,113 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/DepthReadback.hpp"
+
+#include <cstring>
+
+#include "rendering/vulkan/BufferHelper.hpp"
+
+namespace Rehnda {
+    DepthReadback::DepthReadback(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, size_t framesInFlight,
+                                 vk::Extent2D maxExtent, vk::Format depthFormat) :
+            device(device),
+            physicalDevice(physicalDevice),
+            framesInFlight(framesInFlight),
+            maxExtent(maxExtent),
+            depthFormat(depthFormat),
+            frameCopies(createFrameCopies()) {
+    }
+
+    std::vector<DepthReadback::FrameCopy> DepthReadback::createFrameCopies() {
+        // copying only the depth aspect gives 4 bytes per texel for every depth format we pick
+        const vk::DeviceSize size = static_cast<vk::DeviceSize>(maxExtent.width) * maxExtent.height * sizeof(float);
+        std::vector<FrameCopy> copies;
+        for (size_t i = 0; i < framesInFlight; i++) {
+            auto [buffer, memory] = BufferHelper::createBuffer(device, physicalDevice, {
+                    .size = size,
+                    .bufferUsage = vk::BufferUsageFlagBits::eTransferDst,
+                    .requiredMemoryProperties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+            });
+            // stays mapped for the buffer's lifetime, like WritableDirectBuffer
+            const void *mappedMemory = memory.mapMemory(0, size, vk::MemoryMapFlags{});
+            copies.push_back(FrameCopy{
+                    .buffer = std::move(buffer),
+                    .memory = std::move(memory),
+                    .mappedMemory = mappedMemory,
+                    .hasDepth = false,
+                    .frameNumber = 0,
+                    .viewProjection = glm::mat4(1.f),
+                    .extent = {0, 0},
+            });
+        }
+        return copies;
+    }
+
+    void DepthReadback::recordCopy(vkr::CommandBuffer &commandBuffer, vk::Image depthImage, vk::Extent2D renderExtent,
+                                   size_t frameIndex, uint64_t frameNumber, const glm::mat4 &viewProjection) {
+        FrameCopy &frameCopy = frameCopies[frameIndex];
+        const vk::BufferImageCopy region{
+                .bufferOffset = 0,
+                // 0 means tightly packed
+                .bufferRowLength = 0,
+                .bufferImageHeight = 0,
+                .imageSubresource = {
+                        .aspectMask = vk::ImageAspectFlagBits::eDepth,
+                        .mipLevel = 0,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1,
+                },
+                .imageOffset = {0, 0, 0},
+                .imageExtent = {renderExtent.width, renderExtent.height, 1},
+        };
+        commandBuffer.copyImageToBuffer(depthImage, vk::ImageLayout::eTransferSrcOptimal, *frameCopy.buffer, region);
+
+        frameCopy.hasDepth = true;
+        frameCopy.frameNumber = frameNumber;
+        frameCopy.viewProjection = viewProjection;
+        frameCopy.extent = renderExtent;
+    }
+
+    bool DepthReadback::hasDepth(size_t frameIndex) const {
+        return frameCopies[frameIndex].hasDepth;
+    }
+
+    uint64_t DepthReadback::getFrameNumber(size_t frameIndex) const {
+        return frameCopies[frameIndex].frameNumber;
+    }
+
+    const glm::mat4 &DepthReadback::getViewProjection(size_t frameIndex) const {
+        return frameCopies[frameIndex].viewProjection;
+    }
+
+    vk::Extent2D DepthReadback::getExtent(size_t frameIndex) const {
+        return frameCopies[frameIndex].extent;
+    }
+
+    vk::Buffer DepthReadback::getBuffer(size_t frameIndex) const {
+        return *frameCopies[frameIndex].buffer;
+    }
+
+    void DepthReadback::readDepth(size_t frameIndex, std::vector<float> &depth) const {
+        const vk::Extent2D extent = frameCopies[frameIndex].extent;
+        const size_t texelCount = static_cast<size_t>(extent.width) * extent.height;
+        depth.resize(texelCount);
+        const void *mappedMemory = frameCopies[frameIndex].mappedMemory;
+        if (depthFormat == vk::Format::eD24UnormS8Uint) {
+            // the depth aspect of D24 copies out as 24 bit unorm in the low bits of each 32 bit texel
+            const auto *packed = static_cast<const uint32_t *>(mappedMemory);
+            for (size_t i = 0; i < texelCount; i++) {
+                depth[i] = static_cast<float>(packed[i] & 0x00FFFFFF) / static_cast<float>(0x00FFFFFF);
+            }
+        } else {
+            std::memcpy(depth.data(), mappedMemory, texelCount * sizeof(float));
+        }
+    }
+
+    void DepthReadback::resize(vk::Extent2D newMaxExtent) {
+        maxExtent = newMaxExtent;
+        frameCopies.clear();
+        frameCopies = createFrameCopies();
+    }
+}
@@ -0,0 +1,121 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/DescriptorAllocator.hpp"
+
+#include <algorithm>
+
+namespace Rehnda {
+    DescriptorAllocator::DescriptorAllocator(vkr::Device &device, DescriptorAllocatorProps props) :
+            device(device),
+            props(std::move(props)),
+            setsPerPool(this->props.initialSetsPerPool) {
+    }
+
+    vkr::DescriptorPool DescriptorAllocator::createPool() {
+        std::vector<vk::DescriptorPoolSize> poolSizes;
+        for (const auto &[type, perSet]: props.descriptorsPerSet) {
+            poolSizes.push_back(vk::DescriptorPoolSize{
+                    .type = type,
+                    .descriptorCount = std::max(1u, static_cast<uint32_t>(perSet * static_cast<float>(setsPerPool))),
+            });
+        }
+        // no free descriptor set flag, sets are never given back
+        vk::DescriptorPoolCreateInfo poolCreateInfo{
+                .maxSets = setsPerPool,
+                .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+                .pPoolSizes = poolSizes.data(),
+        };
+        vkr::DescriptorPool pool{device, poolCreateInfo};
+        setsPerPool = std::min(setsPerPool * 2, props.maxSetsPerPool);
+        return pool;
+    }
+
+    vk::DescriptorSet DescriptorAllocator::allocate(vk::DescriptorSetLayout layout) {
+        if (!currentPool) {
+            currentPool.emplace(createPool());
+        }
+        vk::DescriptorSetAllocateInfo allocateInfo{
+                .descriptorPool = **currentPool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &layout,
+        };
+        try {
+            return (*device).allocateDescriptorSets(allocateInfo).front();
+        } catch (const vk::OutOfPoolMemoryError &) {
+        } catch (const vk::FragmentedPoolError &) {
+        }
+
+        // the current pool is full, retry once in a fresh one. A set that doesn't fit an empty pool never will
+        fullPools.push_back(std::move(*currentPool));
+        currentPool.emplace(createPool());
+        allocateInfo.descriptorPool = **currentPool;
+        return (*device).allocateDescriptorSets(allocateInfo).front();
+    }
+
+    namespace DescriptorWrites {
+        void update(vkr::Device &device, vk::DescriptorSet set, std::span<const DescriptorWrite> writes) {
+            std::vector<vk::WriteDescriptorSet> descriptorWrites;
+            descriptorWrites.reserve(writes.size());
+            for (const auto &write: writes) {
+                const bool isImage = write.type == vk::DescriptorType::eCombinedImageSampler ||
+                                     write.type == vk::DescriptorType::eSampledImage ||
+                                     write.type == vk::DescriptorType::eStorageImage ||
+                                     write.type == vk::DescriptorType::eSampler;
+                descriptorWrites.push_back(vk::WriteDescriptorSet{
+                        .dstSet = set,
+                        .dstBinding = write.binding,
+                        .dstArrayElement = 0,
+                        .descriptorCount = 1,
+                        .descriptorType = write.type,
+                        .pImageInfo = isImage ? &write.imageInfo : nullptr,
+                        .pBufferInfo = isImage ? nullptr : &write.bufferInfo,
+                });
+            }
+            device.updateDescriptorSets(descriptorWrites, nullptr);
+        }
+    }
+
+    DescriptorSetCache::DescriptorSetCache(vkr::Device &device, DescriptorAllocatorProps props) :
+            device(device),
+            allocator(device, std::move(props)) {
+    }
+
+    vk::DescriptorSet DescriptorSetCache::get(vk::DescriptorSetLayout layout, std::span<const DescriptorWrite> writes) {
+        Key key{.layout = layout, .writes = {writes.begin(), writes.end()}};
+        // the order descriptors are listed in doesn't change the set
+        std::sort(key.writes.begin(), key.writes.end(), [](const DescriptorWrite &a, const DescriptorWrite &b) {
+            return a.binding < b.binding;
+        });
+        if (const auto it = sets.find(key); it != sets.end()) {
+            return it->second;
+        }
+        const vk::DescriptorSet set = allocator.allocate(layout);
+        DescriptorWrites::update(device, set, key.writes);
+        sets.emplace(std::move(key), set);
+        return set;
+    }
+
+    size_t DescriptorSetCache::size() const {
+        return sets.size();
+    }
+
+    size_t DescriptorSetCache::KeyHash::operator()(const Key &key) const {
+        size_t hash = std::hash<vk::DescriptorSetLayout>{}(key.layout);
+        const auto combine = [&](size_t value) {
+            hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        };
+        for (const auto &write: key.writes) {
+            combine(write.binding);
+            combine(static_cast<size_t>(write.type));
+            combine(std::hash<vk::Buffer>{}(write.bufferInfo.buffer));
+            combine(static_cast<size_t>(write.bufferInfo.offset));
+            combine(static_cast<size_t>(write.bufferInfo.range));
+            combine(std::hash<vk::ImageView>{}(write.imageInfo.imageView));
+            combine(std::hash<vk::Sampler>{}(write.imageInfo.sampler));
+            combine(static_cast<size_t>(write.imageInfo.imageLayout));
+        }
+        return hash;
+    }
+}
@@ -10,15 +10,20 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include <chrono>
+#include <algorithm>
+#include <array>
+#include <cmath>
 
 #include <memory>
+#include <optional>
+
+#include <spdlog/spdlog.h>
 
 #include "rendering/vulkan/VkDebugHelpers.hpp"
-#include "rendering/vulkan/SwapchainManager.hpp"
-#include "rendering/MVPTransforms.hpp"
 #include "rendering/vulkan/TextureImage.hpp"
 #include "rendering/vulkan/TextureSampler.hpp"
+#include "rendering/PackedVertex.hpp"
+#include "assets/MeshImporter.hpp"
 
 namespace Rehnda {
     const std::vector<Vertex> vertices = {
@@ -37,94 +42,226 @@ namespace Rehnda {
             4, 5, 6, 6, 7, 4
     };
 
-    FrameCoordinator::FrameCoordinator(GLFWwindow *window, vkr::Device &device, vkr::PhysicalDevice &physicalDevice,
-                                       vkr::SurfaceKHR &surface,
-                                       QueueFamilyIndices queueFamilyIndices) :
+    FrameCoordinator::FrameCoordinator(vkr::Device &device, vkr::PhysicalDevice &physicalDevice,
+                                       QueueFamilyIndices queueFamilyIndices, JobSystem &jobSystem, FrameOutput &output,
+                                       FrameCoordinatorProps props) :
+            props(props),
+            requestedDepthPrePass(props.depthPrePass),
             device(device),
             physicalDevice(physicalDevice),
             queueFamilyIndices(queueFamilyIndices),
-            swapChainSupportDetails(window, physicalDevice, surface),
+            jobSystem(jobSystem),
+            output(output),
+            // a single mapping of the packed assets if the build produced one, loose files otherwise
+            assetLoader("assets.rpak"),
+            shaderLibrary(assetLoader, props.shaders),
             graphicsQueue(device.getQueue(queueFamilyIndices.graphicsQueueIndex.value(), 0)),
-            presentQueue(device.getQueue(queueFamilyIndices.presentQueueIndex.value(), 0)),
-            graphicsCommandPool(createCommandPool(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)),
-            memoryCommandPool(createCommandPool(vk::CommandPoolCreateFlagBits::eTransient)),
-            commandBuffers(createCommandBuffers()),
+            graphicsCommandPool(createCommandPool(vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                                                  queueFamilyIndices.graphicsQueueIndex.value())),
+            commandBuffers(createCommandBuffers(graphicsCommandPool)),
+            uploadQueue(device, queueFamilyIndices),
+            asyncCompute(props.asyncCompute && queueFamilyIndices.computeQueueIndex.has_value()),
+            computeQueue(device.getQueue(queueFamilyIndices.getComputeFamily(), 0)),
             imageAvailableSemaphores(createSemaphores(MAX_FRAMES_IN_FLIGHT)),
             renderFinishedSemaphores(createSemaphores(MAX_FRAMES_IN_FLIGHT)),
+            lightCullingFinishedSemaphores(createSemaphores(MAX_FRAMES_IN_FLIGHT)),
             inFlightFences(createFences(MAX_FRAMES_IN_FLIGHT)),
+            gpuTimer(device, physicalDevice, queueFamilyIndices.graphicsQueueIndex.value(), MAX_FRAMES_IN_FLIGHT),
             uboBuffers(createUbos()),
-            descriptorSetLayout(createDescriptorSetLayout()),
-            descriptorPool(createDescriptorPool()),
-            descriptorSets(createDescriptorSets()) {
-
-        mesh = std::make_unique<RenderableMesh>(
-                DeviceContext{.device = device, .physicalDevice=physicalDevice, .memoryCommandPool = memoryCommandPool, .graphicsQueue=graphicsQueue},
-                vertices, indices);
-        graphicsPipeline = std::make_unique<GraphicsPipeline>(device, physicalDevice,
-                                                              swapChainSupportDetails.chooseSwapSurfaceFormat().format,
-                                                              *mesh, descriptorSetLayout);
-        depthImage = std::make_unique<DepthImage>(device, physicalDevice, swapChainSupportDetails.chooseSwapExtent());
-
-        swapchainManager = std::make_unique<SwapchainManager>(device, surface, queueFamilyIndices,
-                                                              graphicsPipeline->getRenderPass(),
-                                                              depthImage->getImageView(),
-                                                              swapChainSupportDetails);
-        textureImage = std::make_unique<TextureImage>(device, physicalDevice, graphicsQueue, memoryCommandPool, "resources/textures/texture.jpg");
+            objectBuffers(createObjectBuffers()),
+            layoutCache(device),
+            frameShaders(reflectFrameShaders()),
+            frameSetLayout(layoutCache.getSetLayout(DescriptorSetLayoutDesc::fromReflection(frameShaders, 0))),
+            frameSetCache(device),
+            bindless(std::make_unique<BindlessResources>(device, physicalDevice, layoutCache, frameShaders)),
+            sceneCuller(transformStore),
+            dynamicResolution(props.dynamicResolution) {
+        if (props.scene.meshCount == 0 || props.scene.textureCount == 0 || props.scene.materialCount == 0) {
+            throw std::runtime_error("The scene needs at least one mesh, texture and material");
+        }
+        if (asyncCompute) {
+            computeCommandPool.emplace(createCommandPool(vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                                                         queueFamilyIndices.getComputeFamily()));
+            computeCommandBuffers = createCommandBuffers(*computeCommandPool);
+        }
+        // what the output was created at, until the window reports otherwise
+        framebufferExtent = static_cast<uint64_t>(output.getExtent().width) << 32 | output.getExtent().height;
+        // decompressing the texture doesn't need the device, so it overlaps building the pipelines below
+        std::optional<AssetBlob> textureBlob;
+        JobCounter textureLoaded;
+        jobSystem.run([&]() { textureBlob.emplace(assetLoader.load("resources/textures/texture.jpg")); }, &textureLoaded);
+
+
+        const DeviceContext deviceContext{.device = device, .physicalDevice=physicalDevice, .uploadQueue = uploadQueue};
+        Aabb meshBounds = Aabb::empty();
+        if (props.scene.meshPath.empty()) {
+            // meshes are packed to 16 byte vertices for upload, halving vertex fetch bandwidth compared to the full float Vertex
+            const auto packedVertices = PackedVertex::packAll(vertices);
+            mesh = std::make_unique<RenderableMesh>(deviceContext, std::span<const PackedVertex>(packedVertices),
+                                                    std::span<const uint16_t>(indices));
+            for (const auto &vertex: vertices) {
+                meshBounds.expand(vertex.pos);
+            }
+        } else {
+            // only parsed the first time, after that it's mapped straight from the .rmesh cache
+            const CachedMesh cachedMesh = MeshImporter{{.jobSystem = &jobSystem}}.importCached(props.scene.meshPath);
+            mesh = std::make_unique<RenderableMesh>(deviceContext, cachedMesh);
+            // the cached vertices are half floats, the bounding sphere baked at import is close enough for placing the mesh
+            const MeshBounds bounds = cachedMesh.getBounds();
+            meshBounds.expand(bounds.center - glm::vec3(bounds.radius));
+            meshBounds.expand(bounds.center + glm::vec3(bounds.radius));
+        }
+        createSceneTransforms(meshBounds);
+        const std::array<vk::DescriptorSetLayout, 2> setLayouts{frameSetLayout, bindless->getSetLayout()};
+        graphicsPipeline = std::make_unique<GraphicsPipeline>(device, physicalDevice, shaderLibrary, output.getFormat(),
+                                                              PackedVertex::Layout::getInputDescription(),
+                                                              layoutCache, setLayouts, MAX_FRAMES_IN_FLIGHT,
+                                                              props.occlusionCulling);
+        shadingPermutation
+                .set(SpecializationConstant::fromBool(GraphicsPipeline::CLUSTERED_LIGHTING_CONSTANT, props.clusteredShading))
+                .set({.id = GraphicsPipeline::MAX_LIGHTS_PER_CLUSTER_CONSTANT, .value = props.clusteredLighting.maxLightsPerCluster});
+        graphicsPipeline->preparePermutation(shadingPermutation);
+        const vk::Extent2D maxRenderExtent = dynamicResolution.getMaxRenderExtent(output.getExtent());
+        renderTarget = std::make_unique<RenderTarget>(device, physicalDevice, RenderTargetProps{
+                .colorFormat = output.getFormat(),
+                .extent = maxRenderExtent,
+        });
+        if (props.occlusionCulling) {
+            depthReadback = std::make_unique<DepthReadback>(device, physicalDevice, MAX_FRAMES_IN_FLIGHT, maxRenderExtent,
+                                                            DepthImage::findDepthFormat(physicalDevice));
+        }
+        jobSystem.wait(textureLoaded);
+        // separate copies rather than one shared image, so bigger scenes cost the memory and descriptors they would for real
+        for (uint32_t i = 0; i < props.scene.textureCount; i++) {
+            textureImages.push_back(std::make_unique<TextureImage>(device, physicalDevice, uploadQueue, textureBlob->bytes()));
+        }
         textureSampler = std::make_unique<TextureSampler>(device, physicalDevice, TextureSamplerProps{
                 .magMinFilter = vk::Filter::eLinear,
                 .samplerAddressModeUVW = vk::SamplerAddressMode::eRepeat,
         });
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-            vk::DescriptorBufferInfo bufferInfo{
-                    .buffer = *uboBuffers[i].getBuffer(),
-                    .offset = 0,
-                    .range = sizeof(MVPTransforms)
-            };
-
-            vk::WriteDescriptorSet bufferDescriptorWrite{
-                    .dstSet = *descriptorSets[i],
-                    .dstBinding = 0,
-                    .dstArrayElement = 0,
-                    .descriptorCount = 1,
-                    .descriptorType = vk::DescriptorType::eUniformBuffer,
-                    .pImageInfo = nullptr,
-                    .pBufferInfo = &bufferInfo,
-                    .pTexelBufferView = nullptr
-            };
-
-            vk::DescriptorImageInfo imageInfo{
-                    .sampler = **textureSampler,
-                    .imageView = *textureImage->getImageView(),
-                    .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
-            };
-            vk::WriteDescriptorSet imageDescriptorWrite{
-                    .dstSet = *descriptorSets[i],
-                    .dstBinding = 1,
-                    .dstArrayElement = 0,
-                    .descriptorCount = 1,
-                    .descriptorType = vk::DescriptorType::eCombinedImageSampler,
-                    .pImageInfo = &imageInfo,
-                    .pBufferInfo = nullptr,
-                    .pTexelBufferView = nullptr
-            };
-            device.updateDescriptorSets({bufferDescriptorWrite, imageDescriptorWrite}, nullptr);
+        // the mesh and textures go up in one submission, the first frame waits on it
+        uploadQueue.flush();
+        // binned on the compute family and shaded on the graphics one when they differ
+        std::vector<uint32_t> lightingQueueFamilies{queueFamilyIndices.graphicsQueueIndex.value()};
+        if (asyncCompute) {
+            lightingQueueFamilies.push_back(queueFamilyIndices.getComputeFamily());
+        }
+        clusteredLighting = std::make_unique<ClusteredLighting>(device, physicalDevice, shaderLibrary, layoutCache, frameSetLayout,
+                                                                 MAX_FRAMES_IN_FLIGHT, lightingQueueFamilies,
+                                                                 props.clusteredLighting);
+        std::vector<uint32_t> textures;
+        for (const auto &textureImage: textureImages) {
+            textures.push_back(bindless->addTexture(*textureImage->getImageView(), **textureSampler));
+        }
+        for (uint32_t i = 0; i < props.scene.materialCount; i++) {
+            materials.push_back(bindless->addMaterial(MaterialRecord{.albedoTexture = textures[i % textures.size()]}));
+        }
+        buildRenderGraph();
+    }
+
+    void FrameCoordinator::createSceneTransforms(const Aabb &meshBounds) {
+        // a square grid filling GRID_SIZE units around the origin, a single mesh sits at the origin at its own size
+        constexpr float GRID_SIZE = 4.f;
+        const auto columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(props.scene.meshCount))));
+        const float cellSize = GRID_SIZE / static_cast<float>(columns);
+        const float scale = std::min(1.f, cellSize * 0.8f);
+        for (uint32_t i = 0; i < props.scene.meshCount; i++) {
+            const glm::vec2 cell{static_cast<float>(i % columns), static_cast<float>(i / columns)};
+            const glm::vec2 position = (cell + 0.5f) * cellSize - GRID_SIZE * 0.5f;
+            const TransformHandle transform = transformStore.create(TransformProps{
+                    .position = glm::vec3(position, 0.f),
+                    .scale = glm::vec3(scale),
+            });
+            sceneCuller.add(transform, meshBounds);
+            objectLods.resize(std::max<size_t>(objectLods.size(), transform + 1), 0);
+        }
+    }
+
+    void FrameCoordinator::buildRenderGraph() {
+        renderGraph = std::make_unique<RenderGraph>(device, physicalDevice);
+        sceneColorImage = renderGraph->importImage("scene color", vk::ImageAspectFlagBits::eColor);
+        // the graph's own, so it's transient and lazily allocated unless the readback pass copies it out
+        sceneDepthImage = renderGraph->createImage("scene depth", AttachmentDescription{
+                .format = DepthImage::findDepthFormat(physicalDevice),
+                .extent = renderTarget->getExtent(),
+                .usage = vk::ImageUsageFlagBits::eDepthStencilAttachment,
+                .aspect = vk::ImageAspectFlagBits::eDepth,
+                .transient = true,
+        });
+        outputImage = renderGraph->importImage("output", vk::ImageAspectFlagBits::eColor);
+        clusterLightCountsBuffer = renderGraph->importBuffer("cluster light counts");
+        clusterLightIndicesBuffer = renderGraph->importBuffer("cluster light indices");
+
+        // with async compute the cluster buffers arrive already written, made visible by the semaphore the frame waits on
+        if (!asyncCompute) {
+            renderGraph->addPass("light culling", [&](RenderPassBuilder &pass) {
+                pass.write(clusterLightCountsBuffer, BufferUsage::STORAGE_WRITE_COMPUTE);
+                pass.write(clusterLightIndicesBuffer, BufferUsage::STORAGE_WRITE_COMPUTE);
+            }, [this](vkr::CommandBuffer &commandBuffer) {
+                gpuTimer.beginScope(commandBuffer, "light culling");
+                clusteredLighting->recordLightCulling(commandBuffer, frameDescriptorSet);
+                gpuTimer.endScope(commandBuffer);
+            });
+        }
+
+        // both subpasses, the render pass itself handles the pre-pass to main pass dependency
+        renderGraph->addPass("scene", [&](RenderPassBuilder &pass) {
+            pass.read(clusterLightCountsBuffer, BufferUsage::STORAGE_READ_FRAGMENT);
+            pass.read(clusterLightIndicesBuffer, BufferUsage::STORAGE_READ_FRAGMENT);
+            // both are cleared on load, so their previous contents are thrown away
+            pass.write(sceneColorImage, ImageUsage::COLOR_ATTACHMENT);
+            pass.write(sceneDepthImage, ImageUsage::DEPTH_ATTACHMENT);
+        }, [this](vkr::CommandBuffer &commandBuffer) {
+            const std::array<vk::DescriptorSet, 2> descriptorSets{frameDescriptorSet, bindless->getDescriptorSet()};
+            frameStats.drawCalls = graphicsPipeline->recordRenderPass(commandBuffer, renderTarget->getFramebuffer(), descriptorSets,
+                                               renderExtent, meshDraws, shadingPermutation, props.depthPrePass, gpuTimer);
+        });
+
+        if (depthReadback) {
+            depthReadbackBuffer = renderGraph->importBuffer("depth readback");
+            renderGraph->addPass("depth readback", [&](RenderPassBuilder &pass) {
+                pass.read(sceneDepthImage, ImageUsage::TRANSFER_SRC);
+                pass.write(depthReadbackBuffer, BufferUsage::TRANSFER_DST);
+            }, [this](vkr::CommandBuffer &commandBuffer) {
+                depthReadback->recordCopy(commandBuffer, renderGraph->getImage(sceneDepthImage), renderExtent, currentFrame, frameNumber,
+                                          frameTransforms.proj * frameTransforms.view);
+            });
+            renderGraph->markOutput(depthReadbackBuffer, BufferUsage::HOST_READ);
         }
 
+        renderGraph->addPass("upscale", [&](RenderPassBuilder &pass) {
+            pass.read(sceneColorImage, ImageUsage::TRANSFER_SRC);
+            pass.write(outputImage, ImageUsage::TRANSFER_DST);
+        }, [this](vkr::CommandBuffer &commandBuffer) {
+            gpuTimer.beginScope(commandBuffer, "upscale");
+            renderTarget->recordUpscale(commandBuffer, renderExtent, renderGraph->getImage(outputImage), output.getExtent());
+            gpuTimer.endScope(commandBuffer);
+        });
+        // headless images are left ready to be copied out instead
+        renderGraph->markOutput(outputImage, output.isPresented() ? ImageUsage::PRESENT : ImageUsage::TRANSFER_SRC);
 
+        renderGraph->compile();
+        importRenderTarget();
     }
 
-    vkr::CommandPool FrameCoordinator::createCommandPool(vk::CommandPoolCreateFlags commandPoolCreateFlags) {
+    void FrameCoordinator::importRenderTarget() {
+        renderGraph->setImportedImage(sceneColorImage, *renderTarget->getColorImage());
+        renderTarget->createFramebuffer(graphicsPipeline->getRenderPass(), renderGraph->getImageView(sceneDepthImage));
+    }
+
+    vkr::CommandPool FrameCoordinator::createCommandPool(vk::CommandPoolCreateFlags commandPoolCreateFlags,
+                                                         uint32_t queueFamilyIndex) {
         vk::CommandPoolCreateInfo poolCreateInfo{
                 // since we are recording a command buffer every frame we want to be able to reset and rerecord, hence ResetCommandBuffer
                 .flags = commandPoolCreateFlags,
-                .queueFamilyIndex = queueFamilyIndices.graphicsQueueIndex.value(),
+                .queueFamilyIndex = queueFamilyIndex,
         };
         return {device, poolCreateInfo};
     }
 
-    vkr::CommandBuffers FrameCoordinator::createCommandBuffers() {
+    vkr::CommandBuffers FrameCoordinator::createCommandBuffers(vkr::CommandPool &commandPool) {
         vk::CommandBufferAllocateInfo commandBufferAllocateInfo{
-                .commandPool = *graphicsCommandPool,
+                .commandPool = *commandPool,
                 .level = vk::CommandBufferLevel::ePrimary,
                 .commandBufferCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT),
         };
@@ -139,17 +276,38 @@ namespace Rehnda {
      * 4. Submit the recorded command buffer
      * 5. Present the swap chain image
      */
-    DrawFrameResult FrameCoordinator::drawFrame() {
+    DrawFrameResult FrameCoordinator::drawFrame(const RenderCommandStream &commands) {
+        // applied even if the frame ends up skipped, so a later frame never draws with stale scene state
+        applyCommands(commands);
+        props.depthPrePass = requestedDepthPrePass;
+
         // waiting for fences would fail if we exit this method early and reset fences immediately before new work is submitted
         const auto waitResult = device.waitForFences({*inFlightFences[currentFrame]}, VK_TRUE, UINT64_MAX);
         assert(waitResult == vk::Result::eSuccess);
 
-        const auto [result, nextImageIndex] = swapchainManager->acquireNextImageIndex(
-                imageAvailableSemaphores[currentFrame]);
-        if (result == vk::Result::eErrorOutOfDateKHR || framebufferResized) {
-            framebufferResized = false;
-            depthImage->resize(device, physicalDevice, swapChainSupportDetails.chooseSwapExtent());
-            swapchainManager->resize(graphicsPipeline->getRenderPass(), depthImage->getImageView());
+        // anything rebuilt since the last frame is swapped in now, the frames still using what it replaces are kept track of
+        graphicsPipeline->applyReload(frameNumber);
+        clusteredLighting->applyReload(frameNumber);
+
+        const auto [result, nextImageIndex] = output.acquireNextImageIndex(imageAvailableSemaphores[currentFrame]);
+        if (framebufferResized.exchange(false) || result == vk::Result::eErrorOutOfDateKHR) {
+            const uint64_t packedExtent = framebufferExtent;
+            const vk::Extent2D newExtent{static_cast<uint32_t>(packedExtent >> 32), static_cast<uint32_t>(packedExtent)};
+            if (newExtent.width == 0 || newExtent.height == 0) {
+                // minimized, a swapchain can't be 0 sized so it's recreated once the window has a size again
+                framebufferResized = true;
+                return DrawFrameResult::SWAPCHAIN_OUT_OF_DATE;
+            }
+            output.resize(newExtent);
+            const vk::Extent2D maxRenderExtent = dynamicResolution.getMaxRenderExtent(output.getExtent());
+            renderTarget->resize(maxRenderExtent);
+            renderGraph->resizeImage(sceneDepthImage, maxRenderExtent);
+            renderGraph->compile();
+            importRenderTarget();
+            if (depthReadback) {
+                depthReadback->resize(maxRenderExtent);
+                hiZPyramid.clear();
+            }
             return DrawFrameResult::SWAPCHAIN_OUT_OF_DATE;
         } else if (result != vk::Result::eSuccess &&
                    result != vk::Result::eSuboptimalKHR) {
@@ -158,66 +316,181 @@ namespace Rehnda {
 
         // reset only once we have submitted work and know we won't exit early due to swapchain out of date
         device.resetFences({*inFlightFences[currentFrame]});
-
-        updateUniformBuffer(currentFrame);
+        // the uploads this slot's last frame acquired are finished with, so their staging buffers can go
+        uploadQueue.collect(currentFrame);
+        // the fence wait means this slot's timestamps are ready
+        gpuTimer.collect(currentFrame);
+        dynamicResolution.update(gpuTimer.getTotalMilliseconds());
+        reportGpuTimings();
+        if (gpuTimer.isSupported()) {
+            frameStats.gpuMilliseconds = gpuTimer.getLastFrameMilliseconds();
+        }
+        // the render target is allocated at the largest scale, so a new scale is just a different viewport
+        renderExtent = dynamicResolution.getRenderExtent(output.getExtent());
+
+        writeFrameDescriptorSet();
+        frameTransforms = updateUniformBuffer(currentFrame);
+        const MVPTransforms &transforms = frameTransforms;
+        clusteredLighting->update(currentFrame, lights, ClusterCamera{
+                .view = transforms.view,
+                .projection = transforms.proj,
+                .zNear = Z_NEAR,
+                .zFar = Z_FAR,
+                .renderExtent = renderExtent,
+        });
+        sceneCuller.update();
+        if (depthReadback) {
+            updateHiZPyramid();
+        }
+        const auto visibleTransforms = sceneCuller.cull(Frustum::fromMatrix(transforms.proj * transforms.view),
+                                                        hiZPyramid.isEmpty() ? nullptr : &hiZPyramid, &jobSystem);
+        // every draw's view context and object record are independent, so they're built in batches across the job system
+        const size_t drawCount = std::min<size_t>(visibleTransforms.size(), MAX_OBJECTS);
+        frameStats.frameNumber = frameNumber;
+        frameStats.visibleObjects = static_cast<uint32_t>(drawCount);
+        meshDraws.resize(drawCount);
+        objectRecords.resize(drawCount);
+        jobSystem.parallelFor(drawCount, 64, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const TransformHandle object = visibleTransforms[i];
+                const glm::mat4 &model = transformStore.getWorldMatrix(object);
+                objectRecords[i] = ObjectRecord{.model = model, .materialIndex = materials[object % materials.size()]};
+                // meshlet bounds and LOD errors are in model space, so bring the frustum and camera into model space rather
+                // than moving every meshlet
+                meshDraws[i] = MeshDraw{
+                        // every object is the same mesh for now
+                        .mesh = mesh.get(),
+                        .viewContext = {
+                                .frustum = Frustum::fromMatrix(transforms.proj * transforms.view * model),
+                                .cameraPosition = glm::vec3(glm::inverse(transforms.view * model) * glm::vec4(0.f, 0.f, 0.f, 1.f)),
+                                // proj[1][1] is 1 / tan(fovY / 2), flipped for Vulkan
+                                // LODs are picked against the pixels actually rendered, so lower scales drop detail as well
+                                .projectionScale = std::abs(transforms.proj[1][1]) * static_cast<float>(renderExtent.height) * 0.5f,
+                        },
+                        .objectIndex = static_cast<uint32_t>(i),
+                };
+                // each object keeps its own LOD between frames, the same mesh can be close up for one and far off for another.
+                // Visible transforms are unique so no two jobs touch the same entry
+                meshDraws[i].lod = meshDraws[i].mesh->selectLod(meshDraws[i].viewContext, objectLods[object]);
+                objectLods[object] = meshDraws[i].lod;
+            }
+        });
+        objectBuffers[currentFrame].writeData(objectRecords.data(), objectRecords.size() * sizeof(ObjectRecord));
+
+        // the output image is first touched by the upscale blit, headless ones are ready as soon as they're acquired
+        std::vector<vk::Semaphore> waitSemaphores;
+        std::vector<vk::PipelineStageFlags> waitStages;
+        if (output.isPresented()) {
+            waitSemaphores.push_back(*imageAvailableSemaphores[currentFrame]);
+            waitStages.push_back(vk::PipelineStageFlagBits::eTransfer);
+        }
+        if (asyncCompute) {
+            submitAsyncLightCulling(waitSemaphores, waitStages);
+        }
 
         commandBuffers[currentFrame].reset();
-        graphicsPipeline->recordCommandBuffer(commandBuffers[currentFrame],
-                                              swapchainManager->getSwapchainFramebuffer(nextImageIndex),
-                                              descriptorSets[currentFrame], swapchainManager->getExtent());
+        vk::CommandBufferBeginInfo beginInfo{};
+        commandBuffers[currentFrame].begin(beginInfo);
+        gpuTimer.beginFrame(commandBuffers[currentFrame], currentFrame);
+        // anything uploaded since the last frame is handed over before the graph runs
+        uploadQueue.recordAcquires(commandBuffers[currentFrame], currentFrame, waitSemaphores, waitStages);
+        // the acquire semaphore is waited on at the transfer stage, which is what the output image's first barrier chains off
+        renderGraph->setImportedImage(outputImage, output.getImage(nextImageIndex),
+                                      ResourceAccess{.stages = vk::PipelineStageFlagBits::eTransfer});
+        // per frame in flight buffers, which this frame's fence wait means the GPU is done with
+        renderGraph->setImportedBuffer(clusterLightCountsBuffer, clusteredLighting->getLightCountsBuffer(currentFrame));
+        renderGraph->setImportedBuffer(clusterLightIndicesBuffer, clusteredLighting->getLightIndicesBuffer(currentFrame));
+        if (depthReadback) {
+            renderGraph->setImportedBuffer(depthReadbackBuffer, depthReadback->getBuffer(currentFrame));
+        }
+        renderGraph->execute(commandBuffers[currentFrame]);
+        commandBuffers[currentFrame].end();
 
-        vk::Semaphore waitSemaphores[] = {*imageAvailableSemaphores[currentFrame]};
-        std::vector<vk::Semaphore> signalSemaphores{*renderFinishedSemaphores[currentFrame]};
-        vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
+        // nothing waits on a headless frame but its fence
+        std::vector<vk::Semaphore> signalSemaphores;
+        if (output.isPresented()) {
+            signalSemaphores.push_back(*renderFinishedSemaphores[currentFrame]);
+        }
         vk::SubmitInfo submitInfo{
-                .waitSemaphoreCount = 1,
-                .pWaitSemaphores = waitSemaphores,
-                .pWaitDstStageMask = waitStages,
+                .waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size()),
+                .pWaitSemaphores = waitSemaphores.data(),
+                .pWaitDstStageMask = waitStages.data(),
                 .commandBufferCount = 1,
                 .pCommandBuffers = &*commandBuffers[currentFrame],
-                .signalSemaphoreCount = 1,
+                .signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size()),
                 .pSignalSemaphores = signalSemaphores.data(),
         };
 
         graphicsQueue.submit(submitInfo, *inFlightFences[currentFrame]);
 
-        if (swapchainManager->present(signalSemaphores, presentQueue, nextImageIndex) ==
-            PresentResult::SWAPCHAIN_OUT_OF_DATE) {
+        if (output.present(signalSemaphores, nextImageIndex) == PresentResult::SWAPCHAIN_OUT_OF_DATE) {
             return DrawFrameResult::SWAPCHAIN_OUT_OF_DATE;
         }
 
         currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+        frameNumber++;
         return DrawFrameResult::SUCCESS;
     }
 
+    void FrameCoordinator::submitAsyncLightCulling(std::vector<vk::Semaphore> &waitSemaphores,
+                                                   std::vector<vk::PipelineStageFlags> &waitStages) {
+        // this slot's graphics submit waited on the last culling in it, so the fence wait means it's finished
+        vkr::CommandBuffer &commandBuffer = computeCommandBuffers[currentFrame];
+        commandBuffer.reset();
+        commandBuffer.begin(vk::CommandBufferBeginInfo{.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+        clusteredLighting->recordLightCulling(commandBuffer, frameDescriptorSet);
+        commandBuffer.end();
+        computeQueue.submit(vk::SubmitInfo{
+                .commandBufferCount = 1,
+                .pCommandBuffers = &*commandBuffer,
+                .signalSemaphoreCount = 1,
+                .pSignalSemaphores = &*lightCullingFinishedSemaphores[currentFrame],
+        });
+        // only shading reads the clusters, so the vertex work and the depth pre-pass overlap the culling
+        waitSemaphores.push_back(*lightCullingFinishedSemaphores[currentFrame]);
+        waitStages.push_back(vk::PipelineStageFlagBits::eFragmentShader);
+    }
 
-    vkr::DescriptorSetLayout FrameCoordinator::createDescriptorSetLayout() {
-        vk::DescriptorSetLayoutBinding uboLayoutBinding{
-                .binding = 0,
-                .descriptorType = vk::DescriptorType::eUniformBuffer,
-                .descriptorCount = 1,
-                .stageFlags = vk::ShaderStageFlagBits::eVertex,
-                .pImmutableSamplers = nullptr
-        };
+    void FrameCoordinator::reportGpuTimings() {
+        constexpr uint64_t REPORT_INTERVAL = 300;
+        if (!gpuTimer.isSupported() || frameNumber == 0 || frameNumber % REPORT_INTERVAL != 0) {
+            return;
+        }
+        std::string report;
+        for (const auto &scope: gpuTimer.getScopes()) {
+            report += fmt::format(" {} {:.3f}ms", scope.name, scope.milliseconds);
+        }
+        const vk::Extent2D renderExtent = dynamicResolution.getRenderExtent(output.getExtent());
+        SPDLOG_INFO("GPU timings (depth pre-pass {}, render scale {:.2f} {}x{}):{} total {:.3f}ms", props.depthPrePass ? "on" : "off",
+                    dynamicResolution.getScale(), renderExtent.width, renderExtent.height, report,
+                    gpuTimer.getTotalMilliseconds());
+    }
 
-        vk::DescriptorSetLayoutBinding samplerLayoutBinding{
-                .binding = 1,
-                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
-                .descriptorCount = 1,
-                .stageFlags = vk::ShaderStageFlagBits::eFragment,
-                .pImmutableSamplers = nullptr,
-        };
+    void FrameCoordinator::updateHiZPyramid() {
+        // this frame's fence was waited on so its slot holds finished depth, the previous frame may have finished as well
+        // in which case its depth is a frame newer
+        const size_t previousFrame = (currentFrame + MAX_FRAMES_IN_FLIGHT - 1) % MAX_FRAMES_IN_FLIGHT;
+        size_t newestFrame = currentFrame;
+        if (depthReadback->hasDepth(previousFrame) && inFlightFences[previousFrame].getStatus() == vk::Result::eSuccess) {
+            newestFrame = previousFrame;
+        }
+        if (!depthReadback->hasDepth(newestFrame) || depthReadback->getFrameNumber(newestFrame) == hiZFrameNumber) {
+            return;
+        }
+        depthReadback->readDepth(newestFrame, readbackDepth);
+        const vk::Extent2D extent = depthReadback->getExtent(newestFrame);
+        hiZPyramid.build(readbackDepth, extent.width, extent.height, depthReadback->getViewProjection(newestFrame));
+        hiZFrameNumber = depthReadback->getFrameNumber(newestFrame);
+    }
 
-        std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
-                uboLayoutBinding,
-                samplerLayoutBinding,
-        };
 
-        vk::DescriptorSetLayoutCreateInfo layoutCreateInfo{
-                .bindingCount = static_cast<uint32_t>(bindings.size()),
-                .pBindings = bindings.data()
-        };
-        return {device, layoutCreateInfo};
+    ShaderReflection FrameCoordinator::reflectFrameShaders() {
+        std::vector<ShaderReflection> shaders;
+        for (const auto *name: {"triangle.vert", "triangle.frag", "depth_prepass.vert", "cluster_lights.comp"}) {
+            const std::vector<uint32_t> code = shaderLibrary.load(name);
+            shaders.push_back(ShaderReflection::reflect(std::as_bytes(std::span(code))));
+        }
+        return ShaderReflection::merge(shaders);
     }
 
     std::vector<WritableDirectBuffer> FrameCoordinator::createUbos() {
@@ -235,56 +508,82 @@ namespace Rehnda {
         return buffers;
     }
 
-    void FrameCoordinator::setFramebufferResized() {
+    std::vector<WritableDirectBuffer> FrameCoordinator::createObjectBuffers() {
+        const WritableDirectBufferProps bufferProps{
+                .dataSize = static_cast<vk::DeviceSize>(MAX_OBJECTS) * sizeof(ObjectRecord),
+                .bufferUsageFlags = vk::BufferUsageFlagBits::eStorageBuffer,
+        };
+        std::vector<WritableDirectBuffer> buffers;
+        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+            buffers.emplace_back(device, physicalDevice, bufferProps);
+        }
+        return buffers;
+    }
+
+    void FrameCoordinator::setFramebufferResized(vk::Extent2D extent) {
+        framebufferExtent = static_cast<uint64_t>(extent.width) << 32 | extent.height;
         framebufferResized = true;
     }
 
-    void FrameCoordinator::updateUniformBuffer(uint32_t currentImage) {
-        static auto startTime = std::chrono::high_resolution_clock::now();
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+    void FrameCoordinator::setDepthPrePass(bool enabled) {
+        if (requestedDepthPrePass.exchange(enabled) != enabled) {
+            SPDLOG_INFO("Depth pre-pass {}", enabled ? "enabled" : "disabled");
+        }
+    }
+
+    bool FrameCoordinator::isDepthPrePassEnabled() const {
+        return requestedDepthPrePass;
+    }
+
+    const FrameStats &FrameCoordinator::getFrameStats() const {
+        return frameStats;
+    }
+
+    void FrameCoordinator::applyCommands(const RenderCommandStream &commands) {
+        auto reader = commands.read();
+        while (const auto command = reader.next()) {
+            if (const auto *renderCamera = std::get_if<RenderCamera>(&*command)) {
+                camera = *renderCamera;
+            } else if (const auto *renderTransform = std::get_if<RenderTransform>(&*command)) {
+                transformStore.setPosition(renderTransform->transform, renderTransform->position);
+                transformStore.setRotation(renderTransform->transform, renderTransform->rotation);
+                transformStore.setScale(renderTransform->transform, renderTransform->scale);
+            } else if (const auto *renderLights = std::get_if<std::span<const PointLight>>(&*command)) {
+                // copied as the stream goes back to the game once the frame is drawn, the capacity sticks around after the
+                // first frame so this doesn't allocate
+                lights.assign(renderLights->begin(), renderLights->end());
+            }
+        }
+    }
+
+    MVPTransforms FrameCoordinator::updateUniformBuffer(uint32_t currentImage) {
+        transformStore.updateWorldMatrices();
 
         // TODO#1 for frequently changing values such as the MVP transforms, push constants are more efficient than UBOs
         MVPTransforms mvpTransforms{};
-        mvpTransforms.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.f), glm::vec3(0.0, 0.0, 1.0f));
-        mvpTransforms.view = glm::lookAt(glm::vec3(2.0, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f),
-                                         glm::vec3(0.0, 0.0f, 1.0f));
-        mvpTransforms.proj = glm::perspective(glm::radians(45.f), swapchainManager->getExtent().width /
-                                                                  (float) swapchainManager->getExtent().height, 0.1f,
-                                              10.f);
+        mvpTransforms.view = camera.view;
+        mvpTransforms.proj = glm::perspective(camera.fovY, output.getExtent().width /
+                                                                  (float) output.getExtent().height, Z_NEAR,
+                                              Z_FAR);
         // negate the y scaling factor of the projection matrix as GLM was designed for OpenGL where the y clip co-ordinates are inverted
         mvpTransforms.proj[1][1] *= -1;
         uboBuffers[currentImage].writeData(&mvpTransforms);
+        return mvpTransforms;
     }
 
-    vkr::DescriptorPool FrameCoordinator::createDescriptorPool() {
-        std::array<vk::DescriptorPoolSize, 2> poolSizes{
-                vk::DescriptorPoolSize{
-                        .type = vk::DescriptorType::eUniformBuffer,
-                        .descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT)
-                },
-                vk::DescriptorPoolSize{
-                        .type = vk::DescriptorType::eCombinedImageSampler,
-                        .descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT)
-                },
-        };
-        vk::DescriptorPoolCreateInfo poolCreateInfo{
-                .flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
-                .maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT),
-                .poolSizeCount = poolSizes.size(),
-                .pPoolSizes = poolSizes.data()
-        };
-        return {device, poolCreateInfo};
-    }
-
-    vkr::DescriptorSets FrameCoordinator::createDescriptorSets() {
-        std::vector<vk::DescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, *descriptorSetLayout);
-        vk::DescriptorSetAllocateInfo descriptorSetAllocateInfo{
-                .descriptorPool = *descriptorPool,
-                .descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT),
-                .pSetLayouts = layouts.data()
-        };
-        return {device, descriptorSetAllocateInfo};
+    void FrameCoordinator::writeFrameDescriptorSet() {
+        std::vector<DescriptorWrite> writes = clusteredLighting->getDescriptorWrites(currentFrame);
+        writes.push_back(DescriptorWrite{
+                .binding = 0,
+                .type = vk::DescriptorType::eUniformBuffer,
+                .bufferInfo = {.buffer = *uboBuffers[currentFrame].getBuffer(), .offset = 0, .range = sizeof(MVPTransforms)},
+        });
+        writes.push_back(DescriptorWrite{
+                .binding = OBJECTS_BINDING,
+                .type = vk::DescriptorType::eStorageBuffer,
+                .bufferInfo = {.buffer = *objectBuffers[currentFrame].getBuffer(), .offset = 0, .range = VK_WHOLE_SIZE},
+        });
+        frameDescriptorSet = frameSetCache.get(frameSetLayout, writes);
     }
 
     std::vector<vkr::Semaphore> FrameCoordinator::createSemaphores(size_t numToCreate) {
@@ -0,0 +1,117 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/GpuTimer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Rehnda {
+    GpuTimer::GpuTimer(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, uint32_t queueFamilyIndex,
+                       size_t framesInFlight) :
+            device(device),
+            supported(physicalDevice.getProperties().limits.timestampComputeAndGraphics &&
+                      physicalDevice.getQueueFamilyProperties()[queueFamilyIndex].timestampValidBits > 0),
+            timestampPeriod(physicalDevice.getProperties().limits.timestampPeriod),
+            frameQueries(createFrameQueries(framesInFlight)) {
+    }
+
+    std::vector<GpuTimer::FrameQueries> GpuTimer::createFrameQueries(size_t framesInFlight) {
+        std::vector<FrameQueries> queries;
+        if (!supported) {
+            return queries;
+        }
+        const vk::QueryPoolCreateInfo queryPoolCreateInfo{
+                .queryType = vk::QueryType::eTimestamp,
+                // a begin and end timestamp per scope
+                .queryCount = MAX_SCOPES * 2,
+        };
+        for (size_t i = 0; i < framesInFlight; i++) {
+            queries.push_back(FrameQueries{.queryPool = {device, queryPoolCreateInfo}, .scopeNames = {}});
+        }
+        return queries;
+    }
+
+    void GpuTimer::beginFrame(vkr::CommandBuffer &commandBuffer, size_t frameIndex) {
+        recordingFrame = frameIndex;
+        if (!supported) {
+            return;
+        }
+        frameQueries[frameIndex].scopeNames.clear();
+        commandBuffer.resetQueryPool(*frameQueries[frameIndex].queryPool, 0, MAX_SCOPES * 2);
+    }
+
+    void GpuTimer::beginScope(vkr::CommandBuffer &commandBuffer, std::string_view name) {
+        if (!supported) {
+            return;
+        }
+        auto &frame = frameQueries[recordingFrame];
+        if (frame.scopeNames.size() >= MAX_SCOPES) {
+            throw std::runtime_error("Too many GPU timer scopes in one frame");
+        }
+        const auto query = static_cast<uint32_t>(frame.scopeNames.size() * 2);
+        frame.scopeNames.push_back(name);
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *frame.queryPool, query);
+    }
+
+    void GpuTimer::endScope(vkr::CommandBuffer &commandBuffer) {
+        if (!supported) {
+            return;
+        }
+        auto &frame = frameQueries[recordingFrame];
+        const auto query = static_cast<uint32_t>(frame.scopeNames.size() * 2 - 1);
+        commandBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, *frame.queryPool, query);
+    }
+
+    void GpuTimer::collect(size_t frameIndex) {
+        if (!supported || frameQueries[frameIndex].scopeNames.empty()) {
+            return;
+        }
+        const auto &frame = frameQueries[frameIndex];
+        const auto queryCount = static_cast<uint32_t>(frame.scopeNames.size() * 2);
+        const auto [result, timestamps] = frame.queryPool.getResults<uint64_t>(
+                0, queryCount, queryCount * sizeof(uint64_t), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+        if (result != vk::Result::eSuccess) {
+            return;
+        }
+        constexpr double SMOOTHING = 0.1;
+        // scopes that weren't recorded this frame are dropped, so switching a pass off doesn't leave a stale timing behind
+        std::vector<GpuTimerScope> collected;
+        lastFrameMilliseconds = 0.0;
+        for (size_t i = 0; i < frame.scopeNames.size(); i++) {
+            const double milliseconds = static_cast<double>(timestamps[i * 2 + 1] - timestamps[i * 2]) * timestampPeriod * 1e-6;
+            lastFrameMilliseconds += milliseconds;
+            const auto existing = std::find_if(scopes.begin(), scopes.end(), [&](const GpuTimerScope &scope) {
+                return scope.name == frame.scopeNames[i];
+            });
+            if (existing == scopes.end()) {
+                collected.push_back({.name = frame.scopeNames[i], .milliseconds = milliseconds});
+            } else {
+                collected.push_back({.name = frame.scopeNames[i],
+                                     .milliseconds = existing->milliseconds + (milliseconds - existing->milliseconds) * SMOOTHING});
+            }
+        }
+        scopes = std::move(collected);
+    }
+
+    std::span<const GpuTimerScope> GpuTimer::getScopes() const {
+        return scopes;
+    }
+
+    double GpuTimer::getTotalMilliseconds() const {
+        double total = 0.0;
+        for (const auto &scope: scopes) {
+            total += scope.milliseconds;
+        }
+        return total;
+    }
+
+    double GpuTimer::getLastFrameMilliseconds() const {
+        return lastFrameMilliseconds;
+    }
+
+    bool GpuTimer::isSupported() const {
+        return supported;
+    }
+}
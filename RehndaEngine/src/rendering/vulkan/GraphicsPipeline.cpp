@@ -3,10 +3,13 @@
 //
 
 #include "rendering/vulkan/GraphicsPipeline.hpp"
-#include "core/FileUtils.hpp"
 #include "rendering/Vertex.hpp"
 #include "rendering/vulkan/DepthImage.hpp"
 
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
 namespace Rehnda {
 
 
@@ -19,59 +22,140 @@ namespace Rehnda {
      * @param device
      * @param swapchainManager
      */
-    GraphicsPipeline::GraphicsPipeline(vkr::Device &device, vkr::PhysicalDevice& physicalDevice, vk::Format imageFormat, RenderableMesh &renderableMesh,
-                                       vkr::DescriptorSetLayout &descriptorSetLayout) :
+    GraphicsPipeline::GraphicsPipeline(vkr::Device &device, vkr::PhysicalDevice& physicalDevice, ShaderLibrary &shaderLibrary, vk::Format imageFormat,
+                                       const VertexInputDescription &vertexInput, PipelineLayoutCache &layoutCache,
+                                       std::span<const vk::DescriptorSetLayout> setLayouts, size_t framesInFlight, bool retainDepth) :
             device(device),
             physicalDevice(physicalDevice),
-            renderPass(createRenderPass(imageFormat)),
-            pipelineLayout(createPipelineLayout(descriptorSetLayout)),
-            pipeline(createPipeline()),
-            mesh(renderableMesh) {
+            shaderLibrary(shaderLibrary),
+            layoutCache(layoutCache),
+            vertexInput(vertexInput),
+            setLayouts(setLayouts.begin(), setLayouts.end()),
+            renderPass(createRenderPass(imageFormat, retainDepth)),
+            pipelineLayout(createPipelineLayout()),
+            reload(framesInFlight),
+            shaderWatch(shaderLibrary.watch({"depth_prepass.vert", "triangle.vert", "triangle.frag"}, [this]() { rebuild(); })) {
     }
 
-    vkr::PipelineLayout GraphicsPipeline::createPipelineLayout(vkr::DescriptorSetLayout &descriptorSetLayout) {
-        vk::PipelineLayoutCreateInfo pipelineLayoutCreateInfo{
-                .setLayoutCount = 1,
-                .pSetLayouts = &*descriptorSetLayout,
-                .pushConstantRangeCount = 0,
-                .pPushConstantRanges = nullptr,
-        };
-        return {device, pipelineLayoutCreateInfo};
+    vk::PipelineLayout GraphicsPipeline::createPipelineLayout() {
+        // every variant shares the one layout, so it has to satisfy all of their shaders
+        std::vector<ShaderReflection> shaders;
+        for (const auto *name: {"depth_prepass.vert", "triangle.vert", "triangle.frag"}) {
+            const std::vector<uint32_t> code = shaderLibrary.load(name);
+            shaders.push_back(ShaderReflection::reflect(std::as_bytes(std::span(code))));
+        }
+        const ShaderReflection reflection = ShaderReflection::merge(shaders);
+        reflection.validateVertexInput(vertexInput);
+        if (reflection.getSetCount() > setLayouts.size()) {
+            throw std::runtime_error("Graphics shaders use more descriptor sets than the layouts given");
+        }
+        for (uint32_t set = 0; set < reflection.getSetCount(); set++) {
+            layoutCache.getSetLayoutDesc(setLayouts[set]).validateReflection(reflection, set);
+        }
+        return layoutCache.getPipelineLayout(setLayouts, reflection.getPushConstantRanges());
+    }
+
+    GraphicsPipeline::Pipelines GraphicsPipeline::createPipelines(std::span<const ShaderPermutation> pipelinePermutations) {
+        Pipelines created;
+        for (const auto &permutation: pipelinePermutations) {
+            for (const auto variant: {PipelineVariant::DEPTH_PRE_PASS, PipelineVariant::MAIN, PipelineVariant::MAIN_AFTER_PRE_PASS}) {
+                created.emplace(PipelineKey{.variant = variant, .permutation = permutation}, createPipeline(variant, permutation));
+            }
+        }
+        return created;
     }
 
-    vkr::Pipeline GraphicsPipeline::createPipeline() {
-        auto vertShaderCode = FileUtils::readFileAsBytes("shaders/triangle.vert.spv");
-        auto fragShaderCode = FileUtils::readFileAsBytes("shaders/triangle.frag.spv");
+    void GraphicsPipeline::preparePermutation(const ShaderPermutation &permutation) {
+        if (pipelines.contains(PipelineKey{.variant = PipelineVariant::MAIN, .permutation = permutation})) {
+            return;
+        }
+        pipelines.merge(createPipelines(std::span(&permutation, 1)));
+        std::lock_guard lock(permutationsMutex);
+        if (std::find(permutations.begin(), permutations.end(), permutation) == permutations.end()) {
+            permutations.push_back(permutation);
+        }
+    }
 
-        auto vertShaderModule = createShaderModule(vertShaderCode);
-        auto fragShaderModule = createShaderModule(fragShaderCode);
+    vkr::Pipeline &GraphicsPipeline::getPipeline(PipelineVariant variant, const ShaderPermutation &permutation) {
+        const PipelineKey key{.variant = variant, .permutation = permutation};
+        if (const auto it = pipelines.find(key); it != pipelines.end()) {
+            return it->second;
+        }
+        // also hit when a reload raced a permutation being prepared, the rebuilt set just didn't include it yet
+        SPDLOG_WARN("Building pipelines for a shader permutation while recording, prepare it ahead of time to avoid the stall");
+        preparePermutation(permutation);
+        return pipelines.at(key);
+    }
 
-        // can use pSpecializationInfo to specify shader constants at compile time, which allows the compiler to optimise
+    void GraphicsPipeline::rebuild() {
+        // the descriptor sets bound each frame are built for the current layouts, so an edit that changes what the shaders
+        // bind or push is turned away rather than swapped in under sets that don't match. Those need a restart. Creating
+        // the layout checks every binding the new shaders declare against the set layouts
+        if (createPipelineLayout() != pipelineLayout) {
+            throw std::runtime_error("Graphics shaders changed their pipeline layout, restart to pick that up");
+        }
+        std::vector<ShaderPermutation> prepared;
+        {
+            std::lock_guard lock(permutationsMutex);
+            prepared = permutations;
+        }
+        reload.offer(createPipelines(prepared));
+    }
+
+    void GraphicsPipeline::applyReload(uint64_t frameNumber) {
+        if (reload.apply(pipelines, frameNumber)) {
+            SPDLOG_INFO("Reloaded graphics pipelines");
+        }
+    }
+
+    vkr::Pipeline GraphicsPipeline::createPipeline(PipelineVariant variant, const ShaderPermutation &permutation) {
+        const bool depthOnly = variant == PipelineVariant::DEPTH_PRE_PASS;
+        const std::vector<uint32_t> vertShaderCode = shaderLibrary.load(depthOnly ? "depth_prepass.vert" : "triangle.vert");
+        auto vertShaderModule = createShaderModule(vertShaderCode);
+        // the pre-pass has no fragment shader at all, depth comes straight from rasterization so early-Z always applies and
+        // no fragment is ever shaded. triangle.frag isn't even loaded for it
+        vkr::ShaderModule fragShaderModule{nullptr};
+        if (!depthOnly) {
+            fragShaderModule = createShaderModule(shaderLibrary.load("triangle.frag"));
+        }
+
+        // the permutation's constants are folded in when the driver compiles the pipeline, entries for ids a stage doesn't
+        // declare are ignored so both stages get the same data
+        const SpecializationData specializationData(permutation.getConstants());
         vk::PipelineShaderStageCreateInfo vertShaderStageCreateInfo{
                 .stage = vk::ShaderStageFlagBits::eVertex,
                 .module = *vertShaderModule,
                 .pName = "main",
+                .pSpecializationInfo = specializationData.getInfo(),
         };
 
-        vk::PipelineShaderStageCreateInfo fragShaderStageCreateInfo{
-                .stage = vk::ShaderStageFlagBits::eFragment,
-                .module = *fragShaderModule,
-                .pName = "main",
-        };
-
-        vk::PipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageCreateInfo, fragShaderStageCreateInfo};
-
-        const auto vertBindingDescription = Vertex::getBindingDescription();
-        const auto vertAttributeDescriptions = Vertex::getAttributeDescriptions();
+        std::vector<vk::PipelineShaderStageCreateInfo> shaderStages{vertShaderStageCreateInfo};
+        if (!depthOnly) {
+            shaderStages.push_back(vk::PipelineShaderStageCreateInfo{
+                    .stage = vk::ShaderStageFlagBits::eFragment,
+                    .module = *fragShaderModule,
+                    .pName = "main",
+                    .pSpecializationInfo = specializationData.getInfo(),
+            });
+        }
+
+
+        // the pre-pass only fetches position, it reads the same interleaved buffer but skips every other attribute
+        std::vector<vk::VertexInputAttributeDescription> attributes;
+        for (const auto &attribute: vertexInput.attributes) {
+            if (!depthOnly || attribute.location == 0) {
+                attributes.push_back(attribute);
+            }
+        }
 
         // describe the format of the vertex data to be passed in
         vk::PipelineVertexInputStateCreateInfo vertexInputCreateInfo{
                 // bindings specify spacing between data and whether per-vertex or instance
                 .vertexBindingDescriptionCount = 1,
-                .pVertexBindingDescriptions = &vertBindingDescription,
+                .pVertexBindingDescriptions = &vertexInput.binding,
                 // attributes describe the type of attributes passed, which binding to load them from and at what offset
-                .vertexAttributeDescriptionCount = static_cast<uint32_t>(vertAttributeDescriptions.size()),
-                .pVertexAttributeDescriptions = vertAttributeDescriptions.data(),
+                .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributes.size()),
+                .pVertexAttributeDescriptions = attributes.data(),
         };
 
         // input assembly describes what kind of geometry will be drawn from vertices, and if primitive restart should be enabled
@@ -122,14 +206,17 @@ namespace Rehnda {
 
         vk::PipelineColorBlendStateCreateInfo colorBlending{
                 .logicOpEnable = VK_FALSE,
-                .attachmentCount = 1,
+                .attachmentCount = depthOnly ? 0u : 1u,
                 .pAttachments = &colorBlendAttachmentState,
         };
 
+        // after a pre-pass the depth buffer already holds the nearest surface, so only the fragment that put it there
+        // passes and every hidden fragment is rejected before shading. Invariant gl_Position keeps both passes' depth identical
+        const bool afterPrePass = variant == PipelineVariant::MAIN_AFTER_PRE_PASS;
         vk::PipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo{
             .depthTestEnable = true,
-            .depthWriteEnable = true,
-            .depthCompareOp = vk::CompareOp::eLess,
+            .depthWriteEnable = !afterPrePass,
+            .depthCompareOp = afterPrePass ? vk::CompareOp::eEqual : vk::CompareOp::eLess,
             // depth bounds can be used to only keep fragments in a certain range
             .depthBoundsTestEnable = false,
             .stencilTestEnable = false,
@@ -141,8 +228,8 @@ namespace Rehnda {
 
         vk::GraphicsPipelineCreateInfo graphicsPipelineCreateInfo{
                 // --- SHADER STAGE DESCRIPTIONS ---
-                .stageCount = 2,
-                .pStages = shaderStages,
+                .stageCount = static_cast<uint32_t>(shaderStages.size()),
+                .pStages = shaderStages.data(),
                 // --- FIXED FUNCTION STAGE DESCRIPTION ---
                 .pVertexInputState = &vertexInputCreateInfo,
                 .pInputAssemblyState = &inputAssembly,
@@ -153,10 +240,10 @@ namespace Rehnda {
                 .pColorBlendState = &colorBlending,
                 .pDynamicState = &dynamicStateCreateInfo,
                 // --- PIPELINE LAYOUT ---
-                .layout = *pipelineLayout,
+                .layout = pipelineLayout,
                 // --- RENDER PASS ---
                 .renderPass = *renderPass,
-                .subpass = 0,
+                .subpass = depthOnly ? 0u : 1u,
                 // --- OPTIONAL BASE PIPELINE,
                 .basePipelineHandle = VK_NULL_HANDLE,
                 .basePipelineIndex = -1,
@@ -165,15 +252,15 @@ namespace Rehnda {
         return {device, VK_NULL_HANDLE, graphicsPipelineCreateInfo};
     }
 
-    vkr::ShaderModule GraphicsPipeline::createShaderModule(const std::vector<char> &code) {
+    vkr::ShaderModule GraphicsPipeline::createShaderModule(std::span<const uint32_t> code) {
         vk::ShaderModuleCreateInfo createInfo{
-                .codeSize = code.size(),
-                .pCode = reinterpret_cast<const uint32_t *>(code.data()),
+                .codeSize = code.size_bytes(),
+                .pCode = code.data(),
         };
         return {device, createInfo};
     }
 
-    vkr::RenderPass GraphicsPipeline::createRenderPass(vk::Format imageFormat) {
+    vkr::RenderPass GraphicsPipeline::createRenderPass(vk::Format imageFormat, bool retainDepth) {
         vk::AttachmentDescription colorAttachment{
                 .format = imageFormat,
                 .samples = vk::SampleCountFlagBits::e1,
@@ -181,10 +268,9 @@ namespace Rehnda {
                 .storeOp = vk::AttachmentStoreOp::eStore,
                 .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
                 .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
-                // since we are clearing at the start, the initial layout doesn't matter
-                .initialLayout = vk::ImageLayout::eUndefined,
-                // since we are rendering to the swapchainManager we use PresentSrcKHR
-                .finalLayout = vk::ImageLayout::ePresentSrcKHR,
+                // the render graph has the attachments in their layouts before the pass starts and moves them on afterwards
+                .initialLayout = vk::ImageLayout::eColorAttachmentOptimal,
+                .finalLayout = vk::ImageLayout::eColorAttachmentOptimal,
         };
         vk::AttachmentReference colorAttachmentRef{
                 .attachment = 0,
@@ -195,12 +281,10 @@ namespace Rehnda {
                 .format = DepthImage::findDepthFormat(physicalDevice),
                 .samples = vk::SampleCountFlagBits::e1,
                 .loadOp = vk::AttachmentLoadOp::eClear,
-                .storeOp = vk::AttachmentStoreOp::eDontCare,
+                .storeOp = retainDepth ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare,
                 .stencilLoadOp = vk::AttachmentLoadOp::eDontCare,
                 .stencilStoreOp = vk::AttachmentStoreOp::eDontCare,
-                // since we are clearing at the start, the initial layout doesn't matter
-                .initialLayout = vk::ImageLayout::eUndefined,
-                // since we are rendering to the swapchainManager we use PresentSrcKHR
+                .initialLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal,
                 .finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal,
         };
         vk::AttachmentReference depthAttachmentRef{
@@ -208,7 +292,13 @@ namespace Rehnda {
             .layout = vk::ImageLayout::eDepthStencilAttachmentOptimal
         };
 
-        vk::SubpassDescription subpass{
+        vk::SubpassDescription depthPrePassSubpass{
+                .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
+                .colorAttachmentCount = 0,
+                .pDepthStencilAttachment = &depthAttachmentRef,
+        };
+
+        vk::SubpassDescription mainSubpass{
                 .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
                 .colorAttachmentCount = 1,
                 // the index of the attachment in the below array is what is referenced in the shader (e.g. "layout(location = 0) out vec4 outColor;")
@@ -216,23 +306,26 @@ namespace Rehnda {
                 .pDepthStencilAttachment = &depthAttachmentRef,
         };
 
+        // waiting on whatever came before or after the render pass is down to the barriers the render graph records around
+        // it, only the dependency between the subpasses lives here
         vk::SubpassDependency subpassDependency{
-                .srcSubpass = VK_SUBPASS_EXTERNAL, // this refers to the implicit subpass before the render pass
-                .dstSubpass = 0, // this refers to our subpass, the first and only one
-                // we need to wait for the swap chain to finish reading from the image before we access it
-                // and ensure the depth image is cleared before we try use it
-                .srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests,
-                .dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests,
-                .srcAccessMask = vk::AccessFlagBits::eNone,
-                .dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+                .srcSubpass = 0,
+                .dstSubpass = 1,
+                // pre-pass depth writes must land before the main pass tests (and possibly writes) against them
+                .srcStageMask = vk::PipelineStageFlagBits::eLateFragmentTests,
+                .dstStageMask = vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+                .srcAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+                .dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+                .dependencyFlags = vk::DependencyFlagBits::eByRegion,
         };
 
         std::array<vk::AttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+        std::array<vk::SubpassDescription, 2> subpasses = {depthPrePassSubpass, mainSubpass};
         vk::RenderPassCreateInfo renderPassCreateInfo{
                 .attachmentCount = attachments.size(),
                 .pAttachments = attachments.data(),
-                .subpassCount = 1,
-                .pSubpasses = &subpass,
+                .subpassCount = subpasses.size(),
+                .pSubpasses = subpasses.data(),
                 .dependencyCount = 1,
                 .pDependencies = &subpassDependency,
         };
@@ -241,11 +334,10 @@ namespace Rehnda {
     }
 
 
-    void GraphicsPipeline::recordCommandBuffer(vkr::CommandBuffer &commandBuffer, vkr::Framebuffer &targetFramebuffer,
-                                               vkr::DescriptorSet &currentDescriptorSet, vk::Extent2D extent) {
-        vk::CommandBufferBeginInfo beginInfo{};
-        commandBuffer.begin(beginInfo); // this implicitly resets the buffer
-
+    uint32_t GraphicsPipeline::recordRenderPass(vkr::CommandBuffer &commandBuffer, vkr::Framebuffer &targetFramebuffer,
+                                                std::span<const vk::DescriptorSet> descriptorSets, vk::Extent2D extent,
+                                                std::span<const MeshDraw> meshDraws, const ShaderPermutation &permutation,
+                                                bool depthPrePass, GpuTimer &gpuTimer) {
         std::array<vk::ClearValue, 2> clearColors{
                 vk::ClearValue{.color={.float32 = {{0.f, 0.f, 0.f, 1.f}}}},
                 // clear depth buffer to be equal to the farthest view plane (1.0)
@@ -265,7 +357,29 @@ namespace Rehnda {
 
         commandBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
 
-        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *pipeline);
+        // the framebuffer may be bigger than extent when rendering at a reduced scale, only the top left extent is touched
+        // the pre-pass subpass always exists so toggling it doesn't need a new render pass, it's just left empty when off
+        uint32_t drawCalls = 0;
+        if (depthPrePass) {
+            gpuTimer.beginScope(commandBuffer, "depth pre-pass");
+            drawCalls += drawMeshes(commandBuffer, descriptorSets, extent, getPipeline(PipelineVariant::DEPTH_PRE_PASS, permutation), meshDraws);
+            gpuTimer.endScope(commandBuffer);
+        }
+
+        commandBuffer.nextSubpass(vk::SubpassContents::eInline);
+
+        gpuTimer.beginScope(commandBuffer, "main pass");
+        const PipelineVariant mainVariant = depthPrePass ? PipelineVariant::MAIN_AFTER_PRE_PASS : PipelineVariant::MAIN;
+        drawCalls += drawMeshes(commandBuffer, descriptorSets, extent, getPipeline(mainVariant, permutation), meshDraws);
+        gpuTimer.endScope(commandBuffer);
+
+        commandBuffer.endRenderPass();
+        return drawCalls;
+    }
+
+    uint32_t GraphicsPipeline::drawMeshes(vkr::CommandBuffer &commandBuffer, std::span<const vk::DescriptorSet> descriptorSets,
+                                          vk::Extent2D extent, vkr::Pipeline &drawPipeline, std::span<const MeshDraw> meshDraws) {
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *drawPipeline);
 
         vk::Viewport viewport{
                 .x = 0.0f,
@@ -282,16 +396,20 @@ namespace Rehnda {
                 .extent = extent,
         };
         commandBuffer.setScissor(0, scissor);
-        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipelineLayout, 0, {*currentDescriptorSet},
-                                         nullptr);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, descriptorSets, nullptr);
 
-        mesh.draw(commandBuffer);
-
-        commandBuffer.endRenderPass();
-        commandBuffer.end();
+        uint32_t drawCalls = 0;
+        for (const auto &meshDraw: meshDraws) {
+            drawCalls += meshDraw.mesh->draw(commandBuffer, meshDraw.viewContext, meshDraw.lod, meshDraw.objectIndex);
+        }
+        return drawCalls;
     }
 
     const vkr::RenderPass& GraphicsPipeline::getRenderPass() const {
         return renderPass;
     }
+
+    size_t GraphicsPipeline::PipelineKeyHash::operator()(const PipelineKey &key) const {
+        return ShaderPermutation::Hash{}(key.permutation) * 31 + static_cast<size_t>(key.variant);
+    }
 }
\ No newline at end of file
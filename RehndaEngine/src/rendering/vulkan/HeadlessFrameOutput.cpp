@@ -0,0 +1,66 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/HeadlessFrameOutput.hpp"
+
+namespace Rehnda {
+    HeadlessFrameOutput::HeadlessFrameOutput(vkr::Device &device, vkr::PhysicalDevice &physicalDevice,
+                                             HeadlessFrameOutputProps props) :
+            props(props),
+            format(chooseFormat(physicalDevice)) {
+        for (size_t i = 0; i < props.imageCount; i++) {
+            images.push_back(std::make_unique<Image>(device, physicalDevice, ImageProps{
+                    .width = props.extent.width,
+                    .height = props.extent.height,
+                    .format = format,
+                    .tiling = vk::ImageTiling::eOptimal,
+                    // blitted into like a swapchain image, and left readable so a frame can be copied out
+                    .imageUsageFlags = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc,
+                    .memoryPropertyFlags = vk::MemoryPropertyFlagBits::eDeviceLocal,
+                    .imageAspectFlags = vk::ImageAspectFlagBits::eColor,
+            }));
+        }
+    }
+
+    vk::Format HeadlessFrameOutput::chooseFormat(const vkr::PhysicalDevice &physicalDevice) {
+        // the render target is created in the output's format too, so it has to be renderable and blittable both ways.
+        // Preferred in the same order the swapchain picks its surface format
+        return Image::findSupportedFormat(physicalDevice,
+                                          {vk::Format::eB8G8R8A8Srgb, vk::Format::eR8G8B8A8Srgb, vk::Format::eR8G8B8A8Unorm},
+                                          vk::ImageTiling::eOptimal,
+                                          vk::FormatFeatureFlagBits::eColorAttachment | vk::FormatFeatureFlagBits::eBlitSrc |
+                                          vk::FormatFeatureFlagBits::eBlitDst);
+    }
+
+    std::pair<vk::Result, uint32_t> HeadlessFrameOutput::acquireNextImageIndex(vkr::Semaphore &) {
+        // nothing to wait on, the image was last used by the frame whose fence the caller has already waited on
+        const uint32_t imageIndex = nextImageIndex;
+        nextImageIndex = (nextImageIndex + 1) % static_cast<uint32_t>(images.size());
+        return {vk::Result::eSuccess, imageIndex};
+    }
+
+    PresentResult HeadlessFrameOutput::present(const std::vector<vk::Semaphore> &, uint32_t) {
+        return PresentResult::SUCCESS;
+    }
+
+    void HeadlessFrameOutput::resize(vk::Extent2D) {
+        // fixed size
+    }
+
+    vk::Extent2D HeadlessFrameOutput::getExtent() const {
+        return props.extent;
+    }
+
+    vk::Format HeadlessFrameOutput::getFormat() const {
+        return format;
+    }
+
+    vk::Image HeadlessFrameOutput::getImage(size_t imageIndex) const {
+        return *images[imageIndex]->getImage();
+    }
+
+    bool HeadlessFrameOutput::isPresented() const {
+        return false;
+    }
+}
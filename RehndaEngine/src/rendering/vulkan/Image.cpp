@@ -4,7 +4,6 @@
 
 #include "rendering/vulkan/Image.hpp"
 #include "rendering/vulkan/BufferHelper.hpp"
-#include "rendering/vulkan/SingleTimeCommand.hpp"
 
 namespace Rehnda {
 
@@ -17,49 +16,8 @@ namespace Rehnda {
             imageView(createImageView()){
     }
 
-    void
-    Image::transitionImageLayout(vkr::Queue &queue, vkr::CommandPool &commandPool, vk::ImageLayout oldLayout,
-                                        vk::ImageLayout newLayout) const {
-        SingleTimeCommand singleTimeCommand{device, queue, commandPool};
-        vk::AccessFlags srcAccessMask;
-        vk::AccessFlags dstAccessMask;
-        vk::PipelineStageFlags sourceStage;
-        vk::PipelineStageFlags destStage;
-        if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eTransferDstOptimal) {
-            dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-            sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
-            destStage = vk::PipelineStageFlagBits::eTransfer;
-        } else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
-            srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-            dstAccessMask = vk::AccessFlagBits::eShaderRead;
-            sourceStage = vk::PipelineStageFlagBits::eTransfer;
-            destStage = vk::PipelineStageFlagBits::eFragmentShader;
-        } else if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eDepthStencilAttachmentOptimal) {
-            dstAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
-            sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
-            destStage = vk::PipelineStageFlagBits::eEarlyFragmentTests; // reading of the depth buffer happens in EarlyFragmentTests, writing happens in LateFragmentTests
-        } else {
-            throw std::invalid_argument("Unsupported layout transition!");
-        }
-
-        vk::ImageMemoryBarrier imageMemoryBarrier{
-                .srcAccessMask = srcAccessMask,
-                .dstAccessMask = dstAccessMask,
-                .oldLayout = oldLayout,
-                .newLayout = newLayout,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image = *image,
-                .subresourceRange = {
-                        .aspectMask = imageProps.imageAspectFlags,
-                        .baseMipLevel = 0,
-                        .levelCount = 1,
-                        .baseArrayLayer = 0,
-                        .layerCount = 1
-                }
-        };
-        singleTimeCommand.commandBuffer.pipelineBarrier(sourceStage, destStage, vk::DependencyFlags{}, nullptr, nullptr,
-                                                        imageMemoryBarrier);
+    void Image::recordTransition(vkr::CommandBuffer &commandBuffer, ImageUsage oldUsage, ImageUsage newUsage) const {
+        ResourceUsage::recordImageTransition(commandBuffer, *image, imageProps.imageAspectFlags, oldUsage, newUsage);
     }
 
     vkr::Image Image::createImage() {
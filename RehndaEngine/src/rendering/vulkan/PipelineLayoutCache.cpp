@@ -0,0 +1,177 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/PipelineLayoutCache.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace Rehnda {
+    namespace {
+        void hashCombine(size_t &hash, size_t value) {
+            hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        }
+    }
+
+    DescriptorSetLayoutDesc DescriptorSetLayoutDesc::fromReflection(const ShaderReflection &reflection, uint32_t set,
+                                                                    uint32_t runtimeArrayCapacity) {
+        DescriptorSetLayoutDesc desc;
+        bool anyRuntimeArray = false;
+        for (const auto &binding: reflection.getSetBindings(set)) {
+            if (binding.runtimeArray && runtimeArrayCapacity == 0) {
+                throw std::runtime_error("Set has a runtime descriptor array but no capacity was given for it");
+            }
+            desc.bindings.push_back(vk::DescriptorSetLayoutBinding{
+                    .binding = binding.binding,
+                    .descriptorType = binding.type,
+                    .descriptorCount = binding.runtimeArray ? runtimeArrayCapacity : binding.count,
+                    .stageFlags = binding.stages,
+                    .pImmutableSamplers = nullptr,
+            });
+            // slots past what's been written are left empty, and new ones are written while the set is bound in frames
+            // still in flight
+            desc.bindingFlags.push_back(binding.runtimeArray ? vk::DescriptorBindingFlagBits::ePartiallyBound |
+                                                               vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                                               vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending
+                                                             : vk::DescriptorBindingFlags{});
+            anyRuntimeArray |= binding.runtimeArray;
+        }
+        if (anyRuntimeArray) {
+            desc.flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool;
+        } else {
+            // keeps sets without any flags comparing equal however they were described
+            desc.bindingFlags.clear();
+        }
+        return desc;
+    }
+
+    void DescriptorSetLayoutDesc::validateReflection(const ShaderReflection &reflection, uint32_t set) const {
+        const auto findBinding = [&](uint32_t binding) -> const vk::DescriptorSetLayoutBinding * {
+            const auto it = std::find_if(bindings.begin(), bindings.end(), [&](const vk::DescriptorSetLayoutBinding &existing) {
+                return existing.binding == binding;
+            });
+            return it == bindings.end() ? nullptr : &*it;
+        };
+        // runtime arrays have no count of their own, they're reflected at whatever capacity the layout was built with
+        uint32_t runtimeArrayCapacity = 0;
+        for (const auto &binding: reflection.getSetBindings(set)) {
+            const auto *existing = findBinding(binding.binding);
+            if (binding.runtimeArray && existing) {
+                runtimeArrayCapacity = existing->descriptorCount;
+            }
+            if (!existing) {
+                throw std::runtime_error(fmt::format("Set {} binding {} isn't in the layout it's bound with", set, binding.binding));
+            }
+        }
+
+        const DescriptorSetLayoutDesc reflected = fromReflection(reflection, set, runtimeArrayCapacity);
+        for (const auto &binding: reflected.bindings) {
+            const auto *existing = findBinding(binding.binding);
+            if (existing->descriptorType != binding.descriptorType || existing->descriptorCount != binding.descriptorCount) {
+                throw std::runtime_error(fmt::format("Set {} binding {} is declared as {} descriptors of type {} but the layout has {} of type {}",
+                                                     set, binding.binding, binding.descriptorCount,
+                                                     static_cast<int>(binding.descriptorType), existing->descriptorCount,
+                                                     static_cast<int>(existing->descriptorType)));
+            }
+        }
+    }
+
+    PipelineLayoutCache::PipelineLayoutCache(vkr::Device &device) : device(device) {
+    }
+
+    vk::DescriptorSetLayout PipelineLayoutCache::getSetLayout(const DescriptorSetLayoutDesc &desc) {
+        std::lock_guard lock(mutex);
+        if (const auto it = setLayouts.find(desc); it != setLayouts.end()) {
+            return *it->second;
+        }
+        assert(desc.bindingFlags.empty() || desc.bindingFlags.size() == desc.bindings.size());
+
+        const vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo{
+                .bindingCount = static_cast<uint32_t>(desc.bindingFlags.size()),
+                .pBindingFlags = desc.bindingFlags.data(),
+        };
+        vkr::DescriptorSetLayout layout{device, vk::DescriptorSetLayoutCreateInfo{
+                .pNext = desc.bindingFlags.empty() ? nullptr : &bindingFlagsCreateInfo,
+                .flags = desc.flags,
+                .bindingCount = static_cast<uint32_t>(desc.bindings.size()),
+                .pBindings = desc.bindings.data(),
+        }};
+        const vk::DescriptorSetLayout handle = *layout;
+        setLayouts.emplace(desc, std::move(layout));
+        return handle;
+    }
+
+    DescriptorSetLayoutDesc PipelineLayoutCache::getSetLayoutDesc(vk::DescriptorSetLayout layout) {
+        std::lock_guard lock(mutex);
+        const auto it = std::find_if(setLayouts.begin(), setLayouts.end(), [&](const auto &entry) {
+            return *entry.second == layout;
+        });
+        if (it == setLayouts.end()) {
+            throw std::runtime_error("Descriptor set layout wasn't created by this cache");
+        }
+        return it->first;
+    }
+
+    vk::PipelineLayout PipelineLayoutCache::getPipelineLayout(std::span<const vk::DescriptorSetLayout> layouts,
+                                                              std::span<const vk::PushConstantRange> pushConstantRanges) {
+        std::lock_guard lock(mutex);
+        PipelineLayoutKey key{
+                .setLayouts = {layouts.begin(), layouts.end()},
+                .pushConstantRanges = {pushConstantRanges.begin(), pushConstantRanges.end()},
+        };
+        if (const auto it = pipelineLayouts.find(key); it != pipelineLayouts.end()) {
+            return *it->second;
+        }
+
+        vkr::PipelineLayout layout{device, vk::PipelineLayoutCreateInfo{
+                .setLayoutCount = static_cast<uint32_t>(key.setLayouts.size()),
+                .pSetLayouts = key.setLayouts.data(),
+                .pushConstantRangeCount = static_cast<uint32_t>(key.pushConstantRanges.size()),
+                .pPushConstantRanges = key.pushConstantRanges.data(),
+        }};
+        const vk::PipelineLayout handle = *layout;
+        pipelineLayouts.emplace(std::move(key), std::move(layout));
+        return handle;
+    }
+
+    size_t PipelineLayoutCache::getSetLayoutCount() const {
+        std::lock_guard lock(mutex);
+        return setLayouts.size();
+    }
+
+    size_t PipelineLayoutCache::getPipelineLayoutCount() const {
+        std::lock_guard lock(mutex);
+        return pipelineLayouts.size();
+    }
+
+    size_t PipelineLayoutCache::SetLayoutHash::operator()(const DescriptorSetLayoutDesc &desc) const {
+        size_t hash = static_cast<size_t>(static_cast<VkDescriptorSetLayoutCreateFlags>(desc.flags));
+        for (const auto &binding: desc.bindings) {
+            hashCombine(hash, binding.binding);
+            hashCombine(hash, static_cast<size_t>(binding.descriptorType));
+            hashCombine(hash, binding.descriptorCount);
+            hashCombine(hash, static_cast<size_t>(static_cast<VkShaderStageFlags>(binding.stageFlags)));
+        }
+        for (const auto &flags: desc.bindingFlags) {
+            hashCombine(hash, static_cast<size_t>(static_cast<VkDescriptorBindingFlags>(flags)));
+        }
+        return hash;
+    }
+
+    size_t PipelineLayoutCache::PipelineLayoutHash::operator()(const PipelineLayoutKey &key) const {
+        size_t hash = 0;
+        for (const auto &setLayout: key.setLayouts) {
+            hashCombine(hash, std::hash<vk::DescriptorSetLayout>{}(setLayout));
+        }
+        for (const auto &range: key.pushConstantRanges) {
+            hashCombine(hash, static_cast<size_t>(static_cast<VkShaderStageFlags>(range.stageFlags)));
+            hashCombine(hash, range.offset);
+            hashCombine(hash, range.size);
+        }
+        return hash;
+    }
+}
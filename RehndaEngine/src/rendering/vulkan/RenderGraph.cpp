@@ -0,0 +1,473 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/RenderGraph.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace Rehnda {
+    namespace {
+        vk::ImageUsageFlags imageUsageFlags(ImageUsage usage) {
+            switch (usage) {
+                case ImageUsage::COLOR_ATTACHMENT:
+                    return vk::ImageUsageFlagBits::eColorAttachment;
+                case ImageUsage::DEPTH_ATTACHMENT:
+                case ImageUsage::DEPTH_READ_ONLY:
+                    return vk::ImageUsageFlagBits::eDepthStencilAttachment;
+                case ImageUsage::SAMPLED_FRAGMENT:
+                case ImageUsage::SAMPLED_COMPUTE:
+                    return vk::ImageUsageFlagBits::eSampled;
+                case ImageUsage::STORAGE_COMPUTE:
+                    return vk::ImageUsageFlagBits::eStorage;
+                case ImageUsage::TRANSFER_SRC:
+                    return vk::ImageUsageFlagBits::eTransferSrc;
+                case ImageUsage::TRANSFER_DST:
+                    return vk::ImageUsageFlagBits::eTransferDst;
+                case ImageUsage::UNDEFINED:
+                case ImageUsage::PRESENT:
+                    return {};
+            }
+            return {};
+        }
+
+        bool isAttachmentUsage(ImageUsage usage) {
+            return usage == ImageUsage::COLOR_ATTACHMENT || usage == ImageUsage::DEPTH_ATTACHMENT ||
+                   usage == ImageUsage::DEPTH_READ_ONLY;
+        }
+    }
+
+    void RenderPassBuilder::read(RenderGraphImage image, ImageUsage usage) {
+        imageUses.push_back({.image = image.index, .usage = usage, .reads = true, .writes = false});
+    }
+
+    void RenderPassBuilder::write(RenderGraphImage image, ImageUsage usage) {
+        imageUses.push_back({.image = image.index, .usage = usage, .reads = false, .writes = true});
+    }
+
+    void RenderPassBuilder::readWrite(RenderGraphImage image, ImageUsage usage) {
+        imageUses.push_back({.image = image.index, .usage = usage, .reads = true, .writes = true});
+    }
+
+    void RenderPassBuilder::read(RenderGraphBuffer buffer, BufferUsage usage) {
+        bufferUses.push_back({.buffer = buffer.index, .usage = usage, .writes = false});
+    }
+
+    void RenderPassBuilder::write(RenderGraphBuffer buffer, BufferUsage usage) {
+        bufferUses.push_back({.buffer = buffer.index, .usage = usage, .writes = true});
+    }
+
+    void RenderPassBuilder::hasSideEffects() {
+        sideEffects = true;
+    }
+
+    RenderGraph::RenderGraph(vkr::Device &device, vkr::PhysicalDevice &physicalDevice) :
+            attachmentAllocator(device, physicalDevice) {
+    }
+
+    RenderGraphImage RenderGraph::importImage(std::string name, vk::ImageAspectFlags aspect) {
+        images.push_back(ImageResource{
+                .name = std::move(name),
+                .aspect = aspect,
+                .image = nullptr,
+                .createDescription = std::nullopt,
+                .attachment = std::nullopt,
+                .memoryBlock = std::nullopt,
+                .finalUsage = std::nullopt,
+                .state = {},
+        });
+        return {static_cast<uint32_t>(images.size() - 1)};
+    }
+
+    RenderGraphImage RenderGraph::createImage(std::string name, const AttachmentDescription &description) {
+        images.push_back(ImageResource{
+                .name = std::move(name),
+                .aspect = description.aspect,
+                .image = nullptr,
+                .createDescription = description,
+                .attachment = std::nullopt,
+                .memoryBlock = std::nullopt,
+                .finalUsage = std::nullopt,
+                .state = {},
+        });
+        return {static_cast<uint32_t>(images.size() - 1)};
+    }
+
+    void RenderGraph::resizeImage(RenderGraphImage image, vk::Extent2D extent) {
+        ImageResource &resource = images[image.index];
+        if (!resource.createDescription) {
+            throw std::runtime_error("Render graph image " + resource.name + " can't be resized, it wasn't created by the graph");
+        }
+        resource.createDescription->extent = extent;
+        compiled = false;
+    }
+
+    RenderGraphBuffer RenderGraph::importBuffer(std::string name) {
+        buffers.push_back(BufferResource{
+                .name = std::move(name),
+                .buffer = nullptr,
+                .finalUsage = std::nullopt,
+                .state = {},
+        });
+        return {static_cast<uint32_t>(buffers.size() - 1)};
+    }
+
+    void RenderGraph::addPass(std::string name, const std::function<void(RenderPassBuilder &)> &setup, PassCallback execute) {
+        Pass pass{
+                .name = std::move(name),
+                .uses = {},
+                .execute = std::move(execute),
+                .active = false,
+        };
+        setup(pass.uses);
+        // a pass using something twice would need two barriers on the same resource in one batch
+        for (size_t i = 0; i < pass.uses.imageUses.size(); i++) {
+            for (size_t j = i + 1; j < pass.uses.imageUses.size(); j++) {
+                if (pass.uses.imageUses[i].image == pass.uses.imageUses[j].image) {
+                    throw std::runtime_error("Render graph pass " + pass.name + " uses an image more than once");
+                }
+            }
+        }
+        passes.push_back(std::move(pass));
+        compiled = false;
+    }
+
+    void RenderGraph::markOutput(RenderGraphImage image, ImageUsage finalUsage) {
+        images[image.index].finalUsage = finalUsage;
+        compiled = false;
+    }
+
+    void RenderGraph::markOutput(RenderGraphBuffer buffer, BufferUsage finalUsage) {
+        buffers[buffer.index].finalUsage = finalUsage;
+        compiled = false;
+    }
+
+    void RenderGraph::compile() {
+        cullPasses();
+        allocateImages();
+        compiled = true;
+    }
+
+    void RenderGraph::cullPasses() {
+        std::vector<bool> imageNeeded(images.size(), false);
+        std::vector<bool> bufferNeeded(buffers.size(), false);
+        for (size_t i = 0; i < images.size(); i++) {
+            imageNeeded[i] = images[i].finalUsage.has_value();
+        }
+        for (size_t i = 0; i < buffers.size(); i++) {
+            bufferNeeded[i] = buffers[i].finalUsage.has_value();
+        }
+
+        // walking backwards, a pass is needed if it writes something a later needed pass (or the output) reads
+        for (auto pass = passes.rbegin(); pass != passes.rend(); ++pass) {
+            pass->active = pass->uses.sideEffects ||
+                           std::any_of(pass->uses.imageUses.begin(), pass->uses.imageUses.end(), [&](const auto &use) {
+                               return use.writes && imageNeeded[use.image];
+                           }) ||
+                           std::any_of(pass->uses.bufferUses.begin(), pass->uses.bufferUses.end(), [&](const auto &use) {
+                               return use.writes && bufferNeeded[use.buffer];
+                           });
+            if (!pass->active) {
+                SPDLOG_INFO("Render graph culled pass {}, nothing reads what it writes", pass->name);
+                continue;
+            }
+            for (const auto &use: pass->uses.imageUses) {
+                if (use.reads) {
+                    imageNeeded[use.image] = true;
+                }
+            }
+            for (const auto &use: pass->uses.bufferUses) {
+                if (!use.writes) {
+                    bufferNeeded[use.buffer] = true;
+                }
+            }
+        }
+    }
+
+    void RenderGraph::allocateImages() {
+        attachmentAllocator.clear();
+        for (size_t imageIndex = 0; imageIndex < images.size(); imageIndex++) {
+            ImageResource &resource = images[imageIndex];
+            resource.attachment.reset();
+            resource.memoryBlock.reset();
+            if (!resource.createDescription) {
+                continue;
+            }
+
+            // lifetime is the span of live passes touching it, which is what decides what it can alias with
+            AttachmentDescription description = *resource.createDescription;
+            std::optional<uint32_t> firstPass;
+            uint32_t lastPass = 0;
+            bool onlyAttachment = !resource.finalUsage.has_value();
+            for (uint32_t passIndex = 0; passIndex < passes.size(); passIndex++) {
+                const Pass &pass = passes[passIndex];
+                if (!pass.active) {
+                    continue;
+                }
+                for (const auto &use: pass.uses.imageUses) {
+                    if (use.image != imageIndex) {
+                        continue;
+                    }
+                    firstPass = firstPass.value_or(passIndex);
+                    lastPass = passIndex;
+                    description.usage |= imageUsageFlags(use.usage);
+                    onlyAttachment = onlyAttachment && isAttachmentUsage(use.usage);
+                }
+            }
+            if (!firstPass) {
+                resource.image = nullptr;
+                continue;
+            }
+            description.firstPass = *firstPass;
+            // outputs are read after the last pass, nothing may reuse their memory within the frame
+            description.lastPass = resource.finalUsage ? static_cast<uint32_t>(passes.size()) : lastPass;
+            // anything sampled, copied or output has to really exist, whatever the description asked for
+            description.transient = description.transient && onlyAttachment;
+            resource.attachment = attachmentAllocator.add(description);
+        }
+        attachmentAllocator.allocate();
+
+        std::vector<uint32_t> blockImageCounts(attachmentAllocator.getMemoryBlockCount(), 0);
+        for (ImageResource &resource: images) {
+            if (resource.attachment) {
+                resource.image = *attachmentAllocator.getImage(*resource.attachment);
+                resource.memoryBlock = attachmentAllocator.getMemoryBlock(*resource.attachment);
+                resource.state = {};
+                if (resource.memoryBlock) {
+                    blockImageCounts[*resource.memoryBlock]++;
+                }
+            }
+        }
+        memoryOccupants.assign(attachmentAllocator.getMemoryBlockCount(), std::nullopt);
+
+        // an image sharing memory has lost its contents by its first use each frame, reading them would be garbage
+        std::vector<bool> used(images.size(), false);
+        for (const Pass &pass: passes) {
+            if (!pass.active) {
+                continue;
+            }
+            for (const auto &use: pass.uses.imageUses) {
+                const ImageResource &resource = images[use.image];
+                if (!used[use.image] && use.reads && resource.memoryBlock && blockImageCounts[*resource.memoryBlock] > 1) {
+                    throw std::runtime_error("Render graph image " + resource.name + " shares memory, so its first pass " +
+                                             pass.name + " must write it without reading");
+                }
+                used[use.image] = true;
+            }
+        }
+    }
+
+    void RenderGraph::takeOverMemory(uint32_t image) {
+        ImageResource &resource = images[image];
+        std::optional<uint32_t> &occupant = memoryOccupants[*resource.memoryBlock];
+        if (occupant == image) {
+            return;
+        }
+        // the previous occupant's reads and writes both have to finish before anything overwrites the memory, and its
+        // writes have to be made available first. Whatever layout this image was left in is meaningless now
+        const TrackedState previous = occupant ? images[*occupant].state : TrackedState{};
+        resource.state = {
+                .writeStages = previous.writeStages | previous.readStages,
+                .writeAccess = previous.writeAccess,
+                .readStages = {},
+                .readAccess = {},
+                .layout = vk::ImageLayout::eUndefined,
+        };
+        occupant = image;
+    }
+
+    void RenderGraph::setImportedImage(RenderGraphImage image, vk::Image vkImage, ResourceAccess previousAccess) {
+        ImageResource &resource = images[image.index];
+        resource.image = vkImage;
+        resource.state = {
+                .writeStages = previousAccess.stages,
+                .writeAccess = ResourceUsage::writeAccess(previousAccess.access),
+                .readStages = {},
+                .readAccess = {},
+                .layout = previousAccess.layout,
+        };
+    }
+
+    void RenderGraph::setImportedBuffer(RenderGraphBuffer buffer, vk::Buffer vkBuffer) {
+        BufferResource &resource = buffers[buffer.index];
+        resource.buffer = vkBuffer;
+        resource.state = {};
+    }
+
+    void RenderGraph::addImageBarrier(Barriers &barriers, ImageResource &resource, ImageUsage usage, bool reads, bool writes) {
+        const ResourceAccess access = ResourceUsage::getAccess(usage);
+        TrackedState &state = resource.state;
+        const bool layoutChange = access.layout != state.layout;
+
+        vk::PipelineStageFlags srcStages;
+        bool needed;
+        if (writes) {
+            // write after write and write after read both have to wait
+            srcStages = state.writeStages | state.readStages;
+            needed = layoutChange || srcStages;
+        } else {
+            // reads only wait on the last write, and not at all if an earlier barrier already covered this stage
+            const bool alreadyVisible = !(access.stages & ~state.readStages) && !(access.access & ~state.readAccess);
+            srcStages = state.writeStages | (layoutChange ? state.readStages : vk::PipelineStageFlags{});
+            needed = layoutChange || (state.writeStages && !alreadyVisible);
+        }
+
+        if (needed) {
+            barriers.srcStages |= srcStages ? srcStages : vk::PipelineStageFlags{vk::PipelineStageFlagBits::eTopOfPipe};
+            barriers.dstStages |= access.stages;
+            barriers.imageBarriers.push_back(vk::ImageMemoryBarrier{
+                    .srcAccessMask = state.writeAccess,
+                    .dstAccessMask = access.access,
+                    // writing without reading throws the contents away, which is what lets undefined be the old layout
+                    .oldLayout = writes && !reads ? vk::ImageLayout::eUndefined : state.layout,
+                    .newLayout = access.layout,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .image = resource.image,
+                    .subresourceRange = {
+                            .aspectMask = resource.aspect,
+                            .baseMipLevel = 0,
+                            .levelCount = VK_REMAINING_MIP_LEVELS,
+                            .baseArrayLayer = 0,
+                            .layerCount = VK_REMAINING_ARRAY_LAYERS,
+                    },
+            });
+        }
+
+        if (writes) {
+            state.writeStages = access.stages;
+            state.writeAccess = ResourceUsage::writeAccess(access.access);
+            state.readStages = {};
+            state.readAccess = {};
+        } else if (layoutChange) {
+            // a layout transition is itself a write, later readers in other stages have to wait for it. Its barrier has
+            // already made earlier writes available so there's no access left to flush
+            state.writeStages = access.stages;
+            state.writeAccess = {};
+            state.readStages = access.stages;
+            state.readAccess = access.access;
+        } else {
+            state.readStages |= access.stages;
+            state.readAccess |= access.access;
+        }
+        state.layout = access.layout;
+    }
+
+    void RenderGraph::addBufferBarrier(Barriers &barriers, BufferResource &resource, BufferUsage usage, bool writes) {
+        const ResourceAccess access = ResourceUsage::getAccess(usage);
+        TrackedState &state = resource.state;
+
+        vk::PipelineStageFlags srcStages;
+        bool needed;
+        if (writes) {
+            srcStages = state.writeStages | state.readStages;
+            needed = static_cast<bool>(srcStages);
+        } else {
+            const bool alreadyVisible = !(access.stages & ~state.readStages) && !(access.access & ~state.readAccess);
+            srcStages = state.writeStages;
+            needed = state.writeStages && !alreadyVisible;
+        }
+
+        if (needed) {
+            barriers.srcStages |= srcStages;
+            barriers.dstStages |= access.stages;
+            barriers.bufferBarriers.push_back(vk::BufferMemoryBarrier{
+                    .srcAccessMask = state.writeAccess,
+                    .dstAccessMask = access.access,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .buffer = resource.buffer,
+                    .offset = 0,
+                    .size = VK_WHOLE_SIZE,
+            });
+        }
+
+        if (writes) {
+            state.writeStages = access.stages;
+            state.writeAccess = ResourceUsage::writeAccess(access.access);
+            state.readStages = {};
+            state.readAccess = {};
+        } else {
+            state.readStages |= access.stages;
+            state.readAccess |= access.access;
+        }
+    }
+
+    void RenderGraph::recordBarriers(vkr::CommandBuffer &commandBuffer, Barriers &barriers) {
+        if (barriers.imageBarriers.empty() && barriers.bufferBarriers.empty()) {
+            return;
+        }
+        // one barrier call per pass whatever it touches
+        commandBuffer.pipelineBarrier(barriers.srcStages, barriers.dstStages, vk::DependencyFlags{}, nullptr,
+                                      barriers.bufferBarriers, barriers.imageBarriers);
+    }
+
+    void RenderGraph::execute(vkr::CommandBuffer &commandBuffer) {
+        if (!compiled) {
+            throw std::runtime_error("Render graph must be compiled before it's executed");
+        }
+        for (Pass &pass: passes) {
+            if (!pass.active) {
+                continue;
+            }
+            Barriers barriers{};
+            for (const auto &use: pass.uses.imageUses) {
+                ImageResource &resource = images[use.image];
+                if (!resource.image) {
+                    throw std::runtime_error("Render graph image " + resource.name + " was never set");
+                }
+                if (resource.memoryBlock) {
+                    takeOverMemory(use.image);
+                }
+                addImageBarrier(barriers, resource, use.usage, use.reads, use.writes);
+            }
+            for (const auto &use: pass.uses.bufferUses) {
+                BufferResource &resource = buffers[use.buffer];
+                if (!resource.buffer) {
+                    throw std::runtime_error("Render graph buffer " + resource.name + " was never set");
+                }
+                addBufferBarrier(barriers, resource, use.usage, use.writes);
+            }
+            recordBarriers(commandBuffer, barriers);
+            pass.execute(commandBuffer);
+        }
+
+        // outputs are left how whatever consumes them after the frame expects
+        Barriers finalBarriers{};
+        for (ImageResource &resource: images) {
+            if (resource.finalUsage && resource.image) {
+                addImageBarrier(finalBarriers, resource, *resource.finalUsage, true, false);
+            }
+        }
+        for (BufferResource &resource: buffers) {
+            if (resource.finalUsage && resource.buffer) {
+                addBufferBarrier(finalBarriers, resource, *resource.finalUsage, false);
+            }
+        }
+        recordBarriers(commandBuffer, finalBarriers);
+    }
+
+    vk::Image RenderGraph::getImage(RenderGraphImage image) const {
+        return images[image.index].image;
+    }
+
+    const vkr::ImageView &RenderGraph::getImageView(RenderGraphImage image) const {
+        const ImageResource &resource = images[image.index];
+        if (!resource.attachment) {
+            throw std::runtime_error("Render graph image " + resource.name + " has no view, it wasn't created by the graph");
+        }
+        return attachmentAllocator.getImageView(*resource.attachment);
+    }
+
+    vk::Buffer RenderGraph::getBuffer(RenderGraphBuffer buffer) const {
+        return buffers[buffer.index].buffer;
+    }
+
+    bool RenderGraph::isPassActive(const std::string &name) const {
+        return std::any_of(passes.begin(), passes.end(), [&](const Pass &pass) {
+            return pass.active && pass.name == name;
+        });
+    }
+}
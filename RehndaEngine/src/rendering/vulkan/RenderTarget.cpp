@@ -0,0 +1,89 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/RenderTarget.hpp"
+
+namespace Rehnda {
+    RenderTarget::RenderTarget(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, const RenderTargetProps &props) :
+            device(device),
+            physicalDevice(physicalDevice),
+            props(props),
+            upscaleFilter(physicalDevice.getFormatProperties(props.colorFormat).optimalTilingFeatures &
+                          vk::FormatFeatureFlagBits::eSampledImageFilterLinear ? vk::Filter::eLinear : vk::Filter::eNearest),
+            attachmentAllocator(device, physicalDevice) {
+        createColorAttachment();
+    }
+
+    void RenderTarget::createColorAttachment() {
+        // the framebuffer references the view, so it has to go first
+        framebuffer.reset();
+        attachmentAllocator.clear();
+        colorAttachment = attachmentAllocator.add({
+                .format = props.colorFormat,
+                .extent = props.extent,
+                .usage = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+                .aspect = vk::ImageAspectFlagBits::eColor,
+        });
+        attachmentAllocator.allocate();
+    }
+
+    void RenderTarget::createFramebuffer(const vkr::RenderPass &renderPass, const vkr::ImageView &depthView) {
+        framebuffer.reset();
+        std::array<vk::ImageView, 2> attachments{
+                *attachmentAllocator.getImageView(colorAttachment),
+                *depthView,
+        };
+        vk::FramebufferCreateInfo framebufferCreateInfo{
+                // need the renderpass for the framebuffer to be created to be compatible with it
+                .renderPass = *renderPass,
+                .attachmentCount = attachments.size(),
+                .pAttachments = attachments.data(),
+                .width = props.extent.width,
+                .height = props.extent.height,
+                .layers = 1,
+        };
+        framebuffer = std::make_unique<vkr::Framebuffer>(device, framebufferCreateInfo);
+    }
+
+    void RenderTarget::resize(vk::Extent2D extent) {
+        props.extent = extent;
+        createColorAttachment();
+    }
+
+    void RenderTarget::recordUpscale(vkr::CommandBuffer &commandBuffer, vk::Extent2D renderExtent, vk::Image swapchainImage,
+                                     vk::Extent2D swapchainExtent) const {
+        const vk::ImageSubresourceLayers colorLayers{
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+        };
+        const vk::ImageBlit blit{
+                .srcSubresource = colorLayers,
+                .srcOffsets = std::array<vk::Offset3D, 2>{
+                        vk::Offset3D{0, 0, 0},
+                        vk::Offset3D{static_cast<int32_t>(renderExtent.width), static_cast<int32_t>(renderExtent.height), 1},
+                },
+                .dstSubresource = colorLayers,
+                .dstOffsets = std::array<vk::Offset3D, 2>{
+                        vk::Offset3D{0, 0, 0},
+                        vk::Offset3D{static_cast<int32_t>(swapchainExtent.width), static_cast<int32_t>(swapchainExtent.height), 1},
+                },
+        };
+        commandBuffer.blitImage(*attachmentAllocator.getImage(colorAttachment), vk::ImageLayout::eTransferSrcOptimal, swapchainImage,
+                                vk::ImageLayout::eTransferDstOptimal, blit, upscaleFilter);
+    }
+
+    vkr::Framebuffer &RenderTarget::getFramebuffer() {
+        return *framebuffer;
+    }
+
+    const vkr::Image &RenderTarget::getColorImage() const {
+        return attachmentAllocator.getImage(colorAttachment);
+    }
+
+    vk::Extent2D RenderTarget::getExtent() const {
+        return props.extent;
+    }
+}
@@ -0,0 +1,101 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/ResourceUsage.hpp"
+
+namespace Rehnda::ResourceUsage {
+    using Stage = vk::PipelineStageFlagBits;
+    using Access = vk::AccessFlagBits;
+    using Layout = vk::ImageLayout;
+
+    ResourceAccess getAccess(ImageUsage usage) {
+        switch (usage) {
+            case ImageUsage::UNDEFINED:
+                return {Stage::eTopOfPipe, Access::eNone, Layout::eUndefined};
+            case ImageUsage::COLOR_ATTACHMENT:
+                return {Stage::eColorAttachmentOutput, Access::eColorAttachmentRead | Access::eColorAttachmentWrite,
+                        Layout::eColorAttachmentOptimal};
+            case ImageUsage::DEPTH_ATTACHMENT:
+                // reading of the depth buffer happens in EarlyFragmentTests, writing happens in LateFragmentTests
+                return {Stage::eEarlyFragmentTests | Stage::eLateFragmentTests,
+                        Access::eDepthStencilAttachmentRead | Access::eDepthStencilAttachmentWrite,
+                        Layout::eDepthStencilAttachmentOptimal};
+            case ImageUsage::DEPTH_READ_ONLY:
+                return {Stage::eEarlyFragmentTests | Stage::eLateFragmentTests, Access::eDepthStencilAttachmentRead,
+                        Layout::eDepthStencilReadOnlyOptimal};
+            case ImageUsage::SAMPLED_FRAGMENT:
+                return {Stage::eFragmentShader, Access::eShaderRead, Layout::eShaderReadOnlyOptimal};
+            case ImageUsage::SAMPLED_COMPUTE:
+                return {Stage::eComputeShader, Access::eShaderRead, Layout::eShaderReadOnlyOptimal};
+            case ImageUsage::STORAGE_COMPUTE:
+                return {Stage::eComputeShader, Access::eShaderRead | Access::eShaderWrite, Layout::eGeneral};
+            case ImageUsage::TRANSFER_SRC:
+                return {Stage::eTransfer, Access::eTransferRead, Layout::eTransferSrcOptimal};
+            case ImageUsage::TRANSFER_DST:
+                return {Stage::eTransfer, Access::eTransferWrite, Layout::eTransferDstOptimal};
+            case ImageUsage::PRESENT:
+                // presentation is synchronised by semaphore, the barrier only needs to get the layout right
+                return {Stage::eBottomOfPipe, Access::eNone, Layout::ePresentSrcKHR};
+        }
+        throw std::invalid_argument("Unknown image usage");
+    }
+
+    ResourceAccess getAccess(BufferUsage usage) {
+        switch (usage) {
+            case BufferUsage::VERTEX:
+                return {Stage::eVertexInput, Access::eVertexAttributeRead};
+            case BufferUsage::INDEX:
+                return {Stage::eVertexInput, Access::eIndexRead};
+            case BufferUsage::UNIFORM:
+                return {Stage::eVertexShader | Stage::eFragmentShader | Stage::eComputeShader, Access::eUniformRead};
+            case BufferUsage::STORAGE_READ_VERTEX:
+                return {Stage::eVertexShader, Access::eShaderRead};
+            case BufferUsage::STORAGE_READ_FRAGMENT:
+                return {Stage::eFragmentShader, Access::eShaderRead};
+            case BufferUsage::STORAGE_READ_COMPUTE:
+                return {Stage::eComputeShader, Access::eShaderRead};
+            case BufferUsage::STORAGE_WRITE_COMPUTE:
+                return {Stage::eComputeShader, Access::eShaderWrite};
+            case BufferUsage::TRANSFER_SRC:
+                return {Stage::eTransfer, Access::eTransferRead};
+            case BufferUsage::TRANSFER_DST:
+                return {Stage::eTransfer, Access::eTransferWrite};
+            case BufferUsage::HOST_READ:
+                return {Stage::eHost, Access::eHostRead};
+        }
+        throw std::invalid_argument("Unknown buffer usage");
+    }
+
+    vk::AccessFlags writeAccess(vk::AccessFlags access) {
+        return access & (Access::eShaderWrite | Access::eColorAttachmentWrite | Access::eDepthStencilAttachmentWrite |
+                         Access::eTransferWrite | Access::eHostWrite | Access::eMemoryWrite);
+    }
+
+    vk::ImageMemoryBarrier imageBarrier(vk::Image image, vk::ImageAspectFlags aspect, ImageUsage oldUsage, ImageUsage newUsage) {
+        const ResourceAccess oldAccess = getAccess(oldUsage);
+        const ResourceAccess newAccess = getAccess(newUsage);
+        return vk::ImageMemoryBarrier{
+                .srcAccessMask = writeAccess(oldAccess.access),
+                .dstAccessMask = newAccess.access,
+                .oldLayout = oldAccess.layout,
+                .newLayout = newAccess.layout,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = image,
+                .subresourceRange = {
+                        .aspectMask = aspect,
+                        .baseMipLevel = 0,
+                        .levelCount = VK_REMAINING_MIP_LEVELS,
+                        .baseArrayLayer = 0,
+                        .layerCount = VK_REMAINING_ARRAY_LAYERS,
+                },
+        };
+    }
+
+    void recordImageTransition(vkr::CommandBuffer &commandBuffer, vk::Image image, vk::ImageAspectFlags aspect,
+                               ImageUsage oldUsage, ImageUsage newUsage) {
+        commandBuffer.pipelineBarrier(getAccess(oldUsage).stages, getAccess(newUsage).stages, vk::DependencyFlags{},
+                                      nullptr, nullptr, imageBarrier(image, aspect, oldUsage, newUsage));
+    }
+}
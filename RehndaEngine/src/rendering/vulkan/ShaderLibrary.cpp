@@ -0,0 +1,267 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/ShaderLibrary.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <fmt/format.h>
+#include <shaderc/shaderc.hpp>
+#include <spdlog/spdlog.h>
+
+#include "core/MappedFile.hpp"
+
+namespace Rehnda {
+    namespace {
+        shaderc_shader_kind shaderKind(std::string_view name) {
+            const std::string extension = std::filesystem::path(name).extension().string();
+            if (extension == ".vert") {
+                return shaderc_vertex_shader;
+            }
+            if (extension == ".frag") {
+                return shaderc_fragment_shader;
+            }
+            if (extension == ".comp") {
+                return shaderc_compute_shader;
+            }
+            throw std::runtime_error(fmt::format("Can't tell the shader stage of {} from its extension", name));
+        }
+
+        std::string readText(const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Failed to open " + path.string());
+            }
+            return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        }
+
+        // 64 bit FNV-1a
+        uint64_t hashBytes(std::string_view bytes, uint64_t hash = 0xcbf29ce484222325ull) {
+            for (const char c: bytes) {
+                hash ^= static_cast<uint8_t>(c);
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        // resolves #include against the source directory, recording what was pulled in
+        class Includer : public shaderc::CompileOptions::IncluderInterface {
+        public:
+            Includer(std::filesystem::path directory, std::set<std::string> &included) :
+                    directory(std::move(directory)),
+                    included(included) {
+            }
+
+            shaderc_include_result *GetInclude(const char *requestedSource, shaderc_include_type, const char *, size_t) override {
+                auto include = std::make_unique<Include>();
+                const std::filesystem::path path = directory / requestedSource;
+                try {
+                    include->content = readText(path);
+                    include->name = requestedSource;
+                    included.insert(requestedSource);
+                } catch (const std::runtime_error &error) {
+                    // an empty name tells shaderc the include failed, with the content as the error
+                    include->content = error.what();
+                }
+                include->result = shaderc_include_result{
+                        .source_name = include->name.data(),
+                        .source_name_length = include->name.size(),
+                        .content = include->content.data(),
+                        .content_length = include->content.size(),
+                        .user_data = include.get(),
+                };
+                return &include.release()->result;
+            }
+
+            void ReleaseInclude(shaderc_include_result *data) override {
+                delete static_cast<Include *>(data->user_data);
+            }
+
+        private:
+            struct Include {
+                std::string name;
+                std::string content;
+                shaderc_include_result result;
+            };
+
+            std::filesystem::path directory;
+            std::set<std::string> &included;
+        };
+    }
+
+    ShaderLibrary::Watch::Watch(ShaderLibrary *library, uint64_t id) : library(library), id(id) {
+    }
+
+    ShaderLibrary::Watch::~Watch() {
+        if (library) {
+            library->unwatch(id);
+        }
+    }
+
+    ShaderLibrary::Watch::Watch(Watch &&other) noexcept:
+            library(std::exchange(other.library, nullptr)),
+            id(other.id) {
+    }
+
+    ShaderLibrary::Watch &ShaderLibrary::Watch::operator=(Watch &&other) noexcept {
+        if (this != &other) {
+            if (library) {
+                library->unwatch(id);
+            }
+            library = std::exchange(other.library, nullptr);
+            id = other.id;
+        }
+        return *this;
+    }
+
+    ShaderLibrary::ShaderLibrary(const AssetLoader &assetLoader, ShaderLibraryProps props) :
+            assetLoader(assetLoader),
+            props(std::move(props)) {
+        if (this->props.hotReload && std::filesystem::is_directory(this->props.sourceDirectory)) {
+            fileWatcher = std::make_unique<FileWatcher>(this->props.sourceDirectory,
+                                                        [this](const std::filesystem::path &path) { onFileChanged(path); });
+            SPDLOG_INFO("Watching {} for shader changes", this->props.sourceDirectory.string());
+        }
+    }
+
+    std::vector<uint32_t> ShaderLibrary::load(std::string_view name, std::span<const ShaderDefine> defines) {
+        const std::filesystem::path sourcePath = props.sourceDirectory / name;
+        if (!std::filesystem::exists(sourcePath)) {
+            return loadPrecompiled(name, defines);
+        }
+
+        const std::string nameString(name);
+        const shaderc_shader_kind kind = shaderKind(name);
+        std::set<std::string> included;
+        shaderc::CompileOptions options;
+        options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+        options.SetIncluder(std::make_unique<Includer>(props.sourceDirectory, included));
+        for (const auto &define: defines) {
+            options.AddMacroDefinition(define.name, define.value);
+        }
+
+        // what's hashed is exactly what gets compiled, with includes pasted in and defines applied
+        const shaderc::Compiler compiler;
+        const shaderc::PreprocessedSourceCompilationResult preprocessed =
+                compiler.PreprocessGlsl(readText(sourcePath), kind, nameString.c_str(), options);
+        if (preprocessed.GetCompilationStatus() != shaderc_compilation_status_success) {
+            throw std::runtime_error(fmt::format("Failed to preprocess {}:\n{}", name, preprocessed.GetErrorMessage()));
+        }
+        const std::string_view preprocessedText(preprocessed.cbegin(), preprocessed.cend() - preprocessed.cbegin());
+        {
+            std::lock_guard lock(dependenciesMutex);
+            dependencies[nameString].insert(included.begin(), included.end());
+        }
+
+        const std::string keyPrefix = fmt::format("{}:{}:", CACHE_VERSION, static_cast<int>(kind));
+        const uint64_t key = hashBytes(preprocessedText, hashBytes(keyPrefix));
+        const std::filesystem::path cachePath = props.cacheDirectory / fmt::format("{:016x}.spv", key);
+        if (std::filesystem::exists(cachePath)) {
+            const MappedFile cached(cachePath);
+            const std::span<const std::byte> bytes = cached.bytes();
+            std::vector<uint32_t> words(bytes.size() / sizeof(uint32_t));
+            std::memcpy(words.data(), bytes.data(), words.size() * sizeof(uint32_t));
+            // a truncated or corrupted file is compiled again and overwritten rather than handed to the driver
+            if (bytes.size() % sizeof(uint32_t) == 0 && !words.empty() && words.front() == SPIRV_MAGIC) {
+                return words;
+            }
+            SPDLOG_WARN("Cached SPIR-V for {} at {} isn't valid, recompiling", name, cachePath.string());
+        }
+
+        const shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(preprocessedText.data(), preprocessedText.size(),
+                                                                              kind, nameString.c_str(), options);
+        if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
+            throw std::runtime_error(fmt::format("Failed to compile {}:\n{}", name, result.GetErrorMessage()));
+        }
+        std::vector<uint32_t> words(result.cbegin(), result.cend());
+        SPDLOG_INFO("Compiled {} ({} bytes of SPIR-V)", name, words.size() * sizeof(uint32_t));
+
+        // written to a temporary and renamed into place, so a concurrent load never maps a half written file
+        std::error_code error;
+        std::filesystem::create_directories(props.cacheDirectory, error);
+        const std::filesystem::path temporaryPath = props.cacheDirectory / fmt::format(
+                "{:016x}.{}.tmp", key, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        bool written = false;
+        {
+            std::ofstream file(temporaryPath, std::ios::binary);
+            file.write(reinterpret_cast<const char *>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+            file.close();
+            written = static_cast<bool>(file);
+        }
+        if (!written) {
+            // e.g. a full disk, a partial file must never be renamed into place where the next load would trust it
+            SPDLOG_WARN("Failed to write the SPIR-V cache for {} to {}", name, temporaryPath.string());
+            std::filesystem::remove(temporaryPath, error);
+            return words;
+        }
+        std::filesystem::rename(temporaryPath, cachePath, error);
+        if (error) {
+            SPDLOG_WARN("Failed to cache SPIR-V for {}: {}", name, error.message());
+        }
+        return words;
+    }
+
+    std::vector<uint32_t> ShaderLibrary::loadPrecompiled(std::string_view name, std::span<const ShaderDefine> defines) const {
+        if (!defines.empty()) {
+            throw std::runtime_error(fmt::format("No source for {}, defines can only be applied when compiling at runtime", name));
+        }
+        const AssetBlob blob = assetLoader.load(fmt::format("shaders/{}.spv", name));
+        const std::span<const std::byte> bytes = blob.bytes();
+        std::vector<uint32_t> words(bytes.size() / sizeof(uint32_t));
+        std::memcpy(words.data(), bytes.data(), words.size() * sizeof(uint32_t));
+        return words;
+    }
+
+    ShaderLibrary::Watch ShaderLibrary::watch(std::vector<std::string> names, std::function<void()> onChanged) {
+        if (!fileWatcher) {
+            return {};
+        }
+        std::lock_guard lock(listenersMutex);
+        const uint64_t id = nextListenerId++;
+        listeners.emplace(id, Listener{.names = std::move(names), .onChanged = std::move(onChanged)});
+        return {this, id};
+    }
+
+    void ShaderLibrary::unwatch(uint64_t id) {
+        std::lock_guard lock(listenersMutex);
+        listeners.erase(id);
+    }
+
+    void ShaderLibrary::onFileChanged(const std::filesystem::path &path) {
+        const std::string changed = path.filename().string();
+        // every source that is the changed file or includes it
+        std::set<std::string> affected{changed};
+        {
+            std::lock_guard lock(dependenciesMutex);
+            for (const auto &[source, included]: dependencies) {
+                if (included.contains(changed)) {
+                    affected.insert(source);
+                }
+            }
+        }
+
+        std::lock_guard lock(listenersMutex);
+        for (const auto &[id, listener]: listeners) {
+            const bool isAffected = std::any_of(listener.names.begin(), listener.names.end(),
+                                                [&](const std::string &name) { return affected.contains(name); });
+            if (!isAffected) {
+                continue;
+            }
+            SPDLOG_INFO("{} changed, reloading", changed);
+            // a shader that doesn't compile leaves the old pipeline in place, fix it and save again
+            try {
+                listener.onChanged();
+            } catch (const std::exception &exception) {
+                SPDLOG_ERROR("Shader reload failed: {}", exception.what());
+            }
+        }
+    }
+}
@@ -0,0 +1,71 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/ShaderPermutation.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+namespace Rehnda {
+    SpecializationConstant SpecializationConstant::fromFloat(uint32_t id, float value) {
+        return {.id = id, .value = std::bit_cast<uint32_t>(value)};
+    }
+
+    SpecializationConstant SpecializationConstant::fromBool(uint32_t id, bool value) {
+        return {.id = id, .value = value ? VK_TRUE : VK_FALSE};
+    }
+
+    ShaderPermutation::ShaderPermutation(std::span<const SpecializationConstant> constants) {
+        for (const auto &constant: constants) {
+            set(constant);
+        }
+    }
+
+    ShaderPermutation &ShaderPermutation::set(SpecializationConstant constant) {
+        const auto it = std::lower_bound(constants.begin(), constants.end(), constant.id,
+                                         [](const SpecializationConstant &existing, uint32_t id) { return existing.id < id; });
+        if (it != constants.end() && it->id == constant.id) {
+            it->value = constant.value;
+        } else {
+            constants.insert(it, constant);
+        }
+        return *this;
+    }
+
+    std::span<const SpecializationConstant> ShaderPermutation::getConstants() const {
+        return constants;
+    }
+
+    size_t ShaderPermutation::Hash::operator()(const ShaderPermutation &permutation) const {
+        size_t hash = permutation.constants.size();
+        for (const auto &constant: permutation.constants) {
+            const uint64_t packed = (static_cast<uint64_t>(constant.id) << 32) | constant.value;
+            hash ^= std::hash<uint64_t>{}(packed) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+
+    SpecializationData::SpecializationData(std::span<const SpecializationConstant> constants) {
+        // every constant is 4 bytes, packed in the order given
+        for (const auto &constant: constants) {
+            mapEntries.push_back(vk::SpecializationMapEntry{
+                    .constantID = constant.id,
+                    .offset = static_cast<uint32_t>(values.size() * sizeof(uint32_t)),
+                    .size = sizeof(uint32_t),
+            });
+            values.push_back(constant.value);
+        }
+        info = vk::SpecializationInfo{
+                .mapEntryCount = static_cast<uint32_t>(mapEntries.size()),
+                .pMapEntries = mapEntries.data(),
+                .dataSize = values.size() * sizeof(uint32_t),
+                .pData = values.data(),
+        };
+    }
+
+    const vk::SpecializationInfo *SpecializationData::getInfo() const {
+        return mapEntries.empty() ? nullptr : &info;
+    }
+}
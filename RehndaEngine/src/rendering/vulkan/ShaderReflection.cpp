@@ -0,0 +1,197 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/ShaderReflection.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <spirv_cross/spirv_cross.hpp>
+
+namespace Rehnda {
+    namespace {
+        vk::ShaderStageFlagBits toShaderStage(spv::ExecutionModel executionModel) {
+            switch (executionModel) {
+                case spv::ExecutionModelVertex:
+                    return vk::ShaderStageFlagBits::eVertex;
+                case spv::ExecutionModelTessellationControl:
+                    return vk::ShaderStageFlagBits::eTessellationControl;
+                case spv::ExecutionModelTessellationEvaluation:
+                    return vk::ShaderStageFlagBits::eTessellationEvaluation;
+                case spv::ExecutionModelGeometry:
+                    return vk::ShaderStageFlagBits::eGeometry;
+                case spv::ExecutionModelFragment:
+                    return vk::ShaderStageFlagBits::eFragment;
+                case spv::ExecutionModelGLCompute:
+                    return vk::ShaderStageFlagBits::eCompute;
+                default:
+                    throw std::runtime_error("Unsupported shader execution model");
+            }
+        }
+
+        void addBindings(const spirv_cross::Compiler &compiler, const spirv_cross::SmallVector<spirv_cross::Resource> &resources,
+                         vk::DescriptorType type, vk::ShaderStageFlags stage, std::vector<ReflectedBinding> &bindings) {
+            for (const auto &resource: resources) {
+                const spirv_cross::SPIRType &spirType = compiler.get_type(resource.type_id);
+                vk::DescriptorType descriptorType = type;
+                // texel buffers come through as images with a buffer dimension
+                const bool isImage = spirType.basetype == spirv_cross::SPIRType::Image ||
+                                     spirType.basetype == spirv_cross::SPIRType::SampledImage;
+                if (isImage && spirType.image.dim == spv::DimBuffer) {
+                    descriptorType = type == vk::DescriptorType::eStorageImage ? vk::DescriptorType::eStorageTexelBuffer
+                                                                               : vk::DescriptorType::eUniformTexelBuffer;
+                }
+
+                uint32_t count = 1;
+                bool runtimeArray = false;
+                for (size_t i = 0; i < spirType.array.size(); i++) {
+                    if (spirType.array[i] == 0) {
+                        runtimeArray = true;
+                    } else if (spirType.array_size_literal[i]) {
+                        count *= spirType.array[i];
+                    } else {
+                        // sized by a specialization constant, which the layout has to be big enough for by default
+                        count *= compiler.get_constant(spirType.array[i]).scalar();
+                    }
+                }
+
+                bindings.push_back(ReflectedBinding{
+                        .set = compiler.get_decoration(resource.id, spv::DecorationDescriptorSet),
+                        .binding = compiler.get_decoration(resource.id, spv::DecorationBinding),
+                        .type = descriptorType,
+                        .count = runtimeArray ? 0 : count,
+                        .runtimeArray = runtimeArray,
+                        .stages = stage,
+                });
+            }
+        }
+    }
+
+    ShaderReflection ShaderReflection::reflect(std::span<const std::byte> spirv) {
+        // mappings and pack blobs are at least 16 byte aligned, which satisfies the uint32_t alignment SPIR-V needs
+        const spirv_cross::Compiler compiler(reinterpret_cast<const uint32_t *>(spirv.data()), spirv.size() / sizeof(uint32_t));
+        const spirv_cross::ShaderResources resources = compiler.get_shader_resources();
+
+        ShaderReflection reflection;
+        const vk::ShaderStageFlags stage = toShaderStage(compiler.get_execution_model());
+        reflection.stages = stage;
+
+        addBindings(compiler, resources.uniform_buffers, vk::DescriptorType::eUniformBuffer, stage, reflection.bindings);
+        addBindings(compiler, resources.storage_buffers, vk::DescriptorType::eStorageBuffer, stage, reflection.bindings);
+        addBindings(compiler, resources.sampled_images, vk::DescriptorType::eCombinedImageSampler, stage, reflection.bindings);
+        addBindings(compiler, resources.separate_images, vk::DescriptorType::eSampledImage, stage, reflection.bindings);
+        addBindings(compiler, resources.separate_samplers, vk::DescriptorType::eSampler, stage, reflection.bindings);
+        addBindings(compiler, resources.storage_images, vk::DescriptorType::eStorageImage, stage, reflection.bindings);
+        addBindings(compiler, resources.subpass_inputs, vk::DescriptorType::eInputAttachment, stage, reflection.bindings);
+        reflection.sortBindings();
+
+        // GLSL allows one push constant block per stage
+        for (const auto &pushConstants: resources.push_constant_buffers) {
+            const auto size = static_cast<uint32_t>(compiler.get_declared_struct_size(compiler.get_type(pushConstants.base_type_id)));
+            reflection.pushConstantSize = std::max(reflection.pushConstantSize, size);
+            reflection.pushConstantStages = stage;
+        }
+
+        if (stage == vk::ShaderStageFlagBits::eVertex) {
+            for (const auto &input: resources.stage_inputs) {
+                reflection.vertexInputs.push_back(ReflectedVertexInput{
+                        .location = compiler.get_decoration(input.id, spv::DecorationLocation),
+                        .componentCount = compiler.get_type(input.type_id).vecsize,
+                });
+            }
+            std::sort(reflection.vertexInputs.begin(), reflection.vertexInputs.end(),
+                      [](const ReflectedVertexInput &a, const ReflectedVertexInput &b) { return a.location < b.location; });
+        }
+        return reflection;
+    }
+
+    ShaderReflection ShaderReflection::merge(std::span<const ShaderReflection> shaders) {
+        ShaderReflection merged;
+        for (const auto &shader: shaders) {
+            merged.stages |= shader.stages;
+            merged.pushConstantSize = std::max(merged.pushConstantSize, shader.pushConstantSize);
+            merged.pushConstantStages |= shader.pushConstantStages;
+            // a pipeline only has one vertex shader, but when several are merged the layout has to satisfy them all
+            for (const auto &input: shader.vertexInputs) {
+                const auto existing = std::find_if(merged.vertexInputs.begin(), merged.vertexInputs.end(),
+                                                   [&](const ReflectedVertexInput &other) { return other.location == input.location; });
+                if (existing == merged.vertexInputs.end()) {
+                    merged.vertexInputs.push_back(input);
+                } else {
+                    existing->componentCount = std::max(existing->componentCount, input.componentCount);
+                }
+            }
+
+            for (const auto &binding: shader.bindings) {
+                const auto existing = std::find_if(merged.bindings.begin(), merged.bindings.end(), [&](const ReflectedBinding &other) {
+                    return other.set == binding.set && other.binding == binding.binding;
+                });
+                if (existing == merged.bindings.end()) {
+                    merged.bindings.push_back(binding);
+                    continue;
+                }
+                if (existing->type != binding.type || existing->count != binding.count || existing->runtimeArray != binding.runtimeArray) {
+                    throw std::runtime_error(fmt::format("Shaders disagree on the descriptor at set {} binding {}",
+                                                         binding.set, binding.binding));
+                }
+                existing->stages |= binding.stages;
+            }
+        }
+        merged.sortBindings();
+        std::sort(merged.vertexInputs.begin(), merged.vertexInputs.end(),
+                  [](const ReflectedVertexInput &a, const ReflectedVertexInput &b) { return a.location < b.location; });
+        return merged;
+    }
+
+    void ShaderReflection::sortBindings() {
+        std::sort(bindings.begin(), bindings.end(), [](const ReflectedBinding &a, const ReflectedBinding &b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+    }
+
+    vk::ShaderStageFlags ShaderReflection::getStages() const {
+        return stages;
+    }
+
+    const std::vector<ReflectedBinding> &ShaderReflection::getBindings() const {
+        return bindings;
+    }
+
+    std::vector<ReflectedBinding> ShaderReflection::getSetBindings(uint32_t set) const {
+        std::vector<ReflectedBinding> setBindings;
+        std::copy_if(bindings.begin(), bindings.end(), std::back_inserter(setBindings),
+                     [set](const ReflectedBinding &binding) { return binding.set == set; });
+        return setBindings;
+    }
+
+    uint32_t ShaderReflection::getSetCount() const {
+        return bindings.empty() ? 0 : bindings.back().set + 1;
+    }
+
+    std::vector<vk::PushConstantRange> ShaderReflection::getPushConstantRanges() const {
+        if (pushConstantSize == 0) {
+            return {};
+        }
+        return {vk::PushConstantRange{.stageFlags = pushConstantStages, .offset = 0, .size = pushConstantSize}};
+    }
+
+    const std::vector<ReflectedVertexInput> &ShaderReflection::getVertexInputs() const {
+        return vertexInputs;
+    }
+
+    void ShaderReflection::validateVertexInput(const VertexInputDescription &vertexInput) const {
+        for (const auto &input: vertexInputs) {
+            const auto attribute = std::find_if(vertexInput.attributes.begin(), vertexInput.attributes.end(),
+                                                [&](const vk::VertexInputAttributeDescription &other) {
+                                                    return other.location == input.location;
+                                                });
+            if (attribute == vertexInput.attributes.end()) {
+                throw std::runtime_error(fmt::format("Vertex shader reads location {} which the vertex layout doesn't provide",
+                                                     input.location));
+            }
+        }
+    }
+}
@@ -6,8 +6,8 @@
 #include "rendering/vulkan/BufferHelper.hpp"
 
 namespace Rehnda {
-    StagedBuffer::StagedBuffer(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, vkr::CommandPool &commandPool,
-                               vkr::Queue &queue, const StagedBufferProps &stagedBufferProps) :
+    StagedBuffer::StagedBuffer(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, UploadQueue &uploadQueue,
+                               const StagedBufferProps &stagedBufferProps) :
             dataSize(stagedBufferProps.dataSize),
             device(device),
             physicalDevice(physicalDevice),
@@ -36,35 +36,16 @@ namespace Rehnda {
 
         // TODO#2 allocating memory for every buffer is not scalable as there is a max mem
         //  allocation count which is relatively low (as low as 4096 on a 1080)
-        vk::CommandBufferAllocateInfo allocateInfo{
-                .commandPool = *commandPool,
-                .level = vk::CommandBufferLevel::ePrimary,
-                .commandBufferCount = 1
-        };
-
-        vkr::CommandBuffers commandBuffers{device, allocateInfo};
-        vkr::CommandBuffer &commandBuffer = commandBuffers.front();
-
-        vk::CommandBufferBeginInfo beginInfo{
-                .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit
-        };
-        commandBuffer.begin(beginInfo);
-
         vk::BufferCopy bufferCopy{
                 .srcOffset = 0,
                 .dstOffset = 0,
                 .size = dataSize
         };
-        commandBuffer.copyBuffer(*stagingBuffer, *buffer, bufferCopy);
-        commandBuffer.end();
-
-        queue.submit({vk::SubmitInfo{
-                .commandBufferCount = 1,
-                .pCommandBuffers = &*commandBuffer
-        }});
-        // Instead of waiting on the queue to confirm the memory has been copied can use fences to queue multiple
-        // transfers at once and then wait for all of them
-        queue.waitIdle();
+        // batched with the other uploads rather than waiting on the queue for every buffer, the staging buffer lives
+        // until the copy is done
+        uploadQueue.getCommandBuffer().copyBuffer(*stagingBuffer, *buffer, bufferCopy);
+        uploadQueue.releaseBuffer(*buffer, stagedBufferProps.firstUsage);
+        uploadQueue.keepAlive(std::move(stagingBuffer), std::move(stagingBufferMemory));
     }
 
     const vkr::Buffer &StagedBuffer::getBuffer() const {
@@ -75,7 +56,7 @@ namespace Rehnda {
         vk::BufferCreateInfo bufferCreateInfo{
                 .size = dataSize,
                 .usage = bufferUsageFlags | vk::BufferUsageFlagBits::eTransferDst,
-                // this buffer is only used by the graphics queue, so can be exclusive
+                // exclusive, the upload queue transfers ownership to the graphics queue after the copy
                 .sharingMode = vk::SharingMode::eExclusive
         };
         return {device, bufferCreateInfo};
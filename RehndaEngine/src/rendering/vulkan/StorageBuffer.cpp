@@ -0,0 +1,37 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/StorageBuffer.hpp"
+#include "rendering/vulkan/BufferHelper.hpp"
+
+namespace Rehnda {
+    StorageBuffer::StorageBuffer(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, const StorageBufferProps &props) :
+            dataSize(props.dataSize),
+            buffer(nullptr),
+            bufferMemory(nullptr) {
+        std::tie(buffer, bufferMemory) = BufferHelper::createBuffer(device, physicalDevice, {
+                .size = props.dataSize,
+                .bufferUsage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst |
+                               props.additionalUsageFlags,
+                .requiredMemoryProperties = vk::MemoryPropertyFlagBits::eDeviceLocal,
+                .queueFamilies = props.queueFamilies,
+        });
+    }
+
+    void StorageBuffer::recordFill(vkr::CommandBuffer &commandBuffer, uint32_t value) const {
+        commandBuffer.fillBuffer(*buffer, 0, VK_WHOLE_SIZE, value);
+    }
+
+    vk::DescriptorBufferInfo StorageBuffer::getDescriptorInfo() const {
+        return {.buffer = *buffer, .offset = 0, .range = VK_WHOLE_SIZE};
+    }
+
+    const vkr::Buffer &StorageBuffer::getBuffer() const {
+        return buffer;
+    }
+
+    vk::DeviceSize StorageBuffer::getSize() const {
+        return dataSize;
+    }
+}
@@ -3,22 +3,25 @@
 //
 
 #include "rendering/vulkan/SwapchainManager.hpp"
+#include <algorithm>
 #include <limits>
 
 namespace Rehnda {
-    SwapchainManager::SwapchainManager(vkr::Device &device, const vkr::SurfaceKHR &surface, QueueFamilyIndices indices,
-                                       const vkr::RenderPass &renderPass, const vkr::ImageView& depthImageView, const SwapChainSupportDetails &swapChainSupportDetails) :
+    SwapchainManager::SwapchainManager(vkr::Device &device, const vkr::PhysicalDevice &physicalDevice,
+                                       const vkr::SurfaceKHR &surface, QueueFamilyIndices indices,
+                                       SwapChainSupportDetails swapChainSupportDetails, vk::Extent2D framebufferExtent) :
             device(device),
+            physicalDevice(physicalDevice),
             surface(surface),
             queueFamilyIndices(
                     indices),
             swapChainSupportDetails(
-                    swapChainSupportDetails),
-            swapchainSurfaceFormat(swapChainSupportDetails.chooseSwapSurfaceFormat()),
-            swapchainExtent(swapChainSupportDetails.chooseSwapExtent()),
+                    std::move(swapChainSupportDetails)),
+            presentQueue(device.getQueue(indices.presentQueueIndex.value(), 0)),
+            swapchainSurfaceFormat(this->swapChainSupportDetails.chooseSwapSurfaceFormat()),
+            swapchainExtent(this->swapChainSupportDetails.chooseSwapExtent(framebufferExtent)),
             swapchain(createSwapchain()),
-            swapchainImageViews(createImageViews()),
-            swapchainFramebuffers(createFrameBuffers(renderPass, depthImageView)){
+            swapchainImages(getSwapchainImages()) {
 
     }
 
@@ -32,6 +35,10 @@ namespace Rehnda {
             imageCount = swapChainSupportDetails.capabilities.maxImageCount;
         }
 
+        if (!(swapChainSupportDetails.capabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferDst)) {
+            throw std::runtime_error("Swapchain images can't be transfer destinations");
+        }
+
         vk::SwapchainCreateInfoKHR createInfo = {
                 .surface = *surface,
                 .minImageCount = imageCount,
@@ -39,7 +46,8 @@ namespace Rehnda {
                 .imageColorSpace = swapchainSurfaceFormat.colorSpace,
                 .imageExtent = swapchainExtent,
                 .imageArrayLayers = 1,
-                .imageUsage = vk::ImageUsageFlagBits::eColorAttachment
+                // the offscreen render target is blitted in rather than rendered to directly
+                .imageUsage = vk::ImageUsageFlagBits::eTransferDst
         };
 
         uint32_t indicesArray[] = {queueFamilyIndices.graphicsQueueIndex.value(),
@@ -67,81 +75,45 @@ namespace Rehnda {
        return std::make_unique<vkr::SwapchainKHR>(device, createInfo);
     }
 
-    void SwapchainManager::resize(const vkr::RenderPass &renderPass, const vkr::ImageView& depthImageView) {
+    void SwapchainManager::resize(vk::Extent2D framebufferExtent) {
         device.waitIdle();
-        swapchainFramebuffers.clear();
-        swapchainImageViews.clear();
+        swapchainImages.clear();
         swapchain.reset();
-        swapchainExtent = swapChainSupportDetails.chooseSwapExtent();
+        swapChainSupportDetails.refreshCapabilities(physicalDevice, surface);
+        swapchainExtent = swapChainSupportDetails.chooseSwapExtent(framebufferExtent);
         swapchain = createSwapchain();
-        swapchainImageViews = createImageViews();
-        swapchainFramebuffers = createFrameBuffers(renderPass, depthImageView);
+        swapchainImages = getSwapchainImages();
     }
 
-    std::vector<vkr::ImageView> SwapchainManager::createImageViews() {
-        const std::vector<VkImage> swapchainImages = swapchain->getImages();
-        std::vector<vkr::ImageView> imageViews;
-        for (size_t i = 0; i < swapchainImages.size(); i++) {
-            vk::ImageViewCreateInfo imageViewCreateInfo{
-                    .image = swapchainImages[i],
-                    .viewType = vk::ImageViewType::e2D,
-                    .format = swapchainSurfaceFormat.format,
-                    .components = {
-                            .r = vk::ComponentSwizzle::eIdentity,
-                            .g = vk::ComponentSwizzle::eIdentity,
-                            .b = vk::ComponentSwizzle::eIdentity,
-                            .a = vk::ComponentSwizzle::eIdentity,
-                    },
-                    .subresourceRange = {
-                            .aspectMask = vk::ImageAspectFlagBits::eColor,
-                            .baseMipLevel = 0,
-                            .levelCount = 1,
-                            .baseArrayLayer = 0,
-                            .layerCount = 1,
-                    },
-            };
-            imageViews.emplace_back(device, imageViewCreateInfo);
+    std::vector<vk::Image> SwapchainManager::getSwapchainImages() {
+        std::vector<vk::Image> images;
+        for (const VkImage image: swapchain->getImages()) {
+            images.emplace_back(image);
         }
-        return imageViews;
+        return images;
     }
 
     vk::Extent2D SwapchainManager::getExtent() const {
         return swapchainExtent;
     }
 
-    std::vector<vkr::Framebuffer> SwapchainManager::createFrameBuffers(const vkr::RenderPass &renderPass, const vkr::ImageView& depthImageView) {
-        std::vector<vkr::Framebuffer> buffers;
-        for (size_t i = 0; i < swapchainImageViews.size(); i++) {
-            std::array<vk::ImageView, 2> attachments{
-                    *swapchainImageViews[i],
-                    *depthImageView
-            };
-
-            vk::FramebufferCreateInfo framebufferCreateInfo{
-                    // need the renderpass for the framebuffer to be created to be compatible with it
-                    .renderPass = *renderPass,
-                    .attachmentCount = attachments.size(),
-                    .pAttachments = attachments.data(),
-                    .width = swapchainExtent.width,
-                    .height = swapchainExtent.height,
-                    .layers = 1,
-            };
-
-            buffers.emplace_back(device, framebufferCreateInfo);
-        }
-        return buffers;
+    vk::Format SwapchainManager::getFormat() const {
+        return swapchainSurfaceFormat.format;
+    }
+
+    vk::Image SwapchainManager::getImage(size_t imageIndex) const {
+        return swapchainImages[imageIndex];
     }
 
-    vkr::Framebuffer &SwapchainManager::getSwapchainFramebuffer(size_t bufferIndex) {
-        return swapchainFramebuffers[bufferIndex];
+    bool SwapchainManager::isPresented() const {
+        return true;
     }
 
     std::pair<vk::Result, uint32_t> SwapchainManager::acquireNextImageIndex(vkr::Semaphore &imageAvailableSemaphore) {
         return swapchain->acquireNextImage(UINT64_MAX, *imageAvailableSemaphore);
     }
 
-    PresentResult SwapchainManager::present(const std::vector<vk::Semaphore> &waitSemaphores, vkr::Queue &presentQueue,
-                                            uint32_t imageIndex) {
+    PresentResult SwapchainManager::present(const std::vector<vk::Semaphore> &waitSemaphores, uint32_t imageIndex) {
         vkr::SwapchainKHR& swap = *swapchain;
         vk::SwapchainKHR swapChains[] = {*swap};
         vk::PresentInfoKHR presentInfoKhr{
@@ -159,11 +131,9 @@ namespace Rehnda {
         return PresentResult::SUCCESS;
     }
 
-    SwapChainSupportDetails::SwapChainSupportDetails(GLFWwindow *window,
-                                                     const vkr::PhysicalDevice &physicalDevice,
+    SwapChainSupportDetails::SwapChainSupportDetails(const vkr::PhysicalDevice &physicalDevice,
                                                      const vkr::SurfaceKHR &surface) :
             capabilities(physicalDevice.getSurfaceCapabilitiesKHR(*surface)),
-            window(window),
             formats(physicalDevice.getSurfaceFormatsKHR(*surface)),
             presentModes(physicalDevice.getSurfacePresentModesKHR(*surface)) {
     }
@@ -187,17 +157,16 @@ namespace Rehnda {
         return vk::PresentModeKHR::eFifo;
     }
 
-    vk::Extent2D SwapChainSupportDetails::chooseSwapExtent() const {
+    void SwapChainSupportDetails::refreshCapabilities(const vkr::PhysicalDevice &physicalDevice,
+                                                      const vkr::SurfaceKHR &surface) {
+        capabilities = physicalDevice.getSurfaceCapabilitiesKHR(*surface);
+    }
+
+    vk::Extent2D SwapChainSupportDetails::chooseSwapExtent(vk::Extent2D framebufferExtent) const {
         if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
             return capabilities.currentExtent;
         } else {
-            int width, height;
-            glfwGetFramebufferSize(window, &width, &height);
-
-            vk::Extent2D actualExtent = {
-                    static_cast<uint32_t>(width),
-                    static_cast<uint32_t>(height)
-            };
+            vk::Extent2D actualExtent = framebufferExtent;
 
             actualExtent.width = std::clamp(actualExtent.width, capabilities.minImageExtent.width,
                                             capabilities.maxImageExtent.width);
@@ -4,8 +4,8 @@
 
 #include "rendering/vulkan/TextureImage.hpp"
 #include "rendering/vulkan/BufferHelper.hpp"
-#include "rendering/vulkan/SingleTimeCommand.hpp"
 #include "rendering/vulkan/Image.hpp"
+#include "core/MappedFile.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 
@@ -13,10 +13,16 @@
 
 namespace Rehnda {
 
-    TextureImage::TextureImage(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, vkr::Queue &queue, vkr::CommandPool &commandPool,
+    TextureImage::TextureImage(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, UploadQueue &uploadQueue,
                                const std::filesystem::path &pathToTexture) :
+            // the mapping only needs to outlive decoding, which happens entirely within the delegated constructor
+            TextureImage(device, physicalDevice, uploadQueue, MappedFile{pathToTexture}.bytes()) {
+    }
+
+    TextureImage::TextureImage(vkr::Device &device, vkr::PhysicalDevice &physicalDevice, UploadQueue &uploadQueue,
+                               std::span<const std::byte> encodedImage) :
             device(device),
-            pixelData(loadImage(pathToTexture)),
+            pixelData(loadImage(encodedImage)),
             image(device, physicalDevice, ImageProps{
                     .width = textureWidth,
                     .height = textureHeight,
@@ -43,16 +49,18 @@ namespace Rehnda {
         stagingBufferMemory.unmapMemory();
         stbi_image_free(pixelData);
 
+        // recorded into the upload queue's batch rather than a blocking submit of its own
+        vkr::CommandBuffer &commandBuffer = uploadQueue.getCommandBuffer();
         // Wait for image to be ready to transfer to, starting state doesn't matter
-        image.transitionImageLayout(queue, commandPool, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
+        image.recordTransition(commandBuffer, ImageUsage::UNDEFINED, ImageUsage::TRANSFER_DST);
         // copy to the image from the staging buffer now that the destination is ready
-        copyBufferToImage(stagingBuffer, queue, commandPool);
-        // Wait for image to be ready to be read in a fragment shader
-        image.transitionImageLayout(queue, commandPool, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+        copyBufferToImage(commandBuffer, stagingBuffer);
+        // hands it to the graphics queue ready to be read in a fragment shader
+        uploadQueue.releaseImage(*image.getImage(), vk::ImageAspectFlagBits::eColor, ImageUsage::SAMPLED_FRAGMENT);
+        uploadQueue.keepAlive(std::move(stagingBuffer), std::move(stagingBufferMemory));
     }
 
-    void TextureImage::copyBufferToImage(vkr::Buffer &stagingBuffer, vkr::Queue &queue, vkr::CommandPool &commandPool) const {
-        SingleTimeCommand singleTimeCommand{device, queue, commandPool};
+    void TextureImage::copyBufferToImage(vkr::CommandBuffer &commandBuffer, const vkr::Buffer &stagingBuffer) const {
         vk::BufferImageCopy region{
                 .bufferOffset = 0,
                 .bufferRowLength = 0,
@@ -70,12 +78,15 @@ namespace Rehnda {
                         .depth = 1,
                 }
         };
-        singleTimeCommand.commandBuffer.copyBufferToImage(*stagingBuffer, *image.getImage(), vk::ImageLayout::eTransferDstOptimal, region);
+        commandBuffer.copyBufferToImage(*stagingBuffer, *image.getImage(), vk::ImageLayout::eTransferDstOptimal, region);
     }
 
-    void *TextureImage::loadImage(const std::filesystem::path &pathToTexture) {
+    void *TextureImage::loadImage(std::span<const std::byte> encodedImage) {
         int texWidth, texHeight, texChannels;
-        stbi_uc *pixels = stbi_load(pathToTexture.string().c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+        // decode directly from the encoded bytes rather than letting stb stream the file through its own buffers
+        stbi_uc *pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(encodedImage.data()),
+                                                static_cast<int>(encodedImage.size()), &texWidth, &texHeight,
+                                                &texChannels, STBI_rgb_alpha);
         textureWidth = static_cast<uint32_t>(texWidth);
         textureHeight = static_cast<uint32_t>(texHeight);
         numChannels = 4;
@@ -0,0 +1,140 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "rendering/vulkan/UploadQueue.hpp"
+
+#include <algorithm>
+
+namespace Rehnda {
+    UploadQueue::UploadQueue(vkr::Device &device, QueueFamilyIndices queueFamilyIndices) :
+            device(device),
+            transferFamily(queueFamilyIndices.getTransferFamily()),
+            graphicsFamily(queueFamilyIndices.graphicsQueueIndex.value()),
+            // without a dedicated family this is the graphics queue itself
+            queue(device.getQueue(transferFamily, 0)),
+            commandPool(device, vk::CommandPoolCreateInfo{
+                    .flags = vk::CommandPoolCreateFlagBits::eTransient,
+                    .queueFamilyIndex = transferFamily,
+            }) {
+    }
+
+    bool UploadQueue::hasDedicatedQueue() const {
+        return transferFamily != graphicsFamily;
+    }
+
+    vkr::CommandBuffer &UploadQueue::getCommandBuffer() {
+        if (!openBatch) {
+            vkr::CommandBuffers commandBuffers{device, vk::CommandBufferAllocateInfo{
+                    .commandPool = *commandPool,
+                    .level = vk::CommandBufferLevel::ePrimary,
+                    .commandBufferCount = 1,
+            }};
+            openBatch.emplace(Batch{
+                    .commandBuffer = std::move(commandBuffers[0]),
+                    .uploaded = vkr::Semaphore{device, vk::SemaphoreCreateInfo{}},
+            });
+            openBatch->commandBuffer.begin(vk::CommandBufferBeginInfo{
+                    .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+            });
+        }
+        return openBatch->commandBuffer;
+    }
+
+    void UploadQueue::keepAlive(vkr::Buffer &&stagingBuffer, vkr::DeviceMemory &&stagingMemory) {
+        getCommandBuffer();
+        openBatch->stagingBuffers.emplace_back(std::move(stagingBuffer), std::move(stagingMemory));
+    }
+
+    void UploadQueue::releaseBuffer(vk::Buffer buffer, BufferUsage firstUsage) {
+        vkr::CommandBuffer &commandBuffer = getCommandBuffer();
+        const ResourceAccess access = ResourceUsage::getAccess(firstUsage);
+        openBatch->acquireStages |= access.stages;
+        if (!hasDedicatedQueue()) {
+            // same family, so it's just a barrier between the copy and the first use
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, access.stages, vk::DependencyFlags{},
+                                          vk::MemoryBarrier{.srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                                                            .dstAccessMask = access.access}, nullptr, nullptr);
+            return;
+        }
+        // the release and acquire halves have to match exactly apart from their access masks
+        vk::BufferMemoryBarrier barrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eNone,
+                .srcQueueFamilyIndex = transferFamily,
+                .dstQueueFamilyIndex = graphicsFamily,
+                .buffer = buffer,
+                .offset = 0,
+                .size = VK_WHOLE_SIZE,
+        };
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+                                      vk::DependencyFlags{}, nullptr, barrier, nullptr);
+        barrier.srcAccessMask = vk::AccessFlagBits::eNone;
+        barrier.dstAccessMask = access.access;
+        openBatch->bufferAcquires.push_back(barrier);
+    }
+
+    void UploadQueue::releaseImage(vk::Image image, vk::ImageAspectFlags aspect, ImageUsage firstUsage) {
+        vkr::CommandBuffer &commandBuffer = getCommandBuffer();
+        const ResourceAccess access = ResourceUsage::getAccess(firstUsage);
+        vk::ImageMemoryBarrier barrier = ResourceUsage::imageBarrier(image, aspect, ImageUsage::TRANSFER_DST, firstUsage);
+        openBatch->acquireStages |= access.stages;
+        if (!hasDedicatedQueue()) {
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, access.stages, vk::DependencyFlags{},
+                                          nullptr, nullptr, barrier);
+            return;
+        }
+        // the layout transition happens once, between the release and the acquire
+        barrier.dstAccessMask = vk::AccessFlagBits::eNone;
+        barrier.srcQueueFamilyIndex = transferFamily;
+        barrier.dstQueueFamilyIndex = graphicsFamily;
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+                                      vk::DependencyFlags{}, nullptr, nullptr, barrier);
+        barrier.srcAccessMask = vk::AccessFlagBits::eNone;
+        barrier.dstAccessMask = access.access;
+        openBatch->imageAcquires.push_back(barrier);
+    }
+
+    void UploadQueue::flush() {
+        if (!openBatch) {
+            return;
+        }
+        openBatch->commandBuffer.end();
+        queue.submit(vk::SubmitInfo{
+                .commandBufferCount = 1,
+                .pCommandBuffers = &*openBatch->commandBuffer,
+                .signalSemaphoreCount = 1,
+                .pSignalSemaphores = &*openBatch->uploaded,
+        });
+        submittedBatches.push_back(std::move(*openBatch));
+        openBatch.reset();
+    }
+
+    void UploadQueue::recordAcquires(vkr::CommandBuffer &commandBuffer, size_t frameIndex,
+                                     std::vector<vk::Semaphore> &waitSemaphores,
+                                     std::vector<vk::PipelineStageFlags> &waitStages) {
+        for (auto &batch: submittedBatches) {
+            if (batch.acquiringFrame) {
+                continue;
+            }
+            batch.acquiringFrame = frameIndex;
+            // same family batches only need the semaphore, their barriers were recorded along with the copies.
+            // Waiting at the stages that first use the uploads leaves everything before them free to start
+            const vk::PipelineStageFlags stages = batch.acquireStages ? batch.acquireStages
+                                                                      : vk::PipelineStageFlags{vk::PipelineStageFlagBits::eAllCommands};
+            waitSemaphores.push_back(*batch.uploaded);
+            waitStages.push_back(stages);
+            if (!batch.bufferAcquires.empty() || !batch.imageAcquires.empty()) {
+                // the acquire chains off the semaphore wait by starting at the same stages
+                commandBuffer.pipelineBarrier(stages, stages, vk::DependencyFlags{}, nullptr, batch.bufferAcquires,
+                                              batch.imageAcquires);
+            }
+        }
+    }
+
+    void UploadQueue::collect(size_t frameIndex) {
+        std::erase_if(submittedBatches, [&](const Batch &batch) {
+            return batch.acquiringFrame == frameIndex;
+        });
+    }
+}
@@ -10,7 +10,7 @@
 
 
 namespace Rehnda::VkInstanceHelpers {
-    vkr::Instance buildVulkanInstance(vkr::Context &context, std::vector<const char *> validationLayers) {
+    vkr::Instance buildVulkanInstance(vkr::Context &context, std::vector<const char *> validationLayers, bool windowed) {
         vk::ApplicationInfo applicationInfo{
                 .pApplicationName = "Rehnda",
                 .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
@@ -19,7 +19,7 @@ namespace Rehnda::VkInstanceHelpers {
                 .apiVersion = VK_API_VERSION_1_3,
         };
 
-        std::vector<const char *> required_extensions = get_required_extensions(validationLayers);
+        std::vector<const char *> required_extensions = get_required_extensions(validationLayers, windowed);
 
         const std::vector<vk::ExtensionProperties> &extensions = context.enumerateInstanceExtensionProperties();
         SPDLOG_DEBUG("Enabling extensions:");
@@ -67,15 +67,17 @@ namespace Rehnda::VkInstanceHelpers {
         return true;
     }
 
-    std::vector<const char *> get_required_extensions(std::vector<const char *> validationLayers) {
-        uint32_t glfwExtensionCount = 0;
-        const char **glfwExtensions;
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-        std::vector<const char *> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    std::vector<const char *> get_required_extensions(std::vector<const char *> validationLayers, bool windowed) {
+        std::vector<const char *> extensions;
+        if (windowed) {
+            uint32_t glfwExtensionCount = 0;
+            const char **glfwExtensions;
+            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
-        // if the khronos validation layer is enabled we need to enable debug utils extensions
-        if (std::find(validationLayers.begin(), validationLayers.end(), "VK_LAYER_KHRONOS_validation") != extensions.end()) {
+        // validation reports through a debug utils messenger
+        if (!validationLayers.empty()) {
             extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
         }
 
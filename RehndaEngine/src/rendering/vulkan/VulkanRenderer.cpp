@@ -7,31 +7,67 @@
 #include <map>
 #include <set>
 
+#include <spdlog/spdlog.h>
+
 #include "rendering/vulkan/VkInstanceHelpers.hpp"
 #include "rendering/vulkan/VkDebugHelpers.hpp"
 #include "rendering/vulkan/SwapchainManager.hpp"
+#include "rendering/vulkan/HeadlessFrameOutput.hpp"
+#include "rendering/vulkan/BindlessResources.hpp"
 
+// only when there's a window to present to
 const std::vector<const char *> requiredDeviceExtensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
 };
 
-#ifdef NDEBUG
-const bool enableValidationLayers = false;
-#else
-const bool enableValidationLayers = true;
-#endif
+const std::vector<const char *> validationLayers = {
+        "VK_LAYER_KHRONOS_validation"
+};
 
 namespace Rehnda {
-    // TODO#4 Don't include validation layers in release builds
-    VulkanRenderer::VulkanRenderer(GLFWwindow *window) :
+    VulkanRenderer::VulkanRenderer(GLFWwindow *window, JobSystem &jobSystem, FrameCoordinatorProps frameCoordinatorProps) :
+            VulkanRenderer(window, vk::Extent2D{}, jobSystem, frameCoordinatorProps, VALIDATION_LAYERS_BY_DEFAULT) {
+    }
+
+    VulkanRenderer::VulkanRenderer(vk::Extent2D headlessExtent, JobSystem &jobSystem,
+                                   FrameCoordinatorProps frameCoordinatorProps, bool validation) :
+            VulkanRenderer(nullptr, headlessExtent, jobSystem, frameCoordinatorProps, validation) {
+    }
+
+    VulkanRenderer::VulkanRenderer(GLFWwindow *window, vk::Extent2D headlessExtent, JobSystem &jobSystem,
+                                   FrameCoordinatorProps frameCoordinatorProps, bool validation) :
             window(window),
-            instance(VkInstanceHelpers::buildVulkanInstance(context, {"VK_LAYER_KHRONOS_validation"})),
-            debugMessenger(VkDebugHelpers::setupDebugMessenger(instance)),
+            // asked for but not installed runs without them, rather than failing to create the instance
+            enableValidationLayers(validation && VkInstanceHelpers::are_validation_layers_supported(context, validationLayers)),
+            instance(VkInstanceHelpers::buildVulkanInstance(context, enableValidationLayers ? validationLayers : std::vector<const char *>{},
+                                                            window != nullptr)),
+            // the messenger comes from the debug utils extension, which is only enabled alongside the layers
+            debugMessenger(enableValidationLayers ? VkDebugHelpers::setupDebugMessenger(instance) : vkr::DebugUtilsMessengerEXT{nullptr}),
             surface(createSurface()),
             physicalDevice(pickPhysicalDevice()),
             queueFamilyIndices(findQueueFamilies()),
+            memoryBudgetEnabled(areRequiredExtensionsSupported(physicalDevice, {VK_EXT_MEMORY_BUDGET_EXTENSION_NAME})),
             device(createDevice()) {
-        frameCoordinator = std::make_unique<FrameCoordinator>(window, device, physicalDevice, surface, queueFamilyIndices);
+        SPDLOG_INFO("Rendering on {}{}", getDeviceName(), window ? "" : " headless");
+        if (validation && !enableValidationLayers) {
+            SPDLOG_WARN("Validation layers are desired but not supported");
+        }
+        if (window) {
+            // constructed on the main thread, so asking GLFW is fine here. Later sizes come from Window's resize callback
+            int framebufferWidth = 0;
+            int framebufferHeight = 0;
+            glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+            frameOutput = std::make_unique<SwapchainManager>(device, physicalDevice, surface, queueFamilyIndices,
+                                                             SwapChainSupportDetails{physicalDevice, surface},
+                                                             vk::Extent2D{static_cast<uint32_t>(framebufferWidth),
+                                                                          static_cast<uint32_t>(framebufferHeight)});
+        } else {
+            frameOutput = std::make_unique<HeadlessFrameOutput>(device, physicalDevice, HeadlessFrameOutputProps{
+                    .extent = headlessExtent,
+            });
+        }
+        frameCoordinator = std::make_unique<FrameCoordinator>(device, physicalDevice, queueFamilyIndices, jobSystem,
+                                                              *frameOutput, frameCoordinatorProps);
     }
 
     vkr::PhysicalDevice VulkanRenderer::pickPhysicalDevice() {
@@ -80,14 +116,20 @@ namespace Rehnda {
 //            return 0;
 //        }
 
-        if (!areRequiredExtensionsSupported(device, requiredDeviceExtensions)) {
-            return 0;
+        if (window) {
+            if (!areRequiredExtensionsSupported(device, requiredDeviceExtensions)) {
+                return 0;
+            }
+            SwapChainSupportDetails swapChainSupportDetails{device, surfaceKhr};
+            if (swapChainSupportDetails.formats.empty() || swapChainSupportDetails.presentModes.empty()) {
+                return 0;
+            }
         }
-        SwapChainSupportDetails swapChainSupportDetails{window, device, surfaceKhr};
-        if (swapChainSupportDetails.formats.empty() || swapChainSupportDetails.presentModes.empty()) {
+        if (!deviceFeatures.samplerAnisotropy) {
             return 0;
         }
-        if (!deviceFeatures.samplerAnisotropy) {
+        // textures and materials are all accessed bindlessly
+        if (!BindlessResources::isSupported(device)) {
             return 0;
         }
 
@@ -99,21 +141,36 @@ namespace Rehnda {
 
         const auto queueFamilyProperties = physicalDevice.getQueueFamilyProperties();
 
-        int i = 0;
-        for (const auto &queueFamily: queueFamilyProperties) {
-            if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics) {
-                indices.graphicsQueueIndex = i;
+        // every family is looked at rather than stopping at the first graphics one, the dedicated ones tend to come last
+        for (uint32_t i = 0; i < queueFamilyProperties.size(); i++) {
+            const vk::QueueFlags flags = queueFamilyProperties[i].queueFlags;
+            if (flags & vk::QueueFlagBits::eGraphics) {
+                if (!indices.graphicsQueueIndex.has_value()) {
+                    indices.graphicsQueueIndex = i;
+                }
+            } else if (flags & vk::QueueFlagBits::eCompute) {
+                // async compute, a family with compute but no graphics
+                if (!indices.computeQueueIndex.has_value()) {
+                    indices.computeQueueIndex = i;
+                }
+            } else if (flags & vk::QueueFlagBits::eTransfer) {
+                // transfer only, the DMA engines on discrete GPUs
+                if (!indices.transferQueueIndex.has_value()) {
+                    indices.transferQueueIndex = i;
+                }
             }
 
-            if (physicalDevice.getSurfaceSupportKHR(i, *surface)) {
+            if (window && !indices.presentQueueIndex.has_value() && physicalDevice.getSurfaceSupportKHR(i, *surface)) {
                 indices.presentQueueIndex = i;
             }
-
-            if (indices.requiredFamiliesFound()) {
-                break;
-            }
-            i++;
         }
+        // prefer presenting from the graphics family, saves sharing the swapchain images between families
+        if (window && indices.graphicsQueueIndex.has_value() &&
+            physicalDevice.getSurfaceSupportKHR(indices.graphicsQueueIndex.value(), *surface)) {
+            indices.presentQueueIndex = indices.graphicsQueueIndex;
+        }
+        SPDLOG_INFO("Dedicated transfer queue: {}, async compute queue: {}", indices.transferQueueIndex.has_value(),
+                    indices.computeQueueIndex.has_value());
 
         return indices;
     }
@@ -134,8 +191,13 @@ namespace Rehnda {
         std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
         std::set<uint32_t> uniqueQueueFamilies = {
                 queueFamilyIndices.graphicsQueueIndex.value(),
-                queueFamilyIndices.presentQueueIndex.value()
+                queueFamilyIndices.getTransferFamily(),
+                queueFamilyIndices.getComputeFamily(),
         };
+        // headless has nothing to present to
+        if (queueFamilyIndices.presentQueueIndex.has_value()) {
+            uniqueQueueFamilies.insert(queueFamilyIndices.presentQueueIndex.value());
+        }
 
         float queuePriority = 1.0f;
 
@@ -152,11 +214,23 @@ namespace Rehnda {
             .samplerAnisotropy = true,
         };
 
+        vk::PhysicalDeviceVulkan12Features vulkan12Features = BindlessResources::getRequiredFeatures();
+
+        std::vector<const char *> deviceExtensions;
+        if (window) {
+            deviceExtensions = requiredDeviceExtensions;
+        }
+        // optional, only used to report memory use
+        if (memoryBudgetEnabled) {
+            deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
         vk::DeviceCreateInfo deviceCreateInfo{
+                .pNext = &vulkan12Features,
                 .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
                 .pQueueCreateInfos = queueCreateInfos.data(),
-                .enabledExtensionCount = static_cast<uint32_t>(requiredDeviceExtensions.size()),
-                .ppEnabledExtensionNames = requiredDeviceExtensions.data(),
+                .enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size()),
+                .ppEnabledExtensionNames = deviceExtensions.data(),
                 .pEnabledFeatures = &physicalDeviceFeatures,
         };
         return {physicalDevice, deviceCreateInfo};
@@ -166,15 +240,55 @@ namespace Rehnda {
         device.waitIdle();
     }
 
-    void VulkanRenderer::drawFrame() {
-        frameCoordinator->drawFrame();
+    void VulkanRenderer::drawFrame(const RenderCommandStream &commands) {
+        frameCoordinator->drawFrame(commands);
+    }
+
+    void VulkanRenderer::resize(vk::Extent2D framebufferExtent) {
+        frameCoordinator->setFramebufferResized(framebufferExtent);
     }
 
-    void VulkanRenderer::resize() {
-        frameCoordinator->setFramebufferResized();
+    void VulkanRenderer::setDepthPrePass(bool enabled) {
+        frameCoordinator->setDepthPrePass(enabled);
+    }
+
+    bool VulkanRenderer::isDepthPrePassEnabled() const {
+        return frameCoordinator->isDepthPrePassEnabled();
+    }
+
+    const FrameStats &VulkanRenderer::getFrameStats() const {
+        return frameCoordinator->getFrameStats();
+    }
+
+    std::string VulkanRenderer::getDeviceName() const {
+        return physicalDevice.getProperties().deviceName;
+    }
+
+    bool VulkanRenderer::areValidationLayersEnabled() const {
+        return enableValidationLayers;
+    }
+
+    std::optional<vk::DeviceSize> VulkanRenderer::getDeviceMemoryUsage() const {
+        if (!memoryBudgetEnabled) {
+            return std::nullopt;
+        }
+        const auto properties = physicalDevice.getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2,
+                vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+        const auto &memoryProperties = properties.get<vk::PhysicalDeviceMemoryProperties2>().memoryProperties;
+        const auto &budget = properties.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+        vk::DeviceSize usage = 0;
+        for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+            if (memoryProperties.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+                usage += budget.heapUsage[i];
+            }
+        }
+        return usage;
     }
 
     vkr::SurfaceKHR VulkanRenderer::createSurface() {
+        if (!window) {
+            return vkr::SurfaceKHR{nullptr};
+        }
         VkSurfaceKHR _surface;
         if (glfwCreateWindowSurface(static_cast<VkInstance>(*instance), window, nullptr,
                                     &_surface) != VK_SUCCESS) {
@@ -5,13 +5,16 @@
 #include "rendering/vulkan/WritableDirectBuffer.hpp"
 #include "rendering/vulkan/BufferHelper.hpp"
 
+#include <cassert>
+#include <cstddef>
+
 namespace Rehnda {
     WritableDirectBuffer::WritableDirectBuffer(vkr::Device &device, vkr::PhysicalDevice &physicalDevice,
                                                const WritableDirectBufferProps &directBufferProps) : dataSize(
             directBufferProps.dataSize),
                                                                                                      device(device),
                                                                                                      physicalDevice(physicalDevice),
-                                                                                                     buffer(initBuffer(directBufferProps.bufferUsageFlags)),
+                                                                                                     buffer(initBuffer(directBufferProps.bufferUsageFlags, directBufferProps.queueFamilies)),
                                                                                                      bufferMemory(initDeviceMemory()) {
         // create the staging buffer which the host needs to be able to see (and coherent ensures the data is the same as what the CPU expects?)
         // and will be transferred from to the gpu later (hence transferSrc)
@@ -43,12 +46,17 @@ namespace Rehnda {
         memcpy(mappedMemory, data, (size_t) dataSize);
     }
 
-    vkr::Buffer WritableDirectBuffer::initBuffer(vk::BufferUsageFlags bufferUsageFlags) {
+    void WritableDirectBuffer::writeData(const void *data, vk::DeviceSize size, vk::DeviceSize offset) {
+        assert(offset + size <= dataSize);
+        memcpy(static_cast<std::byte *>(mappedMemory) + offset, data, (size_t) size);
+    }
+
+    vkr::Buffer WritableDirectBuffer::initBuffer(vk::BufferUsageFlags bufferUsageFlags, const std::vector<uint32_t> &queueFamilies) {
         vk::BufferCreateInfo bufferCreateInfo {
                 .size=dataSize,
                 .usage = bufferUsageFlags,
-                .sharingMode = vk::SharingMode::eExclusive
         };
+        BufferHelper::setSharingMode(bufferCreateInfo, queueFamilies);
         return {device, bufferCreateInfo};
     }
 }
\ No newline at end of file
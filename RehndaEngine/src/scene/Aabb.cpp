@@ -0,0 +1,49 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "scene/Aabb.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace Rehnda {
+    Aabb Aabb::empty() {
+        return {
+                .min = glm::vec3(std::numeric_limits<float>::max()),
+                .max = glm::vec3(std::numeric_limits<float>::lowest()),
+        };
+    }
+
+    void Aabb::expand(glm::vec3 point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void Aabb::expand(const Aabb &other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    glm::vec3 Aabb::center() const {
+        return (min + max) * 0.5f;
+    }
+
+    glm::vec3 Aabb::halfExtent() const {
+        return (max - min) * 0.5f;
+    }
+
+    Aabb Aabb::transformed(const glm::mat4 &transform) const {
+        // Arvo's method, the new half extent along each axis is the extent projected through the absolute rotation/scale
+        const glm::vec3 localCenter = center();
+        const glm::vec3 localExtent = halfExtent();
+        const glm::vec3 worldCenter = glm::vec3(transform * glm::vec4(localCenter, 1.f));
+        glm::vec3 worldExtent{0.f};
+        for (int row = 0; row < 3; row++) {
+            worldExtent[row] = std::abs(transform[0][row]) * localExtent.x +
+                               std::abs(transform[1][row]) * localExtent.y +
+                               std::abs(transform[2][row]) * localExtent.z;
+        }
+        return {.min = worldCenter - worldExtent, .max = worldCenter + worldExtent};
+    }
+}
@@ -0,0 +1,252 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "scene/Bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define REHNDA_BVH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Rehnda {
+    namespace {
+        // splits the objects in half at the median centroid along the axis their centroids spread the most on
+        std::span<uint32_t>::iterator splitAtMedian(std::span<uint32_t> objects, std::span<const glm::vec3> centroids) {
+            Aabb centroidBounds = Aabb::empty();
+            for (const uint32_t object: objects) {
+                centroidBounds.expand(centroids[object]);
+            }
+            const glm::vec3 spread = centroidBounds.max - centroidBounds.min;
+            const int axis = spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+            const auto median = objects.begin() + static_cast<std::ptrdiff_t>(objects.size() / 2);
+            std::nth_element(objects.begin(), median, objects.end(), [&](uint32_t a, uint32_t b) {
+                return centroids[a][axis] < centroids[b][axis];
+            });
+            return median;
+        }
+    }
+
+    void Bvh::build(std::span<const Aabb> objectBounds) {
+        nodes.clear();
+        objectSlots.assign(objectBounds.size(), {});
+        if (objectBounds.empty()) {
+            dirtyNodes.clear();
+            return;
+        }
+        std::vector<uint32_t> objects(objectBounds.size());
+        std::iota(objects.begin(), objects.end(), 0u);
+        std::vector<glm::vec3> centroids(objectBounds.size());
+        std::transform(objectBounds.begin(), objectBounds.end(), centroids.begin(), [](const Aabb &bounds) {
+            return bounds.center();
+        });
+        nodes.reserve(objectBounds.size() / 2 + 1);
+        buildNode(objects, objectBounds, centroids, EMPTY_SLOT, 0);
+        dirtyNodes.assign(nodes.size(), 0);
+        needsRefit = false;
+    }
+
+    uint32_t Bvh::buildNode(std::span<uint32_t> objects, std::span<const Aabb> objectBounds,
+                            std::span<const glm::vec3> centroids, uint32_t parent, uint32_t slotInParent) {
+        const auto nodeIndex = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node{.minX = {}, .minY = {}, .minZ = {}, .maxX = {}, .maxY = {}, .maxZ = {},
+                             .children = {EMPTY_SLOT, EMPTY_SLOT, EMPTY_SLOT, EMPTY_SLOT}, .parent = parent,
+                             .slotInParent = slotInParent, .validMask = 0});
+
+        // four or fewer objects go straight into the slots, otherwise two median splits give four groups
+        std::array<std::span<uint32_t>, 4> groups{};
+        if (objects.size() <= 4) {
+            for (size_t i = 0; i < objects.size(); i++) {
+                groups[i] = objects.subspan(i, 1);
+            }
+        } else {
+            const auto middle = splitAtMedian(objects, centroids);
+            const std::span<uint32_t> left{objects.begin(), middle};
+            const std::span<uint32_t> right{middle, objects.end()};
+            const auto leftMiddle = splitAtMedian(left, centroids);
+            const auto rightMiddle = splitAtMedian(right, centroids);
+            groups = {std::span<uint32_t>{left.begin(), leftMiddle}, std::span<uint32_t>{leftMiddle, left.end()},
+                      std::span<uint32_t>{right.begin(), rightMiddle}, std::span<uint32_t>{rightMiddle, right.end()}};
+        }
+
+        for (uint32_t slot = 0; slot < 4; slot++) {
+            const auto group = groups[slot];
+            if (group.empty()) {
+                continue;
+            }
+            Aabb groupBounds = Aabb::empty();
+            for (const uint32_t object: group) {
+                groupBounds.expand(objectBounds[object]);
+            }
+            uint32_t child;
+            if (group.size() == 1) {
+                child = group[0] | OBJECT_BIT;
+                objectSlots[group[0]] = {.node = nodeIndex, .slot = slot};
+            } else {
+                // nodes may reallocate, so only index into it after the recursion
+                child = buildNode(group, objectBounds, centroids, nodeIndex, slot);
+            }
+            Node &node = nodes[nodeIndex];
+            node.children[slot] = child;
+            node.validMask |= 1u << slot;
+            setSlotBounds(node, slot, groupBounds);
+        }
+        return nodeIndex;
+    }
+
+    void Bvh::updateObject(uint32_t object, const Aabb &bounds) {
+        const ObjectSlot objectSlot = objectSlots[object];
+        setSlotBounds(nodes[objectSlot.node], objectSlot.slot, bounds);
+        dirtyNodes[objectSlot.node] = 1;
+        needsRefit = true;
+    }
+
+    void Bvh::refit() {
+        if (!needsRefit) {
+            return;
+        }
+        for (size_t i = nodes.size(); i-- > 0;) {
+            if (!dirtyNodes[i]) {
+                continue;
+            }
+            dirtyNodes[i] = 0;
+            const Node &node = nodes[i];
+            if (node.parent != EMPTY_SLOT) {
+                setSlotBounds(nodes[node.parent], node.slotInParent, getNodeBounds(node));
+                dirtyNodes[node.parent] = 1;
+            }
+        }
+        needsRefit = false;
+    }
+
+    void Bvh::cull(const Frustum &frustum, std::vector<uint32_t> &visibleObjects) const {
+        if (nodes.empty()) {
+            return;
+        }
+        // depth is log4(objects), 64 levels is far more than any scene needs
+        std::array<uint32_t, 64 * 3> stack{};
+        size_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0) {
+            const Node &node = nodes[stack[--stackSize]];
+            uint32_t visibleMask;
+            uint32_t insideMask;
+            classifyChildren(node, frustum, visibleMask, insideMask);
+            for (uint32_t slot = 0; slot < 4; slot++) {
+                if ((visibleMask & (1u << slot)) == 0) {
+                    continue;
+                }
+                const uint32_t child = node.children[slot];
+                if (child & OBJECT_BIT) {
+                    visibleObjects.push_back(child & ~OBJECT_BIT);
+                } else if (insideMask & (1u << slot)) {
+                    appendSubtree(child, visibleObjects);
+                } else {
+                    stack[stackSize++] = child;
+                }
+            }
+        }
+    }
+
+    size_t Bvh::getNodeCount() const {
+        return nodes.size();
+    }
+
+    void Bvh::setSlotBounds(Node &node, uint32_t slot, const Aabb &bounds) {
+        node.minX[slot] = bounds.min.x;
+        node.minY[slot] = bounds.min.y;
+        node.minZ[slot] = bounds.min.z;
+        node.maxX[slot] = bounds.max.x;
+        node.maxY[slot] = bounds.max.y;
+        node.maxZ[slot] = bounds.max.z;
+    }
+
+    Aabb Bvh::getNodeBounds(const Node &node) {
+        Aabb bounds = Aabb::empty();
+        for (uint32_t slot = 0; slot < 4; slot++) {
+            if (node.validMask & (1u << slot)) {
+                bounds.expand(Aabb{.min = {node.minX[slot], node.minY[slot], node.minZ[slot]},
+                                   .max = {node.maxX[slot], node.maxY[slot], node.maxZ[slot]}});
+            }
+        }
+        return bounds;
+    }
+
+    /**
+     * For each plane the corner of a box furthest along the plane normal decides whether the box is outside, and the nearest
+     * corner whether it's completely inside. Which corner that is only depends on the signs of the plane normal, so it's
+     * the same choice of min/max for all four children.
+     */
+    void Bvh::classifyChildren(const Node &node, const Frustum &frustum, uint32_t &visibleMask, uint32_t &insideMask) {
+#ifdef REHNDA_BVH_SSE
+        const __m128 minX = _mm_load_ps(node.minX);
+        const __m128 minY = _mm_load_ps(node.minY);
+        const __m128 minZ = _mm_load_ps(node.minZ);
+        const __m128 maxX = _mm_load_ps(node.maxX);
+        const __m128 maxY = _mm_load_ps(node.maxY);
+        const __m128 maxZ = _mm_load_ps(node.maxZ);
+        const __m128 zero = _mm_setzero_ps();
+
+        __m128 outside = zero;
+        __m128 crossing = zero;
+        for (const auto &plane: frustum.planes) {
+            const __m128 nx = _mm_set1_ps(plane.x);
+            const __m128 ny = _mm_set1_ps(plane.y);
+            const __m128 nz = _mm_set1_ps(plane.z);
+            const __m128 w = _mm_set1_ps(plane.w);
+            const __m128 furthest = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(plane.x >= 0 ? maxX : minX, nx), _mm_mul_ps(plane.y >= 0 ? maxY : minY, ny)),
+                    _mm_add_ps(_mm_mul_ps(plane.z >= 0 ? maxZ : minZ, nz), w));
+            const __m128 nearest = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(plane.x >= 0 ? minX : maxX, nx), _mm_mul_ps(plane.y >= 0 ? minY : maxY, ny)),
+                    _mm_add_ps(_mm_mul_ps(plane.z >= 0 ? minZ : maxZ, nz), w));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(furthest, zero));
+            crossing = _mm_or_ps(crossing, _mm_cmplt_ps(nearest, zero));
+        }
+        const auto outsideMask = static_cast<uint32_t>(_mm_movemask_ps(outside));
+        const auto crossingMask = static_cast<uint32_t>(_mm_movemask_ps(crossing));
+#else
+        uint32_t outsideMask = 0;
+        uint32_t crossingMask = 0;
+        for (uint32_t slot = 0; slot < 4; slot++) {
+            for (const auto &plane: frustum.planes) {
+                const float furthest = plane.x * (plane.x >= 0 ? node.maxX[slot] : node.minX[slot]) +
+                                       plane.y * (plane.y >= 0 ? node.maxY[slot] : node.minY[slot]) +
+                                       plane.z * (plane.z >= 0 ? node.maxZ[slot] : node.minZ[slot]) + plane.w;
+                const float nearest = plane.x * (plane.x >= 0 ? node.minX[slot] : node.maxX[slot]) +
+                                      plane.y * (plane.y >= 0 ? node.minY[slot] : node.maxY[slot]) +
+                                      plane.z * (plane.z >= 0 ? node.minZ[slot] : node.maxZ[slot]) + plane.w;
+                outsideMask |= (furthest < 0 ? 1u : 0u) << slot;
+                crossingMask |= (nearest < 0 ? 1u : 0u) << slot;
+            }
+        }
+#endif
+        visibleMask = ~outsideMask & node.validMask;
+        insideMask = visibleMask & ~crossingMask;
+    }
+
+    void Bvh::appendSubtree(uint32_t node, std::vector<uint32_t> &visibleObjects) const {
+        std::array<uint32_t, 64 * 3> stack{};
+        size_t stackSize = 0;
+        stack[stackSize++] = node;
+        while (stackSize > 0) {
+            const Node &current = nodes[stack[--stackSize]];
+            for (uint32_t slot = 0; slot < 4; slot++) {
+                const uint32_t child = current.children[slot];
+                if (child == EMPTY_SLOT) {
+                    continue;
+                }
+                if (child & OBJECT_BIT) {
+                    visibleObjects.push_back(child & ~OBJECT_BIT);
+                } else {
+                    stack[stackSize++] = child;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "scene/SceneCuller.hpp"
+
+namespace Rehnda {
+    SceneCuller::SceneCuller(const TransformStore &transformStore) : transformStore(transformStore) {}
+
+    void SceneCuller::add(TransformHandle transform, const Aabb &bounds) {
+        if (transform >= transformObjects.size()) {
+            transformObjects.resize(transform + 1, NO_OBJECT);
+        }
+        transformObjects[transform] = static_cast<uint32_t>(objectTransforms.size());
+        objectTransforms.push_back(transform);
+        localBounds.push_back(bounds);
+        worldBounds.push_back(bounds.transformed(transformStore.getWorldMatrix(transform)));
+        // adding is rare (level load, spawning) compared to moving, so just rebuild rather than inserting into the tree
+        needsRebuild = true;
+    }
+
+    void SceneCuller::update() {
+        if (needsRebuild) {
+            for (size_t object = 0; object < objectTransforms.size(); object++) {
+                worldBounds[object] = localBounds[object].transformed(transformStore.getWorldMatrix(objectTransforms[object]));
+            }
+            bvh.build(worldBounds);
+            needsRebuild = false;
+            return;
+        }
+        for (const TransformHandle transform: transformStore.getUpdatedTransforms()) {
+            if (transform >= transformObjects.size() || transformObjects[transform] == NO_OBJECT) {
+                continue;
+            }
+            const uint32_t object = transformObjects[transform];
+            worldBounds[object] = localBounds[object].transformed(transformStore.getWorldMatrix(transform));
+            bvh.updateObject(object, worldBounds[object]);
+        }
+        bvh.refit();
+    }
+
+    std::span<const TransformHandle> SceneCuller::cull(const Frustum &worldFrustum, const HiZPyramid *occluders,
+                                                       JobSystem *jobSystem) {
+        visibleObjects.clear();
+        visibleTransforms.clear();
+        bvh.cull(worldFrustum, visibleObjects);
+        occluded.assign(visibleObjects.size(), 0);
+        if (occluders) {
+            const auto testOcclusion = [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    occluded[i] = occluders->isOccluded(worldBounds[visibleObjects[i]]);
+                }
+            };
+            if (jobSystem && visibleObjects.size() > OCCLUSION_BATCH_SIZE) {
+                jobSystem->parallelFor(visibleObjects.size(), OCCLUSION_BATCH_SIZE, testOcclusion);
+            } else {
+                testOcclusion(0, visibleObjects.size());
+            }
+        }
+        for (size_t i = 0; i < visibleObjects.size(); i++) {
+            if (!occluded[i]) {
+                visibleTransforms.push_back(objectTransforms[visibleObjects[i]]);
+            }
+        }
+        return visibleTransforms;
+    }
+}
@@ -0,0 +1,230 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include "scene/TransformStore.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define REHNDA_TRANSFORM_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Rehnda {
+    namespace {
+        void multiplyMatrices(const glm::mat4 &parent, const glm::mat4 &local, glm::mat4 &out) {
+#ifdef REHNDA_TRANSFORM_SSE
+            const __m128 parentColumn0 = _mm_loadu_ps(&parent[0][0]);
+            const __m128 parentColumn1 = _mm_loadu_ps(&parent[1][0]);
+            const __m128 parentColumn2 = _mm_loadu_ps(&parent[2][0]);
+            const __m128 parentColumn3 = _mm_loadu_ps(&parent[3][0]);
+            for (int column = 0; column < 4; column++) {
+                // each output column is the parent's columns weighted by the local column's components
+                const __m128 result = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(parentColumn0, _mm_set1_ps(local[column][0])),
+                                   _mm_mul_ps(parentColumn1, _mm_set1_ps(local[column][1]))),
+                        _mm_add_ps(_mm_mul_ps(parentColumn2, _mm_set1_ps(local[column][2])),
+                                   _mm_mul_ps(parentColumn3, _mm_set1_ps(local[column][3]))));
+                _mm_storeu_ps(&out[column][0], result);
+            }
+#else
+            out = parent * local;
+#endif
+        }
+    }
+
+    TransformHandle TransformStore::create(const TransformProps &props) {
+        if (props.parent != NO_PARENT && props.parent >= count) {
+            throw std::runtime_error("Transform parent must be created before its children");
+        }
+        if (count % 4 == 0) {
+            // grow by a whole SIMD group of identity transforms
+            for (auto *column: {&positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ}) {
+                column->resize(count + 4, 0.f);
+            }
+            for (auto *column: {&rotationW, &scaleX, &scaleY, &scaleZ}) {
+                column->resize(count + 4, 1.f);
+            }
+            parents.resize(count + 4, NO_PARENT);
+            dirty.resize(count + 4, 0);
+        }
+        const auto handle = static_cast<TransformHandle>(count++);
+        parents[handle] = props.parent;
+        worldMatrices.emplace_back(1.f);
+        setPosition(handle, props.position);
+        setRotation(handle, props.rotation);
+        setScale(handle, props.scale);
+        return handle;
+    }
+
+    void TransformStore::setPosition(TransformHandle handle, glm::vec3 position) {
+        positionX[handle] = position.x;
+        positionY[handle] = position.y;
+        positionZ[handle] = position.z;
+        markDirty(handle);
+    }
+
+    void TransformStore::setRotation(TransformHandle handle, glm::quat rotation) {
+        // the matrix maths assumes unit quaternions
+        rotation = glm::normalize(rotation);
+        rotationX[handle] = rotation.x;
+        rotationY[handle] = rotation.y;
+        rotationZ[handle] = rotation.z;
+        rotationW[handle] = rotation.w;
+        markDirty(handle);
+    }
+
+    void TransformStore::setScale(TransformHandle handle, glm::vec3 scale) {
+        scaleX[handle] = scale.x;
+        scaleY[handle] = scale.y;
+        scaleZ[handle] = scale.z;
+        markDirty(handle);
+    }
+
+    glm::vec3 TransformStore::getPosition(TransformHandle handle) const {
+        return {positionX[handle], positionY[handle], positionZ[handle]};
+    }
+
+    glm::quat TransformStore::getRotation(TransformHandle handle) const {
+        return {rotationW[handle], rotationX[handle], rotationY[handle], rotationZ[handle]};
+    }
+
+    glm::vec3 TransformStore::getScale(TransformHandle handle) const {
+        return {scaleX[handle], scaleY[handle], scaleZ[handle]};
+    }
+
+    TransformHandle TransformStore::getParent(TransformHandle handle) const {
+        return parents[handle];
+    }
+
+    void TransformStore::updateWorldMatrices() {
+        updatedTransforms.clear();
+
+        // parents always come first, so one forward pass carries dirtiness all the way down each subtree
+        for (size_t i = 0; i < count; i++) {
+            if (!dirty[i] && parents[i] != NO_PARENT && dirty[parents[i]]) {
+                dirty[i] = 1;
+            }
+        }
+
+        glm::mat4 localMatrices[4];
+        for (size_t first = 0; first < count; first += 4) {
+            uint32_t groupDirty;
+            std::memcpy(&groupDirty, &dirty[first], sizeof(groupDirty));
+            if (groupDirty == 0) {
+                continue;
+            }
+            computeLocalMatrices(first, localMatrices);
+            for (size_t lane = 0; lane < 4 && first + lane < count; lane++) {
+                const size_t i = first + lane;
+                if (!dirty[i]) {
+                    continue;
+                }
+                // a parent in the same group has a lower lane so it's already been written
+                if (parents[i] == NO_PARENT) {
+                    worldMatrices[i] = localMatrices[lane];
+                } else {
+                    multiplyMatrices(worldMatrices[parents[i]], localMatrices[lane], worldMatrices[i]);
+                }
+                dirty[i] = 0;
+                updatedTransforms.push_back(static_cast<TransformHandle>(i));
+            }
+        }
+    }
+
+    const glm::mat4 &TransformStore::getWorldMatrix(TransformHandle handle) const {
+        return worldMatrices[handle];
+    }
+
+    std::span<const glm::mat4> TransformStore::getWorldMatrices() const {
+        return worldMatrices;
+    }
+
+    std::span<const TransformHandle> TransformStore::getUpdatedTransforms() const {
+        return updatedTransforms;
+    }
+
+    size_t TransformStore::size() const {
+        return count;
+    }
+
+    void TransformStore::markDirty(TransformHandle handle) {
+        dirty[handle] = 1;
+    }
+
+    /**
+     * Builds translation * rotation * scale for four transforms at once. Each register holds the same matrix element for the
+     * four transforms, a 4x4 transpose per column then turns them back into one column per matrix.
+     */
+    void TransformStore::computeLocalMatrices(size_t first, glm::mat4 *localMatrices) const {
+#ifdef REHNDA_TRANSFORM_SSE
+        const __m128 x = _mm_loadu_ps(&rotationX[first]);
+        const __m128 y = _mm_loadu_ps(&rotationY[first]);
+        const __m128 z = _mm_loadu_ps(&rotationZ[first]);
+        const __m128 w = _mm_loadu_ps(&rotationW[first]);
+        const __m128 sx = _mm_loadu_ps(&scaleX[first]);
+        const __m128 sy = _mm_loadu_ps(&scaleY[first]);
+        const __m128 sz = _mm_loadu_ps(&scaleZ[first]);
+        const __m128 one = _mm_set1_ps(1.f);
+
+        const __m128 x2 = _mm_add_ps(x, x);
+        const __m128 y2 = _mm_add_ps(y, y);
+        const __m128 z2 = _mm_add_ps(z, z);
+        const __m128 xx = _mm_mul_ps(x, x2);
+        const __m128 yy = _mm_mul_ps(y, y2);
+        const __m128 zz = _mm_mul_ps(z, z2);
+        const __m128 xy = _mm_mul_ps(x, y2);
+        const __m128 xz = _mm_mul_ps(x, z2);
+        const __m128 yz = _mm_mul_ps(y, z2);
+        const __m128 wx = _mm_mul_ps(w, x2);
+        const __m128 wy = _mm_mul_ps(w, y2);
+        const __m128 wz = _mm_mul_ps(w, z2);
+
+        // elements named rowColumn, each column of the rotation is scaled by that axis' scale
+        __m128 columns[4][4] = {
+                {
+                        _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx),
+                        _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+                        _mm_mul_ps(_mm_sub_ps(xz, wy), sx),
+                        _mm_setzero_ps(),
+                },
+                {
+                        _mm_mul_ps(_mm_sub_ps(xy, wz), sy),
+                        _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+                        _mm_mul_ps(_mm_add_ps(yz, wx), sy),
+                        _mm_setzero_ps(),
+                },
+                {
+                        _mm_mul_ps(_mm_add_ps(xz, wy), sz),
+                        _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+                        _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz),
+                        _mm_setzero_ps(),
+                },
+                {
+                        _mm_loadu_ps(&positionX[first]),
+                        _mm_loadu_ps(&positionY[first]),
+                        _mm_loadu_ps(&positionZ[first]),
+                        one,
+                },
+        };
+        for (int column = 0; column < 4; column++) {
+            auto &elements = columns[column];
+            _MM_TRANSPOSE4_PS(elements[0], elements[1], elements[2], elements[3]);
+            for (int lane = 0; lane < 4; lane++) {
+                _mm_storeu_ps(&localMatrices[lane][column][0], elements[lane]);
+            }
+        }
+#else
+        for (size_t lane = 0; lane < 4; lane++) {
+            const auto handle = static_cast<TransformHandle>(first + lane);
+            localMatrices[lane] = glm::translate(glm::mat4(1.f), getPosition(handle)) *
+                                  glm::mat4_cast(getRotation(handle)) *
+                                  glm::scale(glm::mat4(1.f), getScale(handle));
+        }
+#endif
+    }
+}
@@ -9,14 +9,22 @@
 #include "Windowing/Window.hpp"
 
 namespace Rehnda::Windowing {
-    Window::Window(Pixels width, Pixels height) : width(width), height(height) {
+    Window::Window(Pixels width, Pixels height, JobSystem &jobSystem) : width(width), height(height) {
         glfwInit();
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
         glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
         window = glfwCreateWindow(width.get(), height.get(), "Rehnda", nullptr, nullptr);
-        vulkanRenderer = std::make_unique<VulkanRenderer>(window);
-        glfwSetFramebufferSizeCallback(window, [](GLFWwindow* w, int, int) {
-            reinterpret_cast<Window*>(glfwGetWindowUserPointer(w))->resize();
+        int initialWidth = 0;
+        int initialHeight = 0;
+        glfwGetFramebufferSize(window, &initialWidth, &initialHeight);
+        framebufferWidth = static_cast<uint32_t>(initialWidth);
+        framebufferHeight = static_cast<uint32_t>(initialHeight);
+        vulkanRenderer = std::make_unique<VulkanRenderer>(window, jobSystem);
+        glfwSetFramebufferSizeCallback(window, [](GLFWwindow* w, int framebufferWidth, int framebufferHeight) {
+            reinterpret_cast<Window*>(glfwGetWindowUserPointer(w))->resize(framebufferWidth, framebufferHeight);
+        });
+        glfwSetKeyCallback(window, [](GLFWwindow* w, int key, int, int action, int) {
+            reinterpret_cast<Window*>(glfwGetWindowUserPointer(w))->onKey(key, action);
         });
         glfwSetWindowUserPointer(window, this);
     }
@@ -50,28 +58,33 @@ namespace Rehnda::Windowing {
         return vulkanRenderer.get();
     }
 
-    void Window::render() {
+    void Window::render(const RenderCommandStream &commands) {
         if (isWindowMinimized()) {
             return;
         }
-        vulkanRenderer->drawFrame();
+        vulkanRenderer->drawFrame(commands);
     }
 
     void Window::waitIdle() {
         vulkanRenderer->waitForDeviceIdle();
     }
 
-    void Window::resize() {
-        vulkanRenderer->resize();
+    void Window::resize(int newFramebufferWidth, int newFramebufferHeight) {
+        const vk::Extent2D framebufferExtent{static_cast<uint32_t>(newFramebufferWidth), static_cast<uint32_t>(newFramebufferHeight)};
+        framebufferWidth = framebufferExtent.width;
+        framebufferHeight = framebufferExtent.height;
+        vulkanRenderer->resize(framebufferExtent);
     }
 
-    bool Window::isWindowMinimized() const {
-        int width = 0, height = 0;
-        glfwGetFramebufferSize(window, &width, &height);
-        if (width == 0 || height == 0) {
-            // Don't render while the window is minimized
-            return true;
+    void Window::onKey(int key, int action) {
+        // P flips the depth pre-pass so its cost can be compared against overdraw in the logged GPU timings
+        if (key == GLFW_KEY_P && action == GLFW_PRESS) {
+            vulkanRenderer->setDepthPrePass(!vulkanRenderer->isDepthPrePassEnabled());
         }
-        return false;
+    }
+
+    bool Window::isWindowMinimized() const {
+        // Don't render while the window is minimized
+        return framebufferWidth == 0 || framebufferHeight == 0;
     }
 }
\ No newline at end of file
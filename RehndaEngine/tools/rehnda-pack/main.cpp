@@ -0,0 +1,59 @@
+//
+// Created by sjbar on 19/10/2026.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+#include "assets/AssetPackWriter.hpp"
+
+using namespace Rehnda;
+
+static void printUsage() {
+    std::cerr << "usage: rehnda-pack -o <output.rpak> [-c none|lz4|zstd] <directory>..." << std::endl;
+}
+
+int main(int argc, char **argv) {
+    std::filesystem::path outputPath;
+    AssetPackWriterProps props{};
+    std::vector<std::filesystem::path> directories;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (arg == "-c" && i + 1 < argc) {
+            const std::string_view compression = argv[++i];
+            if (compression == "none") {
+                props.compression = AssetPackFormat::Compression::NONE;
+            } else if (compression == "lz4") {
+                props.compression = AssetPackFormat::Compression::LZ4;
+            } else if (compression == "zstd") {
+                props.compression = AssetPackFormat::Compression::ZSTD;
+            } else {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+        } else {
+            directories.emplace_back(arg);
+        }
+    }
+
+    if (outputPath.empty() || directories.empty()) {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    try {
+        AssetPackWriter writer{props};
+        for (const auto &directory: directories) {
+            writer.addDirectory(directory);
+        }
+        writer.write(outputPath);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}